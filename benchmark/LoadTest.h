@@ -0,0 +1,73 @@
+#ifndef COMPUTERCLUB_LOADTEST_H
+#define COMPUTERCLUB_LOADTEST_H
+
+#include "ClubClient.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LoadTestResult {
+    std::vector<double> latenciesUs;
+    double elapsedSeconds{};
+    size_t failedRequests{};
+};
+
+// numberOfClients connections in flight at any moment, each sending requestsPerClient CONTENT requests in a row
+inline LoadTestResult RunLoadTest(const std::string& socketPath, const std::string& content, size_t numberOfClients,
+                                  size_t requestsPerClient)
+{
+    std::vector<std::vector<double>> clientLatencies(numberOfClients);
+    std::vector<size_t> clientFailures(numberOfClients);
+    std::vector<std::thread> clients;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t client = 0; client < numberOfClients; client++) {
+        clients.emplace_back([&, client]() {
+            std::string report;
+            for (size_t request = 0; request < requestsPerClient; request++) {
+                auto requestStart = std::chrono::steady_clock::now();
+                try {
+                    ClubClient::RunContent(socketPath, content, report);
+                } catch (const std::exception&) {
+                    clientFailures[client]++;
+                    continue;
+                }
+
+                clientLatencies[client].push_back(std::chrono::duration<double, std::micro>(
+                                                  std::chrono::steady_clock::now() - requestStart).count());
+            }
+        });
+    }
+    for (auto& client : clients)
+        client.join();
+
+    LoadTestResult result;
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (size_t client = 0; client < numberOfClients; client++) {
+        result.latenciesUs.insert(result.latenciesUs.end(), clientLatencies[client].cbegin(),
+                                  clientLatencies[client].cend());
+        result.failedRequests += clientFailures[client];
+    }
+    std::sort(result.latenciesUs.begin(), result.latenciesUs.end());
+
+    return result;
+}
+
+inline void PrintLoadTestResult(const std::string& name, const LoadTestResult& result) {
+    auto percentile = [&result](double fraction) {
+        return result.latenciesUs.empty() ? 0.0 :
+               result.latenciesUs[static_cast<size_t>(fraction * static_cast<double>(result.latenciesUs.size() - 1))];
+    };
+
+    std::cout << name << ": " << result.latenciesUs.size() << " requests, "
+              << static_cast<double>(result.latenciesUs.size()) / result.elapsedSeconds << " req/s, p50 "
+              << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, max " << percentile(1.0) << " us";
+    if (result.failedRequests != 0)
+        std::cout << ", " << result.failedRequests << " failed";
+    std::cout << std::endl;
+}
+
+#endif //COMPUTERCLUB_LOADTEST_H
@@ -0,0 +1,784 @@
+#include "FileParser.h"
+#include "TextParsing.h"
+#include "EventHandler.h"
+#include "TaskSolver.h"
+#include "LineReader.h"
+#include "DecompressingBlockReader.h"
+#include "ClubScheduler.h"
+#include "ResultCache.h"
+#include "PhaseProfile.h"
+#include "LiveSnapshot.h"
+#include "LedgerSinks.h"
+#include "TimeIndex.h"
+#include "Constants.h"
+#include "RecordFormat.h"
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+#include "ClubServer.h"
+#include "LoadTest.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+#include <zstd.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+struct GeneratedLog {
+    fs::path path;
+    size_t numberOfEvents{};
+};
+
+// Writes a syntactically correct working day in which every incoming event ID and most of the errors occur
+GeneratedLog GenerateLog(const std::string& name, size_t numberOfTables, size_t numberOfClients,
+                         size_t numberOfEvents, uint32_t seed = 42)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<size_t> clientDistribution(1, numberOfClients);
+    std::uniform_int_distribution<size_t> tableDistribution(1, numberOfTables);
+    std::uniform_int_distribution<int> idDistribution(1, 6);
+
+    GeneratedLog log{ fs::temp_directory_path() / (name + ".txt"), numberOfEvents };
+    std::ofstream file(log.path);
+    file << numberOfTables << "\n08:00 23:59\n10\n";
+
+    for (size_t i = 0; i < numberOfEvents; i++) {
+        Time eventTime{ static_cast<uint16_t>(7 + i * 16 / numberOfEvents),
+                        static_cast<uint16_t>(i * 16 * MINUTES_IN_HOUR / numberOfEvents % MINUTES_IN_HOUR) };
+        int id = idDistribution(generator);
+
+        file << eventTime.toString() << ' ';
+        switch (id) {
+            case 1: case 2:
+                file << "1 client" << clientDistribution(generator) << '\n';
+                break;
+            case 3: case 4:
+                file << "2 client" << clientDistribution(generator) << ' ' << tableDistribution(generator) << '\n';
+                break;
+            case 5:
+                file << "3 client" << clientDistribution(generator) << '\n';
+                break;
+            default:
+                file << "4 client" << clientDistribution(generator) << '\n';
+                break;
+        }
+    }
+
+    return log;
+}
+
+// A long archive of short visits: the club gets empty every few dozen events
+GeneratedLog GenerateVisitsLog(const std::string& name, size_t numberOfTables, size_t numberOfVisits) {
+    GeneratedLog log{ fs::temp_directory_path() / (name + ".txt"), 0 };
+    std::ofstream file(log.path);
+    file << numberOfTables << "\n00:00 23:59\n10\n";
+
+    for (size_t visit = 0; visit < numberOfVisits; visit++) {
+        std::string time = Time::fromMinutes(static_cast<uint32_t>(visit * 24 * MINUTES_IN_HOUR / numberOfVisits))
+                           .toString();
+
+        for (size_t table = 1; table <= numberOfTables; table++) {
+            file << time << " 1 client" << table << '\n' << time << " 2 client" << table << ' ' << table << '\n';
+            file << time << " 3 client" << table << '\n';
+        }
+        for (size_t table = 1; table <= numberOfTables; table++)
+            file << time << " 4 client" << table << '\n';
+
+        log.numberOfEvents += 4 * numberOfTables;
+    }
+
+    return log;
+}
+
+void Measure(const std::string& name, size_t iterations, size_t itemsPerIteration, const std::function<void()>& body) {
+    body();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        body();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": " << elapsed * 1e3 / static_cast<double>(iterations) << " ms/iteration, "
+              << static_cast<double>(iterations * itemsPerIteration) / elapsed / 1e6 << " M items/s" << std::endl;
+}
+
+void BenchmarkEventDispatch() {
+    constexpr size_t ITERATIONS = 10;
+    auto log = GenerateLog("dispatch_benchmark", 64, 512, 100000);
+
+    InputFileData inputFileData;
+    Error error;
+    FileParser::Parse(log.path.string(), inputFileData, error);
+
+    // The handler consumes its input, so the copies are prepared outside the measured loop
+    std::vector<InputFileData> inputs(ITERATIONS + 1, inputFileData);
+    size_t next = 0;
+
+    Measure("EventDispatch", ITERATIONS, log.numberOfEvents, [&inputs, &next]() {
+        Error handlerError;
+        std::string output;
+        Tables tables;
+
+        EventHandler eventHandler(std::move(inputs[next++]));
+        eventHandler.HandleEventsOfTheDay(output, handlerError, tables);
+    });
+
+    fs::remove(log.path);
+}
+
+// Many seats that are mostly still occupied at closing time, so settlement and the per-table report dominate
+void BenchmarkManyTables() {
+    auto log = GenerateLog("many_tables_benchmark", 50000, 50000, 100000);
+
+    size_t reportSize = 0;
+    Measure("ManyTables", 10, log.numberOfEvents, [&log, &reportSize]() {
+        std::ostringstream nullStream;
+        auto* coutBuffer = std::cout.rdbuf(nullStream.rdbuf());
+
+        TaskSolver taskSolver;
+        taskSolver.run(log.path.string());
+        reportSize = taskSolver.getOutputResult().size();
+
+        std::cout.rdbuf(coutBuffer);
+    });
+
+    std::cout << "ManyTables: report size " << reportSize << " bytes" << std::endl;
+
+    fs::remove(log.path);
+}
+
+void BenchmarkFileReading() {
+    auto log = GenerateLog("file_reading_benchmark", 64, 512, 2000000);
+    size_t fileSize = fs::file_size(log.path);
+
+    auto measureBackend = [&log, fileSize](const std::string& name, BlockReader::Backend backend) {
+        if (!BlockReader::Open(log.path.string(), backend)) {
+            std::cout << name << ": unavailable" << std::endl;
+            return;
+        }
+
+        Measure(name, 10, fileSize, [&log, backend]() {
+            LineReader lineReader(BlockReader::Open(log.path.string(), backend));
+            std::string line;
+            while (lineReader.GetLine(line)) { }
+        });
+    };
+
+    Measure("FileReading/ifstream", 10, fileSize, [&log]() {
+        std::ifstream file(log.path);
+        std::string line;
+        while (std::getline(file, line)) { }
+    });
+    measureBackend("FileReading/io_uring", BlockReader::Backend::IoUring);
+    measureBackend("FileReading/thread", BlockReader::Backend::Thread);
+
+    fs::remove(log.path);
+}
+
+void BenchmarkManyClubs() {
+    constexpr size_t NUMBER_OF_CLUBS = 5000;
+    constexpr size_t NUMBER_OF_THREADS = 4;
+    auto log = GenerateLog("many_clubs_benchmark", 8, 64, 200);
+
+    InputFileData inputFileData;
+    Error error;
+    FileParser::Parse(log.path.string(), inputFileData, error);
+
+    // Every iteration frees all its frames, so the peak of all of them is the peak of one
+    ClubTask::FrameCounter frameCounter;
+    ClubTask::promise_type::frameCounter = &frameCounter;
+    Measure("ManyClubs", 10, NUMBER_OF_CLUBS * log.numberOfEvents, [&inputFileData]() {
+        ClubScheduler clubScheduler(NUMBER_OF_THREADS);
+        for (size_t club = 0; club < NUMBER_OF_CLUBS; club++)
+            clubScheduler.AddClub(inputFileData);
+
+        clubScheduler.Run();
+    });
+    ClubTask::promise_type::frameCounter = nullptr;
+
+    std::cout << "ManyClubs: " << NUMBER_OF_CLUBS << " clubs on " << NUMBER_OF_THREADS << " threads, "
+              << frameCounter.peakBytes / NUMBER_OF_CLUBS << " bytes of coroutine frame per club" << std::endl;
+
+    fs::remove(log.path);
+}
+
+// The routines FileParser used before TextParsing.h, kept here as the reference point
+namespace Legacy {
+
+bool ParsePositiveNumber(const std::string& data, size_t& number) {
+    if (!data.empty() && data.at(0) >= '1' && data.at(0) <= '9' &&
+        std::all_of(data.cbegin() + 1, data.cend(), [](char symbol) { return symbol >= '0' && symbol <= '9'; }))
+    {
+        number = std::stoi(data);
+        return true;
+    }
+
+    return false;
+}
+
+bool ParseTime(const std::string& data, Time& time) {
+    size_t pos = data.find(':');
+    if (pos == std::string::npos)
+        return false;
+
+    std::string hours = data.substr(0, pos);
+    std::string minutes = data.substr(pos + 1);
+    if (hours.length() != 2 || minutes.length() != 2 ||
+        !((hours[0] == '0' || hours[0] == '1') ? std::isdigit(hours[1]) : hours[0] == '2' && hours[1] <= '3') ||
+        !(minutes[0] >= '0' && minutes[0] <= '5' && std::isdigit(minutes[1])))
+    {
+        return false;
+    }
+
+    time = { static_cast<uint16_t>(std::stoi(hours)), static_cast<uint16_t>(std::stoi(minutes)) };
+    return true;
+}
+
+}
+
+void BenchmarkTextParsing() {
+    constexpr size_t COUNT = 1000000;
+    std::mt19937 generator(42);
+
+    std::vector<std::string> numbers, times;
+    for (size_t i = 0; i < COUNT; i++) {
+        numbers.push_back(std::to_string(generator() % 100000 + 1));
+        times.push_back(Time::fromMinutes(generator() % (24 * MINUTES_IN_HOUR)).toString());
+    }
+
+    size_t checksum = 0;
+    Measure("TextParsing/number/stoi", 10, COUNT, [&numbers, &checksum]() {
+        size_t number = 0;
+        for (const auto& data : numbers)
+            checksum += Legacy::ParsePositiveNumber(data, number) ? number : 0;
+    });
+    Measure("TextParsing/number/from_chars", 10, COUNT, [&numbers, &checksum]() {
+        size_t number = 0;
+        for (const auto& data : numbers)
+            checksum += parsePositiveNumber(data, number) ? number : 0;
+    });
+    Measure("TextParsing/time/stoi", 10, COUNT, [&times, &checksum]() {
+        Time time;
+        for (const auto& data : times)
+            checksum += Legacy::ParseTime(data, time) ? time.minutes : 0;
+    });
+    Measure("TextParsing/time/swar", 10, COUNT, [&times, &checksum]() {
+        Time time;
+        for (const auto& data : times)
+            checksum += parseTime(data, time) ? time.minutes : 0;
+    });
+
+    std::cout << "TextParsing: checksum " << checksum << std::endl;
+}
+
+void BenchmarkSegmentParallel() {
+    constexpr size_t ITERATIONS = 5;
+    auto log = GenerateVisitsLog("segment_parallel_benchmark", 8, 40000);
+
+    InputFileData inputFileData;
+    Error error;
+    FileParser::Parse(log.path.string(), inputFileData, error);
+
+    for (size_t numberOfThreads : { 1, 2, 4, 8 }) {
+        std::vector<InputFileData> inputs(ITERATIONS + 1, inputFileData);
+        size_t next = 0;
+
+        Measure("SegmentParallel/" + std::to_string(numberOfThreads), ITERATIONS, log.numberOfEvents,
+                [&inputs, &next, numberOfThreads]() {
+            Error handlerError;
+            std::string output;
+            Tables tables;
+
+            EventHandler eventHandler(std::move(inputs[next++]));
+            eventHandler.HandleEventsOfTheDayInParallel(output, handlerError, tables, numberOfThreads);
+        });
+    }
+
+    fs::remove(log.path);
+}
+
+// A huge declared number of tables of which only a handful are ever seated
+void BenchmarkSparseTables() {
+    constexpr size_t NUMBER_OF_TABLES = 10000000;
+    auto log = GenerateLog("sparse_tables_benchmark", NUMBER_OF_TABLES, 64, 2000);
+
+    Measure("SparseTables", 5, NUMBER_OF_TABLES, [&log]() {
+        std::ostream nullStream(nullptr);
+
+        TaskSolver taskSolver;
+        taskSolver.run(log.path.string(), nullStream);
+    });
+
+    fs::remove(log.path);
+}
+
+// A reconciliation rerun over a set of logs that haven't changed since the previous one
+void BenchmarkResultCache() {
+    constexpr size_t NUMBER_OF_LOGS = 100;
+    auto cachePath = fs::temp_directory_path() / "result_cache_benchmark";
+    fs::remove_all(cachePath);
+
+    std::vector<GeneratedLog> logs;
+    for (size_t log = 0; log < NUMBER_OF_LOGS; log++)
+        logs.push_back(GenerateLog("result_cache_benchmark_" + std::to_string(log), 20, 200, 5000,
+                                   static_cast<uint32_t>(log)));
+
+    auto runAll = [&logs](ResultCache* resultCache) {
+        std::ostream nullStream(nullptr);
+        TaskSolver taskSolver(nullptr, {}, resultCache);
+
+        for (const auto& log : logs)
+            taskSolver.run(log.path.string(), nullStream);
+    };
+
+    size_t coldRun = 0;
+    Measure("ResultCache/off", 5, NUMBER_OF_LOGS, [&runAll]() { runAll(nullptr); });
+    Measure("ResultCache/cold", 5, NUMBER_OF_LOGS, [&runAll, &cachePath, &coldRun]() {
+        ResultCache resultCache(cachePath / std::to_string(coldRun++), uintmax_t{1} << 30);
+        runAll(&resultCache);
+    });
+
+    ResultCache resultCache(cachePath / "warm", uintmax_t{1} << 30);
+    Measure("ResultCache/warm", 5, NUMBER_OF_LOGS, [&runAll, &resultCache]() { runAll(&resultCache); });
+    std::cout << "ResultCache/warm: " << resultCache.statsLine() << std::endl;
+
+    for (const auto& log : logs)
+        fs::remove(log.path);
+    fs::remove_all(cachePath);
+}
+
+// Hardware counters per phase and per event for the log of EventDispatch, as JSON
+void BenchmarkPerfPhases() {
+    constexpr size_t ITERATIONS = 10;
+    auto log = GenerateLog("perf_phases_benchmark", 64, 512, 100000);
+
+    PhaseProfile phaseProfile;
+    TaskSolver taskSolver(nullptr, {}, nullptr, &phaseProfile);
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        std::ostringstream report;
+        taskSolver.run(log.path.string(), report);
+    }
+
+    std::cout << "PerfPhases: " << phaseProfile.ToJson();
+
+    fs::remove(log.path);
+}
+
+// An "as of" query against handling the whole day, for a short and a hundred times longer day
+void BenchmarkAsOfQuery() {
+    for (size_t numberOfEvents : { 10000, 1000000 }) {
+        auto log = GenerateLog("as_of_query_benchmark", 64, 512, numberOfEvents);
+        std::string suffix = "/" + std::to_string(numberOfEvents);
+        std::ostream nullStream(nullptr);
+        TaskSolver taskSolver;
+
+        Measure("AsOfQuery/full_day" + suffix, 5, 1, [&taskSolver, &log, &nullStream]() {
+            taskSolver.run(log.path.string(), nullStream);
+        });
+        // A fresh index each time: on ext4 replacing an index also waits for the new one to be written out
+        Measure("AsOfQuery/build_index" + suffix, 5, 1, [&taskSolver, &log, &nullStream]() {
+            fs::remove(TimeIndex::IndexFileName(log.path.string()));
+            taskSolver.buildTimeIndex(log.path.string(), TimeIndex::DEFAULT_CHECKPOINT_INTERVAL, nullStream);
+        });
+        Measure("AsOfQuery/query" + suffix, 1000, 1, [&taskSolver, &log, &nullStream]() {
+            taskSolver.runAsOf(log.path.string(), { 15, 0 }, nullStream);
+        });
+
+        fs::remove(log.path);
+        fs::remove(TimeIndex::IndexFileName(log.path.string()));
+    }
+}
+
+// The log of EventDispatch without publishing, publishing a live snapshot after every event, and publishing while
+// dashboard readers copy the snapshot every 10 microseconds
+void BenchmarkLiveSnapshot() {
+    constexpr size_t ITERATIONS = 10;
+    auto log = GenerateLog("live_snapshot_benchmark", 64, 512, 100000);
+
+    InputFileData inputFileData;
+    Error error;
+    FileParser::Parse(log.path.string(), inputFileData, error);
+    LiveSnapshot liveSnapshot(inputFileData.computerClubFeatures.numberOfTables);
+
+    auto handleDays = [&inputFileData, &liveSnapshot](const std::string& name, bool isPublished) {
+        std::vector<InputFileData> inputs(ITERATIONS + 1, inputFileData);
+        size_t next = 0;
+
+        Measure(name, ITERATIONS, inputFileData.computerClubEvents.size(), [&]() {
+            Error handlerError;
+            std::string output;
+            Tables tables;
+
+            EventHandler eventHandler(std::move(inputs[next++]));
+            eventHandler.PublishTo(isPublished ? &liveSnapshot : nullptr);
+            eventHandler.HandleEventsOfTheDay(output, handlerError, tables);
+        });
+    };
+
+    handleDays("LiveSnapshot/off", false);
+    handleDays("LiveSnapshot/readers=0", true);
+
+    for (size_t numberOfReaders : { 1, 4 }) {
+        std::atomic<bool> isDone = false;
+        std::atomic<size_t> numberOfReads = 0, numberOfRetries = 0;
+        std::vector<std::thread> readers;
+
+        for (size_t reader = 0; reader < numberOfReaders; reader++) {
+            readers.emplace_back([&]() {
+                LiveSnapshot::Snapshot snapshot;
+                while (!isDone.load(std::memory_order_relaxed)) {
+                    numberOfRetries += liveSnapshot.Read(snapshot);
+                    numberOfReads++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                }
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        handleDays("LiveSnapshot/readers=" + std::to_string(numberOfReaders), true);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        isDone = true;
+        for (auto& reader : readers)
+            reader.join();
+
+        std::cout << "LiveSnapshot/readers=" << numberOfReaders << ": "
+                  << static_cast<double>(numberOfReads) / elapsed / 1e3 << " K reads/s, "
+                  << numberOfRetries << " retries" << std::endl;
+    }
+
+    fs::remove(log.path);
+}
+
+// Four terminal logs of one day: sorted into one log in memory and run, against merged as they are read
+void BenchmarkLogMerge() {
+    constexpr size_t NUMBER_OF_TERMINALS = 4;
+    constexpr size_t EVENTS_PER_TERMINAL = 250000;
+
+    std::vector<std::string> fileNames;
+    for (size_t terminal = 0; terminal < NUMBER_OF_TERMINALS; terminal++) {
+        fileNames.push_back(GenerateLog("log_merge_benchmark_" + std::to_string(terminal), 64, 512,
+                                        EVENTS_PER_TERMINAL, static_cast<uint32_t>(terminal)).path.string());
+    }
+    auto sortedPath = fs::temp_directory_path() / "log_merge_benchmark_sorted.txt";
+
+    std::ostream nullStream(nullptr);
+    TaskSolver taskSolver;
+
+    Measure("LogMerge/sort_then_run", 3, NUMBER_OF_TERMINALS * EVENTS_PER_TERMINAL, [&]() {
+        std::vector<std::string> header, lines;
+
+        for (const auto& fileName : fileNames) {
+            std::ifstream file(fileName);
+            std::string line;
+            for (size_t lineNumber = 0; lineNumber < 3 && std::getline(file, line); lineNumber++)
+                header.push_back(line);
+            while (std::getline(file, line))
+                lines.push_back(std::move(line));
+        }
+
+        // By the time at the start of the line, as sort -s -k1,1 would
+        std::ranges::stable_sort(lines, [](const std::string& first, const std::string& second) {
+            return first.compare(0, 5, second, 0, 5) < 0;
+        });
+
+        {
+            std::ofstream file(sortedPath);
+            for (size_t lineNumber = 0; lineNumber < 3; lineNumber++)
+                file << header[lineNumber] << '\n';
+            for (const auto& line : lines)
+                file << line << '\n';
+        }
+
+        taskSolver.run(sortedPath.string(), nullStream);
+    });
+
+    Measure("LogMerge/merged", 3, NUMBER_OF_TERMINALS * EVENTS_PER_TERMINAL, [&]() {
+        taskSolver.runMerged(fileNames, nullStream);
+    });
+
+    for (const auto& fileName : fileNames)
+        fs::remove(fileName);
+    fs::remove(sortedPath);
+}
+
+// A day of 1000000 events handled strictly, through a 5-minute reorder window, and through the window with every
+// tenth event swapped with the next one, i.e. up to a minute out of order
+void BenchmarkReorderWindow() {
+    constexpr size_t NUMBER_OF_EVENTS = 1000000;
+    auto log = GenerateLog("reorder_window_benchmark", 64, 512, NUMBER_OF_EVENTS);
+    auto skewedPath = fs::temp_directory_path() / "reorder_window_benchmark_skewed.txt";
+    {
+        std::ifstream file(log.path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(file, line); )
+            lines.push_back(std::move(line));
+
+        for (size_t lineNumber = 3; lineNumber + 1 < lines.size(); lineNumber += 10)
+            std::swap(lines[lineNumber], lines[lineNumber + 1]);
+
+        std::ofstream skewedFile(skewedPath);
+        for (const auto& line : lines)
+            skewedFile << line << '\n';
+    }
+
+    std::ostream nullStream(nullptr);
+    RunOptions runOptions;
+    runOptions.reorderWindowMinutes = 5;
+    TaskSolver strictTaskSolver, reorderingTaskSolver(nullptr, runOptions);
+
+    Measure("ReorderWindow/strict", 5, NUMBER_OF_EVENTS, [&]() {
+        strictTaskSolver.run(log.path.string(), nullStream);
+    });
+    Measure("ReorderWindow/window=5/sorted", 5, NUMBER_OF_EVENTS, [&]() {
+        reorderingTaskSolver.run(log.path.string(), nullStream);
+    });
+    Measure("ReorderWindow/window=5/skewed", 5, NUMBER_OF_EVENTS, [&]() {
+        reorderingTaskSolver.run(skewedPath.string(), nullStream);
+    });
+
+    fs::remove(log.path);
+    fs::remove(skewedPath);
+}
+
+// A day of 1000000 events reported as text, JSON Lines and CSV, and the serializer alone turning a text report, as
+// the result cache keeps it, into records chunk by chunk in one reused buffer
+void BenchmarkStructuredOutput() {
+    constexpr size_t NUMBER_OF_EVENTS = 1000000;
+    auto log = GenerateLog("structured_output_benchmark", 64, 512, NUMBER_OF_EVENTS);
+    std::ostream nullStream(nullptr);
+
+    for (auto [name, format] : { std::pair{ "text", OutputFormat::Text }, { "jsonl", OutputFormat::JsonLines },
+                                 { "csv", OutputFormat::Csv } })
+    {
+        RunOptions runOptions;
+        runOptions.outputFormat = format;
+        TaskSolver taskSolver(nullptr, runOptions);
+
+        Measure(std::string("StructuredOutput/run/") + name, 5, NUMBER_OF_EVENTS, [&]() {
+            taskSolver.run(log.path.string(), nullStream);
+        });
+    }
+
+    TaskSolver taskSolver;
+    taskSolver.run(log.path.string(), nullStream);
+    std::string report = taskSolver.getOutputResult();
+    size_t numberOfLines = std::ranges::count(report, '\n');
+
+    std::string chunk;
+    chunk.reserve(TaskSolver::REPORT_CHUNK_BYTES + 256);
+
+    for (auto [name, format] : { std::pair{ "jsonl", OutputFormat::JsonLines }, { "csv", OutputFormat::Csv } }) {
+        Measure(std::string("StructuredOutput/serialize/") + name, 10, numberOfLines, [&, format]() {
+            bool isOpened = false;
+            for (size_t offset = 0; offset < report.size(); chunk.clear()) {
+                offset = RecordFormat::appendReportRecords(chunk, format, report, offset,
+                                                           TaskSolver::REPORT_CHUNK_BYTES, isOpened);
+            }
+        });
+    }
+
+    fs::remove(log.path);
+}
+
+// A day of 2000000 events read line by line and handled from the plain log and from its gzip and zstd copies,
+// against decompressing a copy to a temporary file first and handling that
+void BenchmarkCompressedInput() {
+    constexpr size_t NUMBER_OF_EVENTS = 2000000;
+    auto log = GenerateLog("compressed_input_benchmark", 64, 512, NUMBER_OF_EVENTS);
+    size_t fileSize = fs::file_size(log.path);
+
+    std::string content;
+    {
+        std::ifstream file(log.path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::vector<std::pair<std::string, fs::path>> copies = { { "plain", log.path } };
+#ifdef COMPUTERCLUB_HAS_ZLIB
+    {
+        auto path = fs::path(log.path).concat(".gz");
+        gzFile file = gzopen(path.c_str(), "wb6");
+        gzwrite(file, content.data(), static_cast<unsigned>(content.size()));
+        gzclose(file);
+        copies.emplace_back("gzip", path);
+    }
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+    {
+        auto path = fs::path(log.path).concat(".zst");
+        std::string compressed(ZSTD_compressBound(content.size()), '\0');
+        compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), content.data(), content.size(), 3));
+        std::ofstream(path, std::ios::binary) << compressed;
+        copies.emplace_back("zstd", path);
+    }
+#endif
+
+    auto open = [](const fs::path& path) {
+        return DecompressingBlockReader::Open(path.string(), DecompressingBlockReader::CompressionOf(path.string()));
+    };
+
+    for (const auto& [name, path] : copies) {
+        std::cout << "CompressedInput/" << name << ": " << fs::file_size(path) << " bytes" << std::endl;
+
+        Measure("CompressedInput/read/" + name, 10, fileSize, [&open, &path]() {
+            LineReader lineReader(open(path));
+            std::string line;
+            while (lineReader.GetLine(line)) { }
+        });
+    }
+
+    std::ostream nullStream(nullptr);
+    TaskSolver taskSolver;
+
+    for (const auto& [name, path] : copies) {
+        Measure("CompressedInput/run/" + name, 5, NUMBER_OF_EVENTS, [&taskSolver, &path, &nullStream]() {
+            taskSolver.run(path.string(), nullStream);
+        });
+    }
+
+    auto decompressedPath = fs::temp_directory_path() / "compressed_input_benchmark_decompressed.txt";
+    for (size_t copy = 1; copy < copies.size(); copy++) {
+        const auto& [name, path] = copies[copy];
+
+        Measure("CompressedInput/decompress_then_run/" + name, 5, NUMBER_OF_EVENTS, [&]() {
+            {
+                auto blockReader = open(path);
+                std::ofstream file(decompressedPath, std::ios::binary);
+                for (auto block = blockReader->NextBlock(); !block.empty(); block = blockReader->NextBlock())
+                    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+            }
+            taskSolver.run(decompressedPath.string(), nullStream);
+        });
+    }
+
+    for (const auto& copy : copies)
+        fs::remove(copy.second);
+    fs::remove(decompressedPath);
+}
+
+// The report of the task against the per-table summary, the generated events and the totals alone, which
+// neither format nor keep the rest of the report
+void BenchmarkReportSections() {
+    constexpr size_t NUMBER_OF_EVENTS = 2000000;
+    auto log = GenerateLog("report_sections_benchmark", 64, 512, NUMBER_OF_EVENTS);
+    std::ostream nullStream(nullptr);
+
+    for (auto [name, sections] : { std::pair{ "full", ReportSections{} },
+                                   { "events", ReportSections{ false, true, false, false } },
+                                   { "tables", ReportSections{ false, false, true, false } },
+                                   { "totals", ReportSections{ false, false, false, true } } })
+    {
+        RunOptions runOptions;
+        runOptions.reportSections = sections;
+        TaskSolver taskSolver(nullptr, runOptions);
+
+        Measure(std::string("ReportSections/run/") + name, 5, NUMBER_OF_EVENTS, [&]() {
+            taskSolver.run(log.path.string(), nullStream);
+        });
+
+        // What the run keeps in memory: the event log it wrote, and the per-table summary made from the tables
+        std::cout << "ReportSections/" << name << ": event log and tables " << taskSolver.getOutputResult().size()
+                  << " bytes" << std::endl;
+    }
+
+    fs::remove(log.path);
+}
+
+void BenchmarkSessionLedger() {
+    constexpr size_t NUMBER_OF_EVENTS = 2000000;
+    auto log = GenerateLog("session_ledger_benchmark", 64, 512, NUMBER_OF_EVENTS);
+    std::ostream nullStream(nullptr);
+
+    Measure("SessionLedger/none", 5, NUMBER_OF_EVENTS, [&]() {
+        TaskSolver().run(log.path.string(), nullStream);
+    });
+
+    CsvLedgerSink csvSink(nullStream);
+    ColumnarLedgerSink columnarSink(nullStream);
+    for (auto [name, sink] : { std::pair<const char*, LedgerSink*>{ "csv", &csvSink },
+                               { "columnar", &columnarSink } })
+    {
+        SessionLedger sessionLedger(*sink);
+        TaskSolver taskSolver(nullptr, {}, nullptr, nullptr, &sessionLedger);
+
+        Measure(std::string("SessionLedger/") + name, 5, NUMBER_OF_EVENTS, [&]() {
+            taskSolver.run(log.path.string(), nullStream);
+        });
+
+        // Memory of the ledger is the visits in progress and a batch, whatever the number of visits
+        std::cout << "SessionLedger/" << name << ": " << sessionLedger.numberOfVisits()
+                  << " visits in all the runs, batches of " << SessionLedger::BATCH_SIZE << std::endl;
+    }
+
+    fs::remove(log.path);
+}
+
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+void BenchmarkServerLatency() {
+    constexpr size_t REQUESTS = 4000;
+    auto log = GenerateLog("server_latency_benchmark", 8, 64, 200);
+    std::ifstream file(log.path);
+    std::stringstream content;
+    content << file.rdbuf();
+
+    std::string socketPath = (fs::temp_directory_path() / "server_latency_benchmark.sock").string();
+    ClubServer clubServer(socketPath, 4, {});
+    if (!clubServer.Start()) {
+        std::cout << "ServerLatency: the socket can't be bound" << std::endl;
+        return;
+    }
+
+    for (size_t numberOfClients : { 1, 4, 16 }) {
+        auto result = RunLoadTest(socketPath, content.str(), numberOfClients, REQUESTS / numberOfClients);
+        PrintLoadTestResult("ServerLatency/" + std::to_string(numberOfClients), result);
+    }
+
+    clubServer.Stop();
+    fs::remove(log.path);
+}
+#endif
+
+int main(int argc, char** argv) {
+    const std::vector<std::pair<std::string, std::function<void()>>> benchmarks = {
+        { "EventDispatch", BenchmarkEventDispatch },
+        { "ManyTables", BenchmarkManyTables },
+        { "FileReading", BenchmarkFileReading },
+        { "ManyClubs", BenchmarkManyClubs },
+        { "TextParsing", BenchmarkTextParsing },
+        { "SegmentParallel", BenchmarkSegmentParallel },
+        { "SparseTables", BenchmarkSparseTables },
+        { "ResultCache", BenchmarkResultCache },
+        { "PerfPhases", BenchmarkPerfPhases },
+        { "AsOfQuery", BenchmarkAsOfQuery },
+        { "LiveSnapshot", BenchmarkLiveSnapshot },
+        { "LogMerge", BenchmarkLogMerge },
+        { "ReorderWindow", BenchmarkReorderWindow },
+        { "StructuredOutput", BenchmarkStructuredOutput },
+        { "CompressedInput", BenchmarkCompressedInput },
+        { "ReportSections", BenchmarkReportSections },
+        { "SessionLedger", BenchmarkSessionLedger },
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+        { "ServerLatency", BenchmarkServerLatency },
+#endif
+    };
+
+    for (const auto& [name, benchmark] : benchmarks) {
+        if (argc == 1 || std::any_of(argv + 1, argv + argc, [&name](const char* arg) { return name == arg; }))
+            benchmark();
+    }
+
+    return 0;
+}
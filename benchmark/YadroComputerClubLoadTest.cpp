@@ -0,0 +1,30 @@
+#include "LoadTest.h"
+#include <fstream>
+#include <sstream>
+
+// YadroComputerClubLoadTest <socket_path> <path_to_txt_file> [<clients> [<requests_per_client>]]
+// Sends the file to a running "YadroComputerClub --serve" as CONTENT requests and reports the latencies
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 5) {
+        std::cout << "Usage: " << argv[0] << " <socket_path> <path_to_txt_file> [<clients> [<requests_per_client>]]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[2]);
+    if (!file.is_open()) {
+        std::cout << argv[2] << std::endl << "The file isn't open!" << std::endl;
+        return 1;
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+
+    size_t numberOfClients = argc > 3 ? std::stoul(argv[3]) : 8;
+    size_t requestsPerClient = argc > 4 ? std::stoul(argv[4]) : 1000;
+
+    auto result = RunLoadTest(argv[1], content.str(), numberOfClients, requestsPerClient);
+    PrintLoadTestResult("LoadTest/" + std::to_string(numberOfClients) + " clients", result);
+
+    return result.failedRequests == 0 ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include "BlockReader.h"
+#include "IoUringBlockReader.h"
+#include <filesystem>
+
+std::unique_ptr<BlockReader> BlockReader::Open(const std::string& fileName, Backend backend) {
+    if (backend == Backend::IoUring)
+        return IoUringBlockReader::Open(fileName);
+
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+        return nullptr;
+
+    std::error_code errorCode;
+    auto fileSize = std::filesystem::file_size(fileName, errorCode);
+    if (backend == Backend::Auto && !errorCode && fileSize <= BLOCK_SIZE) {
+        std::string content(fileSize, '\0');
+        file.read(content.data(), static_cast<std::streamsize>(fileSize));
+        if (file.bad())
+            return nullptr;
+
+        content.resize(static_cast<size_t>(file.gcount()));
+        return std::make_unique<WholeFileBlockReader>(std::move(content));
+    }
+
+    // A read error, e.g. of a directory, shows up on the first read already; peek keeps what it has read
+    file.peek();
+    if (file.bad())
+        return nullptr;
+    file.clear();
+
+    return std::make_unique<ThreadBlockReader>(std::move(file));
+}
+
+ThreadBlockReader::ThreadBlockReader(std::ifstream file)
+                                    : _file(std::move(file)), _thread(&ThreadBlockReader::readAhead, this) { }
+
+ThreadBlockReader::~ThreadBlockReader() {
+    {
+        std::lock_guard lock(_mutex);
+        _isStopped = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+std::string_view ThreadBlockReader::NextBlock() {
+    if (_isEnd)
+        return {};
+
+    std::unique_lock lock(_mutex);
+
+    // The block handed out last time is no longer used by the caller, so the reader thread may refill it
+    if (_hasCurrent) {
+        _buffers[_current].isFilled = false;
+        _current = 1 - _current;
+        _condition.notify_all();
+    }
+
+    _hasCurrent = true;
+    _condition.wait(lock, [this]() { return _buffers[_current].isFilled; });
+    _isEnd = _buffers[_current].size == 0;
+
+    return { _buffers[_current].data.data(), _buffers[_current].size };
+}
+
+void ThreadBlockReader::readAhead() {
+    size_t next = 0;
+
+    while (true) {
+        auto& buffer = _buffers[next];
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this, &buffer]() { return _isStopped || !buffer.isFilled; });
+            if (_isStopped)
+                return;
+        }
+
+        _file.read(buffer.data.data(), static_cast<std::streamsize>(buffer.data.size()));
+        size_t size = static_cast<size_t>(_file.gcount());
+
+        {
+            std::lock_guard lock(_mutex);
+            buffer.size = size;
+            buffer.isFilled = true;
+        }
+        _condition.notify_all();
+
+        if (size == 0)
+            return;
+
+        next = 1 - next;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef COMPUTERCLUB_BLOCKREADER_H
+#define COMPUTERCLUB_BLOCKREADER_H
+
+#include <array>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Reads a file in fixed-size blocks while the previous block is being consumed (double buffering).
+// A block returned by NextBlock() stays valid until the following call.
+class BlockReader {
+public:
+    enum class Backend {
+        Auto,
+        IoUring,
+        Thread,
+    };
+
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+    virtual ~BlockReader() = default;
+
+    // An empty block means the end of the file
+    virtual std::string_view NextBlock() = 0;
+
+    // Returns nullptr if the file can't be opened or its first block can't be read, e.g. it is a directory.
+    // Auto is the reader thread, which reads faster than io_uring in FileReading, or a single read for a file of one
+    // block, for which starting the thread takes longer than the read; io_uring is only used if asked for.
+    static std::unique_ptr<BlockReader> Open(const std::string& fileName, Backend backend = Backend::Auto);
+};
+
+// The whole content is one block
+class MemoryBlockReader : public BlockReader {
+public:
+    explicit MemoryBlockReader(std::string_view content) : _content(content) { }
+
+    std::string_view NextBlock() override { return std::exchange(_content, {}); }
+
+private:
+    std::string_view _content;
+};
+
+// A file read at once, handed out as one block
+class WholeFileBlockReader : public BlockReader {
+public:
+    explicit WholeFileBlockReader(std::string content) : _content(std::move(content)) { }
+
+    std::string_view NextBlock() override { return std::exchange(_isRead, true) ? std::string_view() : _content; }
+
+private:
+    std::string _content;
+    bool _isRead{false};
+};
+
+class ThreadBlockReader : public BlockReader {
+public:
+    explicit ThreadBlockReader(std::ifstream file);
+    ~ThreadBlockReader() override;
+
+    std::string_view NextBlock() override;
+
+private:
+    struct Buffer {
+        std::vector<char> data = std::vector<char>(BLOCK_SIZE);
+        size_t size{};
+        bool isFilled{false};
+    };
+
+    std::ifstream _file;
+    std::array<Buffer, 2> _buffers;
+    size_t _current{};
+    bool _hasCurrent{false};
+    bool _isEnd{false};
+    bool _isStopped{false};
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _thread;
+
+    void readAhead();
+};
+
+
+#endif //COMPUTERCLUB_BLOCKREADER_H
@@ -0,0 +1,251 @@
+#include "DecompressingBlockReader.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#ifdef COMPUTERCLUB_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+#ifdef COMPUTERCLUB_HAS_ZLIB
+// Concatenated gzip members, e.g. of a log appended to with gzip >>, are decompressed one after another
+class GzipDecompressor : public DecompressingBlockReader::Decompressor {
+public:
+    GzipDecompressor() {
+        if (inflateInit2(&_stream, MAX_WBITS + 16) != Z_OK)
+            throw std::runtime_error("zlib can't be initialized");
+    }
+
+    ~GzipDecompressor() override { inflateEnd(&_stream); }
+
+    void Decompress(std::string_view& input, char*& output, char* outputEnd) override {
+        do {
+            if (_isComplete && !input.empty()) {
+                inflateReset(&_stream);
+                _isComplete = false;
+            }
+
+            _stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+            _stream.avail_in = static_cast<uInt>(std::min<size_t>(input.size(), UINT_MAX));
+            _stream.next_out = reinterpret_cast<Bytef*>(output);
+            _stream.avail_out = static_cast<uInt>(std::min<size_t>(outputEnd - output, UINT_MAX));
+
+            int result = inflate(&_stream, Z_NO_FLUSH);
+            input.remove_prefix(input.size() - _stream.avail_in);
+            output = reinterpret_cast<char*>(_stream.next_out);
+
+            // Z_BUF_ERROR only says that there was nothing to do
+            if (result == Z_STREAM_END)
+                _isComplete = true;
+            else if (result != Z_OK && result != Z_BUF_ERROR)
+                throw std::runtime_error("The gzip data is corrupt");
+        } while (!input.empty() && output != outputEnd);
+    }
+
+    bool IsComplete() const override { return _isComplete; }
+
+private:
+    z_stream _stream{};
+    bool _isComplete{false};
+};
+#endif
+
+#ifdef COMPUTERCLUB_HAS_ZSTD
+// Any number of frames one after another, as zstd itself writes them
+class ZstdDecompressor : public DecompressingBlockReader::Decompressor {
+public:
+    ZstdDecompressor() : _context(ZSTD_createDCtx()) {
+        if (!_context)
+            throw std::runtime_error("libzstd can't be initialized");
+    }
+
+    ~ZstdDecompressor() override { ZSTD_freeDCtx(_context); }
+
+    void Decompress(std::string_view& input, char*& output, char* outputEnd) override {
+        // Between frames the decompressor would ask for the next frame header instead
+        if (input.empty() && _isComplete)
+            return;
+
+        ZSTD_inBuffer inBuffer{ input.data(), input.size(), 0 };
+        ZSTD_outBuffer outBuffer{ output, static_cast<size_t>(outputEnd - output), 0 };
+
+        do {
+            size_t result = ZSTD_decompressStream(_context, &outBuffer, &inBuffer);
+            if (ZSTD_isError(result))
+                throw std::runtime_error(std::string("The zstd data is corrupt: ") + ZSTD_getErrorName(result));
+
+            // 0 is returned exactly when a frame is over and all of it is flushed
+            _isComplete = result == 0;
+        } while (inBuffer.pos < inBuffer.size && outBuffer.pos < outBuffer.size);
+
+        input.remove_prefix(inBuffer.pos);
+        output += outBuffer.pos;
+    }
+
+    bool IsComplete() const override { return _isComplete; }
+
+private:
+    ZSTD_DCtx* _context;
+    bool _isComplete{false};
+};
+#endif
+
+}
+
+DecompressingBlockReader::Compression DecompressingBlockReader::CompressionOf(std::string_view fileName) {
+    if (fileName.ends_with(".gz"))
+        return Compression::Gzip;
+    if (fileName.ends_with(".zst"))
+        return Compression::Zstd;
+
+    return Compression::None;
+}
+
+bool DecompressingBlockReader::IsSupported(Compression compression) {
+    switch (compression) {
+        case Compression::None:
+            return true;
+        case Compression::Gzip:
+#ifdef COMPUTERCLUB_HAS_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case Compression::Zstd:
+#ifdef COMPUTERCLUB_HAS_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+std::unique_ptr<BlockReader> DecompressingBlockReader::Open(const std::string& fileName, Compression compression) {
+    if (compression == Compression::None)
+        return BlockReader::Open(fileName);
+    if (!IsSupported(compression))
+        return nullptr;
+
+    auto compressedReader = BlockReader::Open(fileName);
+    if (!compressedReader)
+        return nullptr;
+
+    std::unique_ptr<Decompressor> decompressor;
+#ifdef COMPUTERCLUB_HAS_ZLIB
+    if (compression == Compression::Gzip)
+        decompressor = std::make_unique<GzipDecompressor>();
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+    if (compression == Compression::Zstd)
+        decompressor = std::make_unique<ZstdDecompressor>();
+#endif
+
+    return std::unique_ptr<BlockReader>(new DecompressingBlockReader(std::move(compressedReader),
+                                                                     std::move(decompressor)));
+}
+
+DecompressingBlockReader::DecompressingBlockReader(std::unique_ptr<BlockReader> compressedReader,
+                                                   std::unique_ptr<Decompressor> decompressor)
+                                                  : _compressedReader(std::move(compressedReader)),
+                                                    _decompressor(std::move(decompressor)),
+                                                    _thread(&DecompressingBlockReader::decompressAhead, this) { }
+
+DecompressingBlockReader::~DecompressingBlockReader() {
+    {
+        std::lock_guard lock(_mutex);
+        _isStopped = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+std::string_view DecompressingBlockReader::NextBlock() {
+    if (_isEnd)
+        return {};
+
+    std::unique_lock lock(_mutex);
+
+    // The block handed out last time is no longer used by the caller, so the decompression thread may refill it
+    if (_hasCurrent) {
+        _buffers[_current].isFilled = false;
+        _current = 1 - _current;
+        _condition.notify_all();
+    }
+
+    _hasCurrent = true;
+    _condition.wait(lock, [this]() { return _buffers[_current].isFilled; });
+    _isEnd = _buffers[_current].size == 0;
+
+    if (_isEnd && _exception)
+        std::rethrow_exception(_exception);
+
+    return { _buffers[_current].data.data(), _buffers[_current].size };
+}
+
+void DecompressingBlockReader::decompressAhead() {
+    std::string_view input;
+    bool isInputEnd = false;
+    size_t next = 0;
+
+    while (true) {
+        auto& buffer = _buffers[next];
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this, &buffer]() { return _isStopped || !buffer.isFilled; });
+            if (_isStopped)
+                return;
+        }
+
+        size_t size = 0;
+        std::exception_ptr exception;
+        try {
+            size = fillBuffer(buffer, input, isInputEnd);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            buffer.size = size;
+            buffer.isFilled = true;
+            _exception = exception;
+        }
+        _condition.notify_all();
+
+        if (size == 0)
+            return;
+
+        next = 1 - next;
+    }
+}
+
+// Fills the buffer up unless the data ends first, and returns how much was decompressed into it
+size_t DecompressingBlockReader::fillBuffer(Buffer& buffer, std::string_view& input, bool& isInputEnd) {
+    char* output = buffer.data.data();
+    char* outputEnd = output + buffer.data.size();
+
+    while (output != outputEnd) {
+        if (input.empty() && !isInputEnd) {
+            input = _compressedReader->NextBlock();
+            isInputEnd = input.empty();
+        }
+
+        // Past the end of the input only what the decompressor still holds comes out
+        char* previousOutput = output;
+        _decompressor->Decompress(input, output, outputEnd);
+
+        if (isInputEnd && output == previousOutput) {
+            if (!_decompressor->IsComplete())
+                throw std::runtime_error("The compressed data is truncated");
+            break;
+        }
+    }
+
+    return static_cast<size_t>(output - buffer.data.data());
+}
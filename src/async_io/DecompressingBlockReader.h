@@ -0,0 +1,68 @@
+#ifndef COMPUTERCLUB_DECOMPRESSINGBLOCKREADER_H
+#define COMPUTERCLUB_DECOMPRESSINGBLOCKREADER_H
+
+#include "BlockReader.h"
+#include <exception>
+
+// Decompresses the blocks of another BlockReader on its own thread into two BLOCK_SIZE buffers (double buffering),
+// so reading, decompression and parsing overlap and memory stays bounded however large the file is.
+// Gzip needs zlib and zstd needs libzstd at build time (COMPUTERCLUB_HAS_ZLIB, COMPUTERCLUB_HAS_ZSTD).
+// Corrupt or truncated data makes NextBlock throw std::runtime_error.
+class DecompressingBlockReader : public BlockReader {
+public:
+    enum class Compression {
+        None,
+        Gzip,
+        Zstd,
+    };
+
+    // By the extension: ".gz" or ".zst", anything else is not compressed
+    static Compression CompressionOf(std::string_view fileName);
+    static bool IsSupported(Compression compression);
+
+    // Returns nullptr if the file can't be opened or the compression isn't supported
+    static std::unique_ptr<BlockReader> Open(const std::string& fileName, Compression compression);
+
+    ~DecompressingBlockReader() override;
+
+    std::string_view NextBlock() override;
+
+    // Decompresses from input into [output, outputEnd), advancing both; one implementation per compression
+    class Decompressor {
+    public:
+        virtual ~Decompressor() = default;
+
+        virtual void Decompress(std::string_view& input, char*& output, char* outputEnd) = 0;
+        // Whether the input so far ends exactly at the end of a compressed stream
+        virtual bool IsComplete() const = 0;
+    };
+
+private:
+    DecompressingBlockReader(std::unique_ptr<BlockReader> compressedReader,
+                             std::unique_ptr<Decompressor> decompressor);
+
+    struct Buffer {
+        std::vector<char> data = std::vector<char>(BLOCK_SIZE);
+        size_t size{};
+        bool isFilled{false};
+    };
+
+    std::unique_ptr<BlockReader> _compressedReader;
+    std::unique_ptr<Decompressor> _decompressor;
+    std::array<Buffer, 2> _buffers;
+    size_t _current{};
+    bool _hasCurrent{false};
+    bool _isEnd{false};
+    bool _isStopped{false};
+    std::exception_ptr _exception;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _thread;
+
+    void decompressAhead();
+    size_t fillBuffer(Buffer& buffer, std::string_view& input, bool& isInputEnd);
+};
+
+
+#endif //COMPUTERCLUB_DECOMPRESSINGBLOCKREADER_H
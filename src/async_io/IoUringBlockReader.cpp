@@ -0,0 +1,181 @@
+#include "IoUringBlockReader.h"
+
+#ifdef COMPUTERCLUB_HAS_IO_URING
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+std::unique_ptr<IoUringBlockReader> IoUringBlockReader::Open(const std::string& fileName) {
+    std::unique_ptr<IoUringBlockReader> reader(new IoUringBlockReader());
+
+    reader->_fileDescriptor = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (reader->_fileDescriptor < 0 || !reader->setupRing())
+        return nullptr;
+
+    for (size_t i = 0; i < reader->_buffers.size(); i++) {
+        reader->_buffers[i].resize(BLOCK_SIZE);
+        reader->_vectors[i] = { reader->_buffers[i].data(), BLOCK_SIZE };
+    }
+
+    reader->submitRead(0);
+    int result = reader->waitForCompletion();
+    if (result < 0)
+        return nullptr;
+
+    reader->_firstResult = result;
+    return reader;
+}
+
+IoUringBlockReader::~IoUringBlockReader() {
+    // The kernel may still be writing into a buffer, so the last read has to land before the memory is freed
+    try {
+        if (_isReading)
+            waitForCompletion();
+    } catch (const std::system_error&) {
+        // The ring is torn down below in any case
+    }
+
+    if (_submissionEntries)
+        munmap(_submissionEntries, _submissionEntriesSize);
+    if (_completionRing && _completionRing != _submissionRing)
+        munmap(_completionRing, _completionRingSize);
+    if (_submissionRing)
+        munmap(_submissionRing, _submissionRingSize);
+    if (_ringFileDescriptor >= 0)
+        close(_ringFileDescriptor);
+    if (_fileDescriptor >= 0)
+        close(_fileDescriptor);
+}
+
+std::string_view IoUringBlockReader::NextBlock() {
+    if (!_isReading && !_firstResult)
+        return {};
+
+    int result = _firstResult ? *std::exchange(_firstResult, std::nullopt) : waitForCompletion();
+    if (result < 0)
+        throw std::system_error(-result, std::generic_category(), "io_uring read failed");
+
+    size_t current = _inFlight;
+    if (result == 0)
+        return {};
+
+    _offset += static_cast<size_t>(result);
+    submitRead(1 - current);
+
+    return { _buffers[current].data(), static_cast<size_t>(result) };
+}
+
+bool IoUringBlockReader::setupRing() {
+    io_uring_params parameters{};
+    _ringFileDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, 2, &parameters));
+    if (_ringFileDescriptor < 0)
+        return false;
+
+    _submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+    _completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+
+    bool isSingleMapping = parameters.features & IORING_FEAT_SINGLE_MMAP;
+    if (isSingleMapping)
+        _submissionRingSize = _completionRingSize = std::max(_submissionRingSize, _completionRingSize);
+
+    _submissionRing = mmap(nullptr, _submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           _ringFileDescriptor, IORING_OFF_SQ_RING);
+    if (_submissionRing == MAP_FAILED) {
+        _submissionRing = nullptr;
+        return false;
+    }
+
+    if (isSingleMapping) {
+        _completionRing = _submissionRing;
+    } else {
+        _completionRing = mmap(nullptr, _completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               _ringFileDescriptor, IORING_OFF_CQ_RING);
+        if (_completionRing == MAP_FAILED) {
+            _completionRing = nullptr;
+            return false;
+        }
+    }
+
+    _submissionEntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+    void* entries = mmap(nullptr, _submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         _ringFileDescriptor, IORING_OFF_SQES);
+    if (entries == MAP_FAILED)
+        return false;
+    _submissionEntries = static_cast<io_uring_sqe*>(entries);
+
+    auto* submissionRing = static_cast<char*>(_submissionRing);
+    _submissionTail = reinterpret_cast<unsigned*>(submissionRing + parameters.sq_off.tail);
+    _submissionMask = reinterpret_cast<unsigned*>(submissionRing + parameters.sq_off.ring_mask);
+    _submissionArray = reinterpret_cast<unsigned*>(submissionRing + parameters.sq_off.array);
+
+    auto* completionRing = static_cast<char*>(_completionRing);
+    _completionHead = reinterpret_cast<unsigned*>(completionRing + parameters.cq_off.head);
+    _completionTail = reinterpret_cast<unsigned*>(completionRing + parameters.cq_off.tail);
+    _completionMask = reinterpret_cast<unsigned*>(completionRing + parameters.cq_off.ring_mask);
+    _completionEntries = reinterpret_cast<io_uring_cqe*>(completionRing + parameters.cq_off.cqes);
+
+    return true;
+}
+
+void IoUringBlockReader::submitRead(size_t buffer) {
+    unsigned tail = std::atomic_ref(*_submissionTail).load(std::memory_order_relaxed);
+    unsigned index = tail & *_submissionMask;
+
+    io_uring_sqe& entry = _submissionEntries[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.opcode = IORING_OP_READV;
+    entry.fd = _fileDescriptor;
+    entry.addr = reinterpret_cast<uint64_t>(&_vectors[buffer]);
+    entry.len = 1;
+    entry.off = _offset;
+    entry.user_data = buffer;
+
+    _submissionArray[index] = index;
+    std::atomic_ref(*_submissionTail).store(tail + 1, std::memory_order_release);
+
+    if (syscall(__NR_io_uring_enter, _ringFileDescriptor, 1, 0, 0, nullptr, 0) < 0)
+        throw std::system_error(errno, std::generic_category(), "io_uring submission failed");
+
+    _inFlight = buffer;
+    _isReading = true;
+}
+
+int IoUringBlockReader::waitForCompletion() {
+    unsigned head = std::atomic_ref(*_completionHead).load(std::memory_order_relaxed);
+
+    while (head == std::atomic_ref(*_completionTail).load(std::memory_order_acquire)) {
+        if (syscall(__NR_io_uring_enter, _ringFileDescriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+            errno != EINTR)
+        {
+            throw std::system_error(errno, std::generic_category(), "io_uring wait failed");
+        }
+    }
+
+    int result = _completionEntries[head & *_completionMask].res;
+    std::atomic_ref(*_completionHead).store(head + 1, std::memory_order_release);
+
+    _isReading = false;
+    return result;
+}
+
+#else
+
+std::unique_ptr<IoUringBlockReader> IoUringBlockReader::Open(const std::string&) {
+    return nullptr;
+}
+
+IoUringBlockReader::~IoUringBlockReader() = default;
+
+std::string_view IoUringBlockReader::NextBlock() {
+    return {};
+}
+
+#endif
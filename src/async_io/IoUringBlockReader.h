@@ -0,0 +1,62 @@
+#ifndef COMPUTERCLUB_IOURINGBLOCKREADER_H
+#define COMPUTERCLUB_IOURINGBLOCKREADER_H
+
+#include "BlockReader.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define COMPUTERCLUB_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <optional>
+#include <sys/uio.h>
+#endif
+
+// Keeps one read in flight through a two-entry io_uring while the caller parses the other buffer.
+// The ring is driven by raw system calls, so no liburing is needed.
+class IoUringBlockReader : public BlockReader {
+public:
+    // Returns nullptr if the file can't be opened or io_uring is unavailable (old kernel, seccomp, non-Linux), and
+    // if the first block can't be read, e.g. of a directory
+    static std::unique_ptr<IoUringBlockReader> Open(const std::string& fileName);
+
+    ~IoUringBlockReader() override;
+
+    std::string_view NextBlock() override;
+
+#ifdef COMPUTERCLUB_HAS_IO_URING
+private:
+    IoUringBlockReader() = default;
+
+    int _fileDescriptor{-1};
+    int _ringFileDescriptor{-1};
+
+    void* _submissionRing{nullptr};
+    size_t _submissionRingSize{};
+    void* _completionRing{nullptr};
+    size_t _completionRingSize{};
+    io_uring_sqe* _submissionEntries{nullptr};
+    size_t _submissionEntriesSize{};
+
+    unsigned* _submissionTail{nullptr};
+    unsigned* _submissionMask{nullptr};
+    unsigned* _submissionArray{nullptr};
+    unsigned* _completionHead{nullptr};
+    unsigned* _completionTail{nullptr};
+    unsigned* _completionMask{nullptr};
+    io_uring_cqe* _completionEntries{nullptr};
+
+    std::array<std::vector<char>, 2> _buffers;
+    std::array<iovec, 2> _vectors{};
+    size_t _inFlight{};
+    bool _isReading{false};
+    // The first read, which Open waits for
+    std::optional<int> _firstResult;
+    size_t _offset{};
+
+    bool setupRing();
+    void submitRead(size_t buffer);
+    int waitForCompletion();
+#endif
+};
+
+
+#endif //COMPUTERCLUB_IOURINGBLOCKREADER_H
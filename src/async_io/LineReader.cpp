@@ -0,0 +1,27 @@
+#include "LineReader.h"
+
+bool LineReader::GetLine(std::string& line) {
+    line.clear();
+    bool isExtracted = false;
+
+    while (!_isEnd) {
+        if (_block.empty()) {
+            _block = _blockReader->NextBlock();
+            _isEnd = _block.empty();
+            continue;
+        }
+
+        size_t pos = _block.find('\n');
+        if (pos != std::string_view::npos) {
+            line.append(_block.substr(0, pos));
+            _block.remove_prefix(pos + 1);
+            return true;
+        }
+
+        line.append(_block);
+        _block = {};
+        isExtracted = true;
+    }
+
+    return isExtracted;
+}
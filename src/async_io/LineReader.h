@@ -0,0 +1,20 @@
+#ifndef COMPUTERCLUB_LINEREADER_H
+#define COMPUTERCLUB_LINEREADER_H
+
+#include "BlockReader.h"
+
+// Splits the blocks of a BlockReader into lines with the same semantics as std::getline
+class LineReader {
+public:
+    explicit LineReader(std::unique_ptr<BlockReader> blockReader) : _blockReader(std::move(blockReader)) { }
+
+    bool GetLine(std::string& line);
+
+private:
+    std::unique_ptr<BlockReader> _blockReader;
+    std::string_view _block;
+    bool _isEnd{false};
+};
+
+
+#endif //COMPUTERCLUB_LINEREADER_H
@@ -0,0 +1,49 @@
+#include "OutputWriter.h"
+
+OutputWriter::OutputWriter(std::ostream& stream) : _stream(stream), _thread(&OutputWriter::writeBehind, this) { }
+
+OutputWriter::~OutputWriter() {
+    {
+        std::lock_guard lock(_mutex);
+        _isStopped = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void OutputWriter::Write(std::string chunk) {
+    {
+        std::lock_guard lock(_mutex);
+        _chunks.push_back(std::move(chunk));
+    }
+    _condition.notify_all();
+}
+
+void OutputWriter::Flush() {
+    std::unique_lock lock(_mutex);
+    _condition.wait(lock, [this]() { return _chunks.empty() && !_isWriting; });
+}
+
+void OutputWriter::writeBehind() {
+    std::unique_lock lock(_mutex);
+
+    while (true) {
+        _condition.wait(lock, [this]() { return _isStopped || !_chunks.empty(); });
+        if (_chunks.empty())
+            return;
+
+        std::string chunk = std::move(_chunks.front());
+        _chunks.pop_front();
+        bool isLast = _chunks.empty();
+        _isWriting = true;
+
+        lock.unlock();
+        _stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        if (isLast)
+            _stream.flush();
+        lock.lock();
+
+        _isWriting = false;
+        _condition.notify_all();
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef COMPUTERCLUB_OUTPUTWRITER_H
+#define COMPUTERCLUB_OUTPUTWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// Write-behind queue: chunks are written to the stream by a background thread, so the caller can go on
+// with the next piece of work while the previous report is still being written out
+class OutputWriter {
+public:
+    explicit OutputWriter(std::ostream& stream);
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    void Write(std::string chunk);
+
+    // Blocks until every queued chunk has been written and the stream is flushed
+    void Flush();
+
+private:
+    std::ostream& _stream;
+    std::deque<std::string> _chunks;
+    bool _isWriting{false};
+    bool _isStopped{false};
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::thread _thread;
+
+    void writeBehind();
+};
+
+
+#endif //COMPUTERCLUB_OUTPUTWRITER_H
@@ -0,0 +1,439 @@
+#include "BatchRunner.h"
+#include "TaskSolver.h"
+#include "TextFormat.h"
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <queue>
+#include <spawn.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <unordered_map>
+
+extern char** environ;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// A result file is a record per log: "<number> <exit code> <revenue> <report length>\n" followed by the report
+struct RecordHeader {
+    size_t number{};
+    int exitCode{};
+    size_t revenue{};
+    size_t length{};
+};
+
+bool parseRecordHeader(std::string_view line, RecordHeader& header) {
+    const char* position = line.data();
+    const char* end = line.data() + line.size();
+
+    auto parseField = [&position, end](auto& value) {
+        auto [ptr, errorCode] = std::from_chars(position, end, value);
+        if (errorCode != std::errc() || (ptr != end && *ptr != ' '))
+            return false;
+
+        position = ptr == end ? end : ptr + 1;
+        return true;
+    };
+
+    return parseField(header.number) && parseField(header.exitCode) && parseField(header.revenue) &&
+           parseField(header.length) && position == end;
+}
+
+std::string quoteForShell(std::string_view value) {
+    std::string quoted = "'";
+    for (char symbol : value) {
+        if (symbol == '\'')
+            quoted.append("'\\''");
+        else
+            quoted.push_back(symbol);
+    }
+    quoted.push_back('\'');
+
+    return quoted;
+}
+
+std::string quoteForShell(const std::vector<std::string>& values) {
+    std::string quoted;
+    for (const auto& value : values) {
+        if (!quoted.empty())
+            quoted.push_back(' ');
+        quoted.append(quoteForShell(value));
+    }
+
+    return quoted;
+}
+
+// Replaces every "{name}" of the command that has a value with the value as it is, so the values must be quoted
+// already; other braces are left as they are
+std::string expandCommand(std::string_view command, const std::map<std::string_view, std::string>& values) {
+    std::string expanded;
+
+    for (size_t position = 0; position < command.size(); ) {
+        size_t open = command.find('{', position);
+        size_t close = open == std::string_view::npos ? open : command.find('}', open);
+        if (close == std::string_view::npos) {
+            expanded.append(command.substr(position));
+            break;
+        }
+
+        expanded.append(command.substr(position, open - position));
+        auto value = values.find(command.substr(open + 1, close - open - 1));
+        if (value == values.end())
+            expanded.append(command.substr(open, close + 1 - open));
+        else
+            expanded.append(value->second);
+
+        position = close + 1;
+    }
+
+    return expanded;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), {} };
+}
+
+}
+
+int BatchRunner::Run(std::ostream& stream) {
+    if (!ReadManifest(_options.manifestPath, _logs)) {
+        stream << _options.manifestPath << std::endl;
+        stream << "The manifest can't be read or has an incorrect line!" << std::endl;
+        return static_cast<int>(ErrorType::IncorrectManifest);
+    }
+
+    std::error_code errorCode;
+    fs::create_directories(_options.workDirectory, errorCode);
+    if (errorCode) {
+        stream << _options.workDirectory << std::endl;
+        stream << "The work directory can't be created!" << std::endl;
+        return static_cast<int>(ErrorType::FailedShard);
+    }
+
+    _shards = SplitIntoShards(_logs, _options.numberOfShards ? _options.numberOfShards : _options.numberOfWorkers);
+    _results.assign(_logs.size(), {});
+
+    if (!runShards(stream))
+        return static_cast<int>(ErrorType::FailedShard);
+
+    printReport(stream);
+    return static_cast<int>(ErrorType::Success);
+}
+
+int BatchRunner::RunShard(const std::string& shardManifestPath, const std::string& resultPath,
+                          RunOptions runOptions)
+{
+    std::ifstream manifest(shardManifestPath);
+    if (!manifest.is_open())
+        return static_cast<int>(ErrorType::IncorrectManifest);
+
+    // The result appears only when it is complete, so a worker that dies leaves no result behind
+    std::string temporaryPath = resultPath + ".tmp";
+    std::ofstream result(temporaryPath, std::ios::binary | std::ios::trunc);
+
+    runOptions.outputFormat = OutputFormat::Text;
+    TaskSolver taskSolver(nullptr, runOptions);
+    std::ostringstream report;
+    std::string header;
+
+    // "<number> <club> <size> <modification time> <path_to_txt_file>" lines; the size and the time are only there
+    // for the runner to tell a changed log, as is the line of options starting with '#'
+    for (std::string line; std::getline(manifest, line); ) {
+        if (line.starts_with('#'))
+            continue;
+
+        size_t clubPos = line.find(' ') + 1;
+        size_t pathPos = clubPos;
+        for (size_t field = 0; field < 3 && pathPos != 0; field++)
+            pathPos = line.find(' ', pathPos) + 1;
+        if (clubPos == 0 || pathPos == 0)
+            return static_cast<int>(ErrorType::IncorrectManifest);
+
+        report.str({});
+        int exitCode;
+        try {
+            exitCode = taskSolver.run(line.substr(pathPos), report);
+        } catch (const std::exception& exception) {
+            report << "Caught an unexpected exception: " << exception.what() << std::endl;
+            exitCode = static_cast<int>(ErrorType::UnexpectedError);
+        }
+
+        std::string logReport = report.str();
+        header.assign(line, 0, clubPos - 1);
+        header.push_back(' ');
+        header.append(std::to_string(exitCode)).push_back(' ');
+        appendNumber(header, exitCode == static_cast<int>(ErrorType::Success) ? taskSolver.getRevenue() : 0);
+        header.push_back(' ');
+        appendNumber(header, logReport.size());
+        header.push_back('\n');
+
+        result << header << logReport;
+    }
+
+    result.close();
+    if (!result) {
+        fs::remove(temporaryPath);
+        return static_cast<int>(ErrorType::FailedShard);
+    }
+
+    std::error_code errorCode;
+    fs::rename(temporaryPath, resultPath, errorCode);
+    return static_cast<int>(errorCode ? ErrorType::FailedShard : ErrorType::Success);
+}
+
+bool BatchRunner::ReadManifest(const std::string& manifestPath, std::vector<Log>& logs) {
+    std::ifstream manifest(manifestPath);
+    if (!manifest.is_open())
+        return false;
+
+    logs.clear();
+    for (std::string line; std::getline(manifest, line); ) {
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        size_t pathPos = line.find(' ');
+        if (pathPos == 0 || pathPos == std::string::npos || pathPos + 1 == line.size())
+            return false;
+
+        // A log that can't be read still gets its error in the report, so it is not a reason to stop here
+        Log log{ logs.size(), line.substr(0, pathPos), line.substr(pathPos + 1) };
+        std::error_code errorCode;
+        log.size = fs::file_size(log.path, errorCode);
+        if (errorCode)
+            log.size = 0;
+        log.modificationTime = fs::last_write_time(log.path, errorCode).time_since_epoch().count();
+        if (errorCode)
+            log.modificationTime = 0;
+
+        logs.push_back(std::move(log));
+    }
+
+    return true;
+}
+
+std::vector<std::vector<BatchRunner::Log>> BatchRunner::SplitIntoShards(std::vector<Log> logs,
+                                                                         size_t numberOfShards)
+{
+    numberOfShards = std::clamp<size_t>(numberOfShards, 1, std::max<size_t>(logs.size(), 1));
+    std::vector<std::vector<Log>> shards(numberOfShards);
+
+    std::ranges::stable_sort(logs, std::ranges::greater{}, &Log::size);
+
+    using ShardSize = std::pair<uintmax_t, size_t>;
+    std::priority_queue<ShardSize, std::vector<ShardSize>, std::greater<>> shardSizes;
+    for (size_t shard = 0; shard < numberOfShards; shard++)
+        shardSizes.emplace(0, shard);
+
+    for (auto& log : logs) {
+        auto [size, shard] = shardSizes.top();
+        shardSizes.pop();
+
+        shardSizes.emplace(size + log.size, shard);
+        shards[shard].push_back(std::move(log));
+    }
+
+    for (auto& shard : shards)
+        std::ranges::sort(shard, {}, &Log::number);
+
+    return shards;
+}
+
+std::string BatchRunner::ShardManifestPath(const std::string& workDirectory, size_t shard) {
+    return (fs::path(workDirectory) / ("shard-" + std::to_string(shard) + ".manifest")).string();
+}
+
+std::string BatchRunner::ShardResultPath(const std::string& workDirectory, size_t shard) {
+    return (fs::path(workDirectory) / ("shard-" + std::to_string(shard) + ".result")).string();
+}
+
+bool BatchRunner::prepareShard(size_t shard) {
+    std::string manifest = "#";
+    for (const auto& option : reportOptions())
+        manifest.append(" ").append(option);
+    manifest.push_back('\n');
+
+    for (const auto& log : _shards[shard]) {
+        appendNumber(manifest, log.number);
+        manifest.append(" ").append(log.club).push_back(' ');
+        appendNumber(manifest, log.size);
+        manifest.push_back(' ');
+        manifest.append(std::to_string(log.modificationTime)).push_back(' ');
+        manifest.append(log.path).push_back('\n');
+    }
+
+    // A result is only as good as the manifest it was made for, which changes with any of its logs and with the
+    // options the reports depend on
+    std::string manifestPath = ShardManifestPath(_options.workDirectory, shard);
+    if (readFile(manifestPath) == manifest && readResult(shard))
+        return true;
+
+    std::error_code errorCode;
+    fs::remove(ShardResultPath(_options.workDirectory, shard), errorCode);
+    std::ofstream(manifestPath, std::ios::binary | std::ios::trunc) << manifest;
+
+    return false;
+}
+
+bool BatchRunner::runShards(std::ostream& stream) {
+    std::deque<size_t> pendingShards;
+    for (size_t shard = 0; shard < _shards.size(); shard++) {
+        if (!prepareShard(shard))
+            pendingShards.push_back(shard);
+    }
+
+    std::vector<size_t> attempts(_shards.size());
+    std::vector<size_t> failedShards;
+    std::unordered_map<pid_t, size_t> runningShards;
+
+    auto shardFailed = [&](size_t shard) {
+        if (++attempts[shard] > _options.numberOfRetries)
+            failedShards.push_back(shard);
+        else
+            pendingShards.push_back(shard);
+    };
+
+    while (!pendingShards.empty() || !runningShards.empty()) {
+        while (!pendingShards.empty() && runningShards.size() < std::max<size_t>(_options.numberOfWorkers, 1)) {
+            size_t shard = pendingShards.front();
+            pendingShards.pop_front();
+
+            int processId = launchWorker(shard, attempts[shard]);
+            if (processId < 0)
+                shardFailed(shard);
+            else
+                runningShards.emplace(processId, shard);
+        }
+
+        if (runningShards.empty())
+            continue;
+
+        int status;
+        pid_t processId = waitpid(-1, &status, 0);
+        auto runningShard = runningShards.find(processId);
+        if (runningShard == runningShards.end())
+            continue;
+
+        size_t shard = runningShard->second;
+        runningShards.erase(runningShard);
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !readResult(shard))
+            shardFailed(shard);
+    }
+
+    std::ranges::sort(failedShards);
+    for (size_t shard : failedShards) {
+        stream << ShardResultPath(_options.workDirectory, shard) << std::endl;
+        stream << "The shard has failed " << attempts[shard] << " times!" << std::endl;
+    }
+
+    return failedShards.empty();
+}
+
+int BatchRunner::launchWorker(size_t shard, size_t attempt) const {
+    std::string manifestPath = ShardManifestPath(_options.workDirectory, shard);
+    std::string resultPath = ShardResultPath(_options.workDirectory, shard);
+
+    std::vector<std::string> options = reportOptions();
+    if (_options.runOptions.numberOfThreads > 1)
+        options.insert(options.end(), { "--threads", std::to_string(_options.runOptions.numberOfThreads) });
+
+    std::vector<std::string> arguments;
+    if (_options.workerCommand.empty()) {
+        arguments = { _options.binaryPath, "--batch-shard", manifestPath, "--shard-result", resultPath };
+        arguments.insert(arguments.end(), options.begin(), options.end());
+    } else {
+        arguments = { "/bin/sh", "-c", expandCommand(_options.workerCommand, {
+            { "binary", quoteForShell(_options.binaryPath) }, { "manifest", quoteForShell(manifestPath) },
+            { "result", quoteForShell(resultPath) }, { "shard", quoteForShell(std::to_string(shard)) },
+            { "attempt", quoteForShell(std::to_string(attempt)) }, { "options", quoteForShell(options) },
+        })};
+    }
+
+    std::vector<char*> argv;
+    for (auto& argument : arguments)
+        argv.push_back(argument.data());
+    argv.push_back(nullptr);
+
+    pid_t processId;
+    if (posix_spawn(&processId, argv.front(), nullptr, nullptr, argv.data(), environ) != 0)
+        return -1;
+
+    return processId;
+}
+
+std::vector<std::string> BatchRunner::reportOptions() const {
+    std::vector<std::string> options;
+    if (_options.runOptions.reorderWindowMinutes != 0)
+        options.insert(options.end(), { "--reorder-window", std::to_string(_options.runOptions.reorderWindowMinutes) });
+
+    const auto& sections = _options.runOptions.reportSections;
+    if (sections != ReportSections{}) {
+        std::string names;
+        for (auto [name, isSelected] : { std::pair{ "echo", sections.echo }, { "events", sections.events },
+                                         { "tables", sections.tables }, { "totals", sections.totals } })
+        {
+            if (isSelected)
+                names.append(names.empty() ? "" : ",").append(name);
+        }
+        options.insert(options.end(), { "--sections", names });
+    }
+
+    return options;
+}
+
+// Takes the reports of the shard's logs from its result file; false if it is missing, incomplete or not for them
+bool BatchRunner::readResult(size_t shard) {
+    std::string resultPath = ShardResultPath(_options.workDirectory, shard);
+    std::ifstream result(resultPath, std::ios::binary);
+    std::error_code errorCode;
+    uintmax_t resultSize = fs::file_size(resultPath, errorCode);
+    if (!result.is_open() || errorCode)
+        return false;
+
+    std::string line;
+    RecordHeader header;
+
+    for (const auto& log : _shards[shard]) {
+        if (!std::getline(result, line) || !parseRecordHeader(line, header) || header.number != log.number)
+            return false;
+
+        // A damaged length must not make the report any longer than the rest of the file
+        auto position = static_cast<uintmax_t>(result.tellg());
+        if (position > resultSize || header.length > resultSize - position)
+            return false;
+
+        auto& logResult = _results[log.number];
+        logResult.exitCode = header.exitCode;
+        logResult.revenue = header.revenue;
+        logResult.report.resize(header.length);
+        if (!result.read(logResult.report.data(), static_cast<std::streamsize>(header.length)))
+            return false;
+    }
+
+    return result.peek() == std::ifstream::traits_type::eof();
+}
+
+void BatchRunner::printReport(std::ostream& stream) const {
+    std::map<std::string_view, size_t> revenueByClub;
+    size_t totalRevenue = 0;
+
+    for (const auto& log : _logs) {
+        const auto& logResult = _results[log.number];
+        stream << log.club << ' ' << log.path << '\n' << logResult.report;
+
+        revenueByClub[log.club] += logResult.revenue;
+        totalRevenue += logResult.revenue;
+    }
+
+    stream << "Revenue by club:\n";
+    for (const auto& [club, revenue] : revenueByClub)
+        stream << club << ' ' << revenue << '\n';
+    stream << "Total " << totalRevenue << std::endl;
+}
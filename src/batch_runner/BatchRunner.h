@@ -0,0 +1,90 @@
+#ifndef COMPUTERCLUB_BATCHRUNNER_H
+#define COMPUTERCLUB_BATCHRUNNER_H
+
+#include "InputFileData.h"
+#include "RunOptions.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct BatchOptions {
+    std::string manifestPath;
+    std::string workDirectory;
+    // 0 makes one shard per worker
+    size_t numberOfShards{};
+    size_t numberOfWorkers{4};
+    // How many more times a failed shard is run
+    size_t numberOfRetries{2};
+    // Run through /bin/sh for every shard, with {binary}, {manifest}, {result}, {shard} and {attempt} replaced by
+    // shell-quoted values and {options} by the options of runOptions, e.g.
+    // "ssh host{shard} {binary} --batch-shard {manifest} --shard-result {result} {options}" when the work directory
+    // is shared. Empty runs the binary on this host directly, with those options.
+    std::string workerCommand;
+    std::string binaryPath;
+    // The reports are always text, whatever the output format
+    RunOptions runOptions;
+};
+
+// Reprocesses an archive of logs with several worker processes. The manifest has a "<club> <path_to_txt_file>"
+// line per log; empty lines and lines starting with '#' are skipped. The logs are split into shards of about
+// the same size in bytes, and the worker of shard N reads <work directory>/shard-N.manifest and writes the
+// reports of its logs to <work directory>/shard-N.result. A shard whose result is there is never run again,
+// unless its logs have changed in size or modification time, so a batch with failed shards is finished by
+// running it once more.
+// The results are merged into one report: the report of every log in the order of the manifest, then the
+// revenue of every club.
+class BatchRunner {
+public:
+    struct Log {
+        // The line of the log in the manifest, counting logs only
+        size_t number{};
+        std::string club;
+        std::string path;
+        uintmax_t size{};
+        // In ticks of the file clock; with the size it tells whether the log has changed since a shard was run
+        int64_t modificationTime{};
+    };
+
+    explicit BatchRunner(BatchOptions options) : _options(std::move(options)) { }
+
+    // Returns the exit code of the program
+    int Run(std::ostream& stream = std::cout);
+
+    // The worker: handles the logs of a shard manifest one after another and writes the result file
+    static int RunShard(const std::string& shardManifestPath, const std::string& resultPath,
+                        RunOptions runOptions = {});
+
+    static bool ReadManifest(const std::string& manifestPath, std::vector<Log>& logs);
+    // Largest logs first, each to the shard that is the smallest so far; within a shard the manifest order is kept
+    static std::vector<std::vector<Log>> SplitIntoShards(std::vector<Log> logs, size_t numberOfShards);
+
+    static std::string ShardManifestPath(const std::string& workDirectory, size_t shard);
+    static std::string ShardResultPath(const std::string& workDirectory, size_t shard);
+
+private:
+    struct LogResult {
+        int exitCode{};
+        size_t revenue{};
+        std::string report;
+    };
+
+    BatchOptions _options;
+    std::vector<Log> _logs;
+    std::vector<std::vector<Log>> _shards;
+    // Indexed by the number of the log
+    std::vector<LogResult> _results;
+
+    // Writes the shard manifest unless it is already there; returns true if the shard is done
+    bool prepareShard(size_t shard);
+    bool runShards(std::ostream& stream);
+    // The options of the worker that its reports depend on, as command line arguments
+    std::vector<std::string> reportOptions() const;
+    // Returns the process ID of the worker, or -1 if it can't be started
+    int launchWorker(size_t shard, size_t attempt) const;
+    bool readResult(size_t shard);
+    void printReport(std::ostream& stream) const;
+};
+
+
+#endif //COMPUTERCLUB_BATCHRUNNER_H
@@ -0,0 +1,91 @@
+#include "ClubScheduler.h"
+#include "TextFormat.h"
+#include <algorithm>
+#include <queue>
+#include <thread>
+
+size_t ClubScheduler::AddClub(InputFileData inputFileData) {
+    _clubs.push_back(std::make_unique<Club>(std::move(inputFileData)));
+    return _clubs.size() - 1;
+}
+
+void ClubScheduler::Run() {
+    size_t numberOfThreads = std::min(_numberOfThreads, _clubs.size());
+    if (numberOfThreads <= 1) {
+        runShard(0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> exceptions(numberOfThreads);
+    std::vector<std::thread> threads;
+
+    for (size_t shard = 0; shard < numberOfThreads; shard++) {
+        threads.emplace_back([this, shard, &exceptions]() {
+            try {
+                runShard(shard);
+            } catch (...) {
+                exceptions[shard] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& exception : exceptions) {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+}
+
+ClubTask ClubScheduler::runClub(Club& club) {
+    auto& [eventHandler, result] = club;
+
+    if (!eventHandler.Start(result.output, result.error, result.tables))
+        co_return;
+
+    for (size_t eventNumber = 0; eventNumber < eventHandler.numberOfEvents(); eventNumber++) {
+        co_yield eventHandler.eventTime(eventNumber);
+        eventHandler.HandleEvent(eventNumber, result.output, result.tables);
+    }
+
+    co_yield eventHandler.computerClubFeatures().closingTime;
+    eventHandler.Finish(result.output, result.tables);
+
+    appendTablesReport(result.output, result.tables);
+}
+
+void ClubScheduler::runShard(size_t shard) {
+    size_t numberOfShards = std::min(_numberOfThreads, _clubs.size());
+
+    struct Waiting {
+        uint16_t eventTime;
+        size_t task;
+
+        // std::priority_queue is a max-heap; ties go to the club added first
+        bool operator<(const Waiting& waiting) const {
+            return eventTime != waiting.eventTime ? eventTime > waiting.eventTime : task > waiting.task;
+        }
+    };
+
+    std::vector<ClubTask> tasks;
+    std::vector<Waiting> heapStorage;
+    tasks.reserve(_clubs.size() / numberOfShards + 1);
+    heapStorage.reserve(tasks.capacity());
+
+    std::priority_queue<Waiting> timeline({}, std::move(heapStorage));
+
+    for (size_t club = shard; club < _clubs.size(); club += numberOfShards) {
+        tasks.push_back(runClub(*_clubs[club]));
+        if (tasks.back().Resume())
+            timeline.push({ tasks.back().nextEventTime().toMinutes(), tasks.size() - 1 });
+    }
+
+    while (!timeline.empty()) {
+        size_t task = timeline.top().task;
+        timeline.pop();
+
+        if (tasks[task].Resume())
+            timeline.push({ tasks[task].nextEventTime().toMinutes(), task });
+    }
+}
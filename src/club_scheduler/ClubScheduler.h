@@ -0,0 +1,47 @@
+#ifndef COMPUTERCLUB_CLUBSCHEDULER_H
+#define COMPUTERCLUB_CLUBSCHEDULER_H
+
+#include "ClubTask.h"
+#include "EventHandler.h"
+#include <memory>
+
+struct ClubResult {
+    Error error;
+    Tables tables;
+    // The same report TaskSolver prints for this club
+    std::string output;
+};
+
+// Drives the working days of many clubs at once. Every club is a coroutine around its own EventHandler, and
+// the clubs of a thread are merged into one timeline with a min-heap on the time of their next event.
+// Clubs don't share any state, so they are spread over the threads round-robin and each thread keeps its own
+// timeline.
+class ClubScheduler {
+public:
+    explicit ClubScheduler(size_t numberOfThreads = 1) : _numberOfThreads(numberOfThreads ? numberOfThreads : 1) { }
+
+    // Returns the index of the club's result
+    size_t AddClub(InputFileData inputFileData);
+
+    void Run();
+
+    size_t numberOfClubs() const { return _clubs.size(); }
+    const ClubResult& result(size_t club) const { return _clubs.at(club)->result; }
+
+private:
+    struct Club {
+        explicit Club(InputFileData inputFileData) : eventHandler(std::move(inputFileData)) { }
+
+        EventHandler eventHandler;
+        ClubResult result;
+    };
+
+    size_t _numberOfThreads;
+    std::vector<std::unique_ptr<Club>> _clubs;
+
+    static ClubTask runClub(Club& club);
+    void runShard(size_t shard);
+};
+
+
+#endif //COMPUTERCLUB_CLUBSCHEDULER_H
@@ -0,0 +1,93 @@
+#ifndef COMPUTERCLUB_CLUBTASK_H
+#define COMPUTERCLUB_CLUBTASK_H
+
+#include "InputFileData.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Coroutine of a single club: it yields the time of its next event and is resumed when that time comes
+// on the scheduler's timeline
+class ClubTask {
+public:
+    struct FrameCounter {
+        std::atomic<size_t> allocatedBytes{0};
+        std::atomic<size_t> peakBytes{0};
+
+        void Add(size_t size) {
+            size_t allocated = allocatedBytes.fetch_add(size, std::memory_order_relaxed) + size;
+            size_t peak = peakBytes.load(std::memory_order_relaxed);
+            while (peak < allocated && !peakBytes.compare_exchange_weak(peak, allocated)) { }
+        }
+
+        void Remove(size_t size) { allocatedBytes.fetch_sub(size, std::memory_order_relaxed); }
+    };
+
+    struct promise_type {
+        Time nextEventTime;
+        std::exception_ptr exception;
+
+        // Counts the coroutine frames of all clubs while it is set, to keep an eye on the memory cost of one club.
+        // Set by the ManyClubs benchmark only, before the clubs are added and until they are all gone, so that
+        // the frames of an ordinary run cost a single check.
+        static inline FrameCounter* frameCounter{nullptr};
+
+        static void* operator new(size_t size) {
+            if (frameCounter)
+                frameCounter->Add(size);
+
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* pointer, size_t size) {
+            if (frameCounter)
+                frameCounter->Remove(size);
+
+            ::operator delete(pointer);
+        }
+
+        ClubTask get_return_object() { return ClubTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const Time& eventTime) noexcept {
+            nextEventTime = eventTime;
+            return {};
+        }
+
+        void return_void() noexcept { }
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    ClubTask(ClubTask&& task) noexcept : _handle(std::exchange(task._handle, {})) { }
+    ClubTask& operator=(ClubTask&& task) noexcept {
+        std::swap(_handle, task._handle);
+        return *this;
+    }
+
+    ~ClubTask() {
+        if (_handle)
+            _handle.destroy();
+    }
+
+    // Runs the club up to its next event; returns false once the club is done
+    bool Resume() {
+        _handle.resume();
+        if (_handle.promise().exception)
+            std::rethrow_exception(_handle.promise().exception);
+
+        return !_handle.done();
+    }
+
+    const Time& nextEventTime() const { return _handle.promise().nextEventTime; }
+
+private:
+    explicit ClubTask(std::coroutine_handle<promise_type> handle) : _handle(handle) { }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+
+#endif //COMPUTERCLUB_CLUBTASK_H
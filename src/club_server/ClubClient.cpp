@@ -0,0 +1,53 @@
+#include "ClubClient.h"
+#include "ClubServer.h"
+#include "SocketIO.h"
+#include <charconv>
+#include <system_error>
+
+int ClubClient::RunFile(const std::string& socketPath, const std::string& fileName, std::string& report) {
+    return request(socketPath, std::string(ClubServer::PATH_REQUEST).append(" ").append(fileName), {}, report);
+}
+
+int ClubClient::RunContent(const std::string& socketPath, std::string_view content, std::string& report) {
+    return request(socketPath, std::string(ClubServer::CONTENT_REQUEST).append(" ")
+                               .append(std::to_string(content.size())), content, report);
+}
+
+int ClubClient::request(const std::string& socketPath, std::string_view requestLine, std::string_view content,
+                        std::string& report)
+{
+    sockaddr_un address{};
+    if (!makeSocketAddress(socketPath, address))
+        throw std::system_error(ENAMETOOLONG, std::generic_category(), socketPath);
+
+    int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connection < 0 || connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        int error = errno;
+        if (connection >= 0)
+            close(connection);
+        throw std::system_error(error, std::generic_category(), socketPath);
+    }
+
+    std::string buffer, responseLine;
+    bool isSent = sendAll(connection, std::string(requestLine).append("\n")) && sendAll(connection, content);
+    bool isReceived = isSent && receiveLine(connection, buffer, responseLine, ClubServer::MAX_REQUEST_LINE_LENGTH);
+
+    int exitCode = 0;
+    size_t length = 0;
+    size_t delimiterPos = responseLine.find(' ');
+
+    if (isReceived && delimiterPos != std::string::npos) {
+        std::from_chars(responseLine.data(), responseLine.data() + delimiterPos, exitCode);
+        std::from_chars(responseLine.data() + delimiterPos + 1, responseLine.data() + responseLine.size(), length);
+        isReceived = receiveExactly(connection, buffer, length);
+    } else {
+        isReceived = false;
+    }
+
+    close(connection);
+    if (!isReceived)
+        throw std::system_error(ECONNRESET, std::generic_category(), socketPath);
+
+    report = std::move(buffer);
+    return exitCode;
+}
@@ -0,0 +1,20 @@
+#ifndef COMPUTERCLUB_CLUBCLIENT_H
+#define COMPUTERCLUB_CLUBCLIENT_H
+
+#include <string>
+#include <string_view>
+
+// Client side of the ClubServer protocol. Both calls return the exit code the command line run would have and
+// put its output into report; a server that can't be reached throws std::system_error.
+class ClubClient {
+public:
+    static int RunFile(const std::string& socketPath, const std::string& fileName, std::string& report);
+    static int RunContent(const std::string& socketPath, std::string_view content, std::string& report);
+
+private:
+    static int request(const std::string& socketPath, std::string_view requestLine, std::string_view content,
+                       std::string& report);
+};
+
+
+#endif //COMPUTERCLUB_CLUBCLIENT_H
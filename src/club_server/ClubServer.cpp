@@ -0,0 +1,245 @@
+#include "ClubServer.h"
+#include "SocketIO.h"
+#include "TaskSolver.h"
+#include "TextFormat.h"
+#include <algorithm>
+#include <charconv>
+#include <csignal>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool parseLength(std::string_view requestLine, size_t& length) {
+    requestLine.remove_prefix(ClubServer::CONTENT_REQUEST.size());
+    if (requestLine.size() < 2 || requestLine.front() != ' ')
+        return false;
+
+    auto [ptr, ec] = std::from_chars(requestLine.data() + 1, requestLine.data() + requestLine.size(), length);
+    return ec == std::errc() && ptr == requestLine.data() + requestLine.size() &&
+           length <= ClubServer::MAX_CONTENT_LENGTH;
+}
+
+}
+
+ClubServer::ClubServer(std::string socketPath, size_t numberOfWorkers, RunOptions runOptions,
+                       ResultCache* resultCache, const std::string& pathRoot,
+                       std::chrono::milliseconds requestTimeout)
+                      : _socketPath(std::move(socketPath)), _numberOfWorkers(numberOfWorkers), _runOptions(runOptions),
+                        _resultCache(resultCache), _requestTimeout(requestTimeout)
+{
+    if (!pathRoot.empty())
+        _pathRoot = fs::weakly_canonical(fs::absolute(pathRoot));
+}
+
+ClubServer::~ClubServer() {
+    Stop();
+}
+
+bool ClubServer::Start() {
+    sockaddr_un address{};
+    if (!makeSocketAddress(_socketPath, address))
+        return false;
+
+    struct stat status{};
+    if (lstat(_socketPath.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode) || unlink(_socketPath.c_str()) < 0)
+            return false;
+    } else if (errno != ENOENT) {
+        return false;
+    }
+
+    _listeningSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_listeningSocket < 0)
+        return false;
+
+    if (bind(_listeningSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        lstat(_socketPath.c_str(), &status) < 0 || listen(_listeningSocket, SOMAXCONN) < 0)
+    {
+        close(_listeningSocket);
+        _listeningSocket = -1;
+        return false;
+    }
+
+    _socketDevice = status.st_dev;
+    _socketInode = status.st_ino;
+
+    _isStopped = false;
+    for (size_t worker = 0; worker < _numberOfWorkers; worker++)
+        _workers.emplace_back(&ClubServer::serveConnections, this);
+    _acceptor = std::thread(&ClubServer::acceptConnections, this);
+
+    return true;
+}
+
+void ClubServer::Stop() {
+    if (_listeningSocket < 0)
+        return;
+
+    {
+        std::lock_guard lock(_mutex);
+        _isStopped = true;
+    }
+    _condition.notify_all();
+    _acceptorCondition.notify_all();
+
+    // Wakes up the blocked accept
+    shutdown(_listeningSocket, SHUT_RDWR);
+    _acceptor.join();
+
+    for (auto& worker : _workers)
+        worker.join();
+    _workers.clear();
+
+    close(_listeningSocket);
+    _listeningSocket = -1;
+    if (isBoundSocket())
+        unlink(_socketPath.c_str());
+}
+
+int ClubServer::Serve() {
+    // Blocked before any thread starts, so that only sigwait below receives them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    if (!Start()) {
+        std::cout << _socketPath << std::endl;
+        std::cout << "The socket can't be bound!" << std::endl;
+        return static_cast<int>(ErrorType::FileIsNotOpen);
+    }
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+
+    Stop();
+    return static_cast<int>(ErrorType::Success);
+}
+
+void ClubServer::acceptConnections() {
+    while (true) {
+        {
+            std::unique_lock lock(_mutex);
+            _acceptorCondition.wait(lock, [this]() {
+                return _isStopped || _connections.size() < MAX_QUEUED_CONNECTIONS;
+            });
+            if (_isStopped)
+                return;
+        }
+
+        int connection = accept4(_listeningSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        int error = errno;
+
+        std::unique_lock lock(_mutex);
+        if (_isStopped) {
+            if (connection >= 0)
+                close(connection);
+            return;
+        }
+
+        if (connection >= 0) {
+            // A client that doesn't read its response can't hold a worker for longer than this either
+            timeval timeout{ static_cast<time_t>(_requestTimeout.count() / 1000),
+                             static_cast<suseconds_t>(_requestTimeout.count() % 1000 * 1000) };
+            setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+            _connections.push_back(connection);
+            _condition.notify_one();
+        } else if (error != EINTR && error != ECONNABORTED) {
+            // Accepting again at once would fail the same way until, e.g., some connection is closed
+            _acceptorCondition.wait_for(lock, ACCEPT_RETRY_DELAY, [this]() { return _isStopped; });
+        }
+    }
+}
+
+void ClubServer::serveConnections() {
+    TaskSolver taskSolver(nullptr, _runOptions, _resultCache);
+    std::string buffer;
+    std::ostringstream report;
+
+    while (true) {
+        int connection;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this]() { return _isStopped || !_connections.empty(); });
+            if (_connections.empty())
+                return;
+
+            connection = _connections.front();
+            _connections.pop_front();
+        }
+        _acceptorCondition.notify_one();
+
+        serveConnection(connection, taskSolver, buffer, report);
+        close(connection);
+    }
+}
+
+void ClubServer::serveConnection(int connection, TaskSolver& taskSolver, std::string& buffer,
+                                 std::ostringstream& report)
+{
+    buffer.clear();
+    report.str({});
+
+    std::string requestLine;
+    int exitCode = static_cast<int>(ErrorType::IncorrectRequest);
+    auto deadline = std::chrono::steady_clock::now() + _requestTimeout;
+
+    try {
+        size_t length = 0;
+
+        if (!receiveLine(connection, buffer, requestLine, MAX_REQUEST_LINE_LENGTH, deadline)) {
+            return;
+        } else if (requestLine.starts_with(PATH_REQUEST) && requestLine.size() > PATH_REQUEST.size() + 1 &&
+                   requestLine[PATH_REQUEST.size()] == ' ')
+        {
+            std::string fileName = requestLine.substr(PATH_REQUEST.size() + 1);
+            if (isInsidePathRoot(fileName))
+                exitCode = taskSolver.run(fileName, report);
+            else
+                report << fileName << std::endl << "The file is outside of the served directory!" << std::endl;
+        } else if (requestLine.starts_with(CONTENT_REQUEST) && parseLength(requestLine, length)) {
+            if (!receiveExactly(connection, buffer, length, deadline))
+                return;
+
+            exitCode = taskSolver.runContent(buffer, report);
+        } else {
+            report << requestLine << std::endl << "The request is incorrect!" << std::endl;
+        }
+    } catch (const std::exception& exception) {
+        report << "Caught an unexpected exception: " << exception.what() << std::endl;
+        exitCode = static_cast<int>(ErrorType::UnexpectedError);
+    }
+
+    std::string body = report.str();
+    std::string response = std::to_string(exitCode);
+    response.push_back(' ');
+    appendNumber(response, body.size());
+    response.push_back('\n');
+
+    sendAll(connection, response) && sendAll(connection, body);
+}
+
+// Links and ".." are resolved first, so neither of them leads out of the root
+bool ClubServer::isInsidePathRoot(const std::string& fileName) const {
+    if (_pathRoot.empty())
+        return true;
+
+    std::error_code errorCode;
+    auto path = fs::weakly_canonical(fs::absolute(fileName, errorCode), errorCode);
+    if (errorCode)
+        return false;
+
+    auto [rootEnd, pathEnd] = std::mismatch(_pathRoot.begin(), _pathRoot.end(), path.begin(), path.end());
+    return rootEnd == _pathRoot.end() && pathEnd != path.end();
+}
+
+bool ClubServer::isBoundSocket() const {
+    struct stat status{};
+    return lstat(_socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode) &&
+           status.st_dev == _socketDevice && status.st_ino == _socketInode;
+}
@@ -0,0 +1,91 @@
+#ifndef COMPUTERCLUB_CLUBSERVER_H
+#define COMPUTERCLUB_CLUBSERVER_H
+
+#include "RunOptions.h"
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+class ResultCache;
+class TaskSolver;
+
+// Long-running form of the program behind a Unix domain socket. One request per connection:
+//   "PATH <path_to_txt_file>\n"  or  "CONTENT <length>\n" followed by <length> bytes of the log.
+// The response is "<exit code> <length>\n" followed by <length> bytes of exactly what a command line run
+// prints. A fixed pool of workers serves the connections, and every worker keeps one TaskSolver, so the
+// buffers of a request are reused by the next one.
+// Whoever may connect to the socket, which its file permissions decide, may make the server read any .txt file
+// the server itself can read and get its first line back in an error message; with a path root, PATH is only
+// served for files inside of it. A connection that hasn't sent its whole request within the request timeout is
+// closed unanswered, so idle clients hold a worker for no longer than that.
+class ClubServer {
+public:
+    static constexpr std::string_view PATH_REQUEST = "PATH";
+    static constexpr std::string_view CONTENT_REQUEST = "CONTENT";
+    static constexpr size_t MAX_REQUEST_LINE_LENGTH = 4096;
+    // Larger content is refused before it is read, so that a single request can't take all the memory
+    static constexpr size_t MAX_CONTENT_LENGTH = size_t{256} << 20;
+    // Accepted connections no worker has taken yet; the others wait in the backlog of the socket
+    static constexpr size_t MAX_QUEUED_CONNECTIONS = 1024;
+    // How long accepting pauses after an error that doesn't go away by itself, e.g. too many open files
+    static constexpr std::chrono::milliseconds ACCEPT_RETRY_DELAY{100};
+    // From the moment a worker takes the connection; sending the response may take as long again
+    static constexpr std::chrono::milliseconds REQUEST_TIMEOUT{5000};
+
+    ClubServer(std::string socketPath, size_t numberOfWorkers, RunOptions runOptions,
+               ResultCache* resultCache = nullptr, const std::string& pathRoot = {},
+               std::chrono::milliseconds requestTimeout = REQUEST_TIMEOUT);
+    ~ClubServer();
+
+    ClubServer(const ClubServer&) = delete;
+    ClubServer& operator=(const ClubServer&) = delete;
+
+    // Binds the socket and starts accepting; returns false if the socket can't be bound. A socket left at the path
+    // by an earlier run is replaced, but anything else there is not touched.
+    bool Start();
+
+    // Stops accepting, serves the connections already accepted and removes the socket, unless it has been replaced
+    void Stop();
+
+    // Start, then serve until SIGINT or SIGTERM. Returns the exit code of the program.
+    int Serve();
+
+private:
+    std::string _socketPath;
+    size_t _numberOfWorkers;
+    RunOptions _runOptions;
+    ResultCache* _resultCache;
+    // Empty serves PATH for any file
+    std::filesystem::path _pathRoot;
+    std::chrono::milliseconds _requestTimeout;
+
+    int _listeningSocket{-1};
+    // The file of the bound socket, so that only that one is removed
+    dev_t _socketDevice{};
+    ino_t _socketInode{};
+    bool _isStopped{false};
+    std::deque<int> _connections;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    // Wakes up the acceptor when the queue has room again or the server stops
+    std::condition_variable _acceptorCondition;
+    std::thread _acceptor;
+    std::vector<std::thread> _workers;
+
+    void acceptConnections();
+    void serveConnections();
+    void serveConnection(int connection, TaskSolver& taskSolver, std::string& buffer, std::ostringstream& report);
+    bool isInsidePathRoot(const std::string& fileName) const;
+    bool isBoundSocket() const;
+};
+
+
+#endif //COMPUTERCLUB_CLUBSERVER_H
@@ -0,0 +1,115 @@
+#ifndef COMPUTERCLUB_SOCKETIO_H
+#define COMPUTERCLUB_SOCKETIO_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Blocking helpers shared by the server and the client side of the protocol
+
+using SocketDeadline = std::chrono::steady_clock::time_point;
+inline constexpr SocketDeadline NO_DEADLINE = SocketDeadline::max();
+
+// Waits for something to read; false once the deadline has passed
+inline bool waitForData(int socket, SocketDeadline deadline) {
+    if (deadline == NO_DEADLINE)
+        return true;
+
+    while (true) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+            return false;
+
+        int timeout = static_cast<int>(std::min<std::chrono::milliseconds::rep>(remaining.count(), INT_MAX));
+        pollfd descriptor{ socket, POLLIN, 0 };
+        int ready = poll(&descriptor, 1, timeout);
+        if (ready < 0 && errno == EINTR)
+            continue;
+
+        return ready > 0;
+    }
+}
+
+inline bool makeSocketAddress(const std::string& socketPath, sockaddr_un& address) {
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+        return false;
+
+    socketPath.copy(address.sun_path, socketPath.size());
+    return true;
+}
+
+inline bool sendAll(int socket, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t sent = send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+
+    return true;
+}
+
+// Reads up to the first line break; whatever arrives after it is left in buffer
+inline bool receiveLine(int socket, std::string& buffer, std::string& line, size_t maxLength,
+                        SocketDeadline deadline = NO_DEADLINE)
+{
+    size_t pos;
+    while ((pos = buffer.find('\n')) == std::string::npos) {
+        if (buffer.size() > maxLength)
+            return false;
+
+        char chunk[4096];
+        if (!waitForData(socket, deadline))
+            return false;
+
+        ssize_t received = recv(socket, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+
+    line.assign(buffer, 0, pos);
+    buffer.erase(0, pos + 1);
+    return true;
+}
+
+// Tops buffer up to exactly length bytes
+inline bool receiveExactly(int socket, std::string& buffer, size_t length, SocketDeadline deadline = NO_DEADLINE) {
+    if (buffer.size() > length)
+        return false;
+
+    size_t size = buffer.size();
+    buffer.resize(length);
+
+    while (size < length) {
+        if (!waitForData(socket, deadline))
+            return false;
+
+        ssize_t received = recv(socket, buffer.data() + size, length - size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+
+        size += static_cast<size_t>(received);
+    }
+
+    return true;
+}
+
+#endif //COMPUTERCLUB_SOCKETIO_H
@@ -0,0 +1,145 @@
+#include "CommandLine.h"
+#include "Constants.h"
+#include "TextParsing.h"
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+void CommandLine::Parse(int argc, char** argv, CommandLineOptions& options, Error& error) {
+    using OptionParser = std::function<bool(std::string_view)>;
+
+    const std::unordered_map<std::string_view, OptionParser> optionParsers = {
+        { "--threads", [&options](std::string_view value) {
+            return parsePositiveNumber(value, options.runOptions.numberOfThreads) &&
+                   options.runOptions.numberOfThreads <= RunOptions::MAX_NUMBER_OF_THREADS;
+        }},
+        { "--reorder-window", [&options](std::string_view value) {
+            size_t windowMinutes;
+            if (!parsePositiveNumber(value, windowMinutes) || windowMinutes >= 24 * MINUTES_IN_HOUR)
+                return false;
+
+            options.runOptions.reorderWindowMinutes = static_cast<uint16_t>(windowMinutes);
+            return true;
+        }},
+        { "--format", [&options](std::string_view value) {
+            const std::unordered_map<std::string_view, OutputFormat> formats = {
+                { "text", OutputFormat::Text }, { "jsonl", OutputFormat::JsonLines }, { "csv", OutputFormat::Csv },
+            };
+
+            auto format = formats.find(value);
+            if (format == formats.end())
+                return false;
+
+            options.runOptions.outputFormat = format->second;
+            return true;
+        }},
+        { "--sections", [&options](std::string_view value) {
+            // A comma-separated list of sections, each at most once
+            ReportSections sections{ false, false, false, false };
+            const std::unordered_map<std::string_view, bool ReportSections::*> sectionFields = {
+                { "echo", &ReportSections::echo }, { "events", &ReportSections::events },
+                { "tables", &ReportSections::tables }, { "totals", &ReportSections::totals },
+            };
+
+            for (size_t begin = 0; begin <= value.size(); ) {
+                size_t end = std::min(value.find(',', begin), value.size());
+                auto field = sectionFields.find(value.substr(begin, end - begin));
+                if (field == sectionFields.end() || sections.*field->second)
+                    return false;
+
+                sections.*field->second = true;
+                begin = end + 1;
+            }
+
+            options.runOptions.reportSections = sections;
+            return true;
+        }},
+        { "--serve", [&options](std::string_view value) {
+            options.serveSocketPath = value;
+            return !value.empty();
+        }},
+        { "--path-root", [&options](std::string_view value) {
+            options.pathRoot = value;
+            return !value.empty();
+        }},
+        { "--workers", [&options](std::string_view value) {
+            return parsePositiveNumber(value, options.numberOfWorkers);
+        }},
+        { "--cache", [&options](std::string_view value) {
+            options.cacheDirectory = value;
+            return !value.empty();
+        }},
+        { "--cache-size", [&options](std::string_view value) {
+            return parsePositiveNumber(value, options.cacheSizeMiB);
+        }},
+        { "--perf-stats", [&options](std::string_view value) {
+            options.perfStatsPath = value;
+            return !value.empty();
+        }},
+        { "--ledger", [&options](std::string_view value) {
+            options.ledgerPath = value;
+            return !value.empty();
+        }},
+        { "--ledger-format", [&options](std::string_view value) {
+            options.isLedgerCsv = value == "csv";
+            return value == "csv" || value == "columnar";
+        }},
+        { "--build-index", [&options](std::string_view value) {
+            return parsePositiveNumber(value, options.indexCheckpointInterval);
+        }},
+        { "--as-of", [&options](std::string_view value) {
+            options.hasAsOfTime = true;
+            return parseTime(value, options.asOfTime);
+        }},
+        { "--batch", [&options](std::string_view value) {
+            options.batchManifestPath = value;
+            return !value.empty();
+        }},
+        { "--work-dir", [&options](std::string_view value) {
+            options.workDirectory = value;
+            return !value.empty();
+        }},
+        { "--shards", [&options](std::string_view value) {
+            return parsePositiveNumber(value, options.numberOfShards);
+        }},
+        { "--retries", [&options](std::string_view value) {
+            // Unlike the other numbers 0 makes sense here
+            if (value == "0") {
+                options.numberOfRetries = 0;
+                return true;
+            }
+
+            return parsePositiveNumber(value, options.numberOfRetries);
+        }},
+        { "--worker-command", [&options](std::string_view value) {
+            options.workerCommand = value;
+            return !value.empty();
+        }},
+        { "--batch-shard", [&options](std::string_view value) {
+            options.shardManifestPath = value;
+            return !value.empty();
+        }},
+        { "--shard-result", [&options](std::string_view value) {
+            options.shardResultPath = value;
+            return !value.empty();
+        }},
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument = argv[i];
+
+        if (!argument.starts_with("--")) {
+            options.fileNames.emplace_back(argument);
+            continue;
+        }
+
+        auto option = optionParsers.find(argument);
+        if (option == optionParsers.end() || i + 1 == argc || !option->second(argv[i + 1])) {
+            error = { ErrorType::IncorrectCommandLineOption, std::string(argument) };
+            return;
+        }
+
+        i++;
+    }
+}
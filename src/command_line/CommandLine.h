@@ -0,0 +1,61 @@
+#ifndef COMPUTERCLUB_COMMANDLINE_H
+#define COMPUTERCLUB_COMMANDLINE_H
+
+#include "InputFileData.h"
+#include "RunOptions.h"
+
+struct CommandLineOptions {
+    RunOptions runOptions;
+    std::vector<std::string> fileNames;
+
+    // Serve requests on a Unix domain socket instead of handling fileNames
+    std::string serveSocketPath;
+    size_t numberOfWorkers{4};
+    // Serve PATH requests only for files inside this directory
+    std::string pathRoot;
+
+    // Answer unchanged files from a result cache in this directory
+    std::string cacheDirectory;
+    size_t cacheSizeMiB{256};
+
+    // Write per-phase hardware counters as JSON to this file, "-" for stderr
+    std::string perfStatsPath;
+
+    // Write a record per visit of a client to this file, see SessionLedger
+    std::string ledgerPath;
+    bool isLedgerCsv{};
+
+    // Write a time index with a checkpoint every indexCheckpointInterval events, then answer asOfTime from it
+    size_t indexCheckpointInterval{};
+    bool hasAsOfTime{};
+    Time asOfTime;
+
+    // Reprocess the logs of a manifest with worker processes, see BatchRunner
+    std::string batchManifestPath;
+    std::string workDirectory;
+    size_t numberOfShards{};
+    size_t numberOfRetries{2};
+    std::string workerCommand;
+    // The worker of one shard
+    std::string shardManifestPath;
+    std::string shardResultPath;
+};
+
+// YadroComputerClub [--threads <N>] [--reorder-window <minutes>] [--cache <directory> [--cache-size <MiB>]]
+//                   [--perf-stats <path>] [--format text|jsonl|csv] [--sections <section>,...]
+//                   [--ledger <path> [--ledger-format columnar|csv]] <path_to_txt_file>
+// YadroComputerClub [--reorder-window <minutes>] [--format text|jsonl|csv] [--sections <section>,...]
+//                   [--ledger <path> [--ledger-format columnar|csv]] <path_to_txt_file> <path_to_txt_file>...
+// YadroComputerClub [--build-index <K>] [--as-of <HH:MM>] <path_to_txt_file>
+// YadroComputerClub --serve <socket_path> [--workers <N>] [--threads <N>] [--cache <directory> [--cache-size <MiB>]]
+//                   [--path-root <directory>]
+// YadroComputerClub --batch <manifest> --work-dir <directory> [--workers <N>] [--shards <N>] [--retries <N>]
+//                   [--worker-command <template>] [--threads <N>] [--reorder-window <minutes>]
+// YadroComputerClub --batch-shard <shard_manifest> --shard-result <path> [--threads <N>] [--reorder-window <minutes>]
+class CommandLine {
+public:
+    static void Parse(int argc, char** argv, CommandLineOptions& options, Error& error);
+};
+
+
+#endif //COMPUTERCLUB_COMMANDLINE_H
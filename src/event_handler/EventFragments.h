@@ -0,0 +1,74 @@
+#ifndef COMPUTERCLUB_EVENTFRAGMENTS_H
+#define COMPUTERCLUB_EVENTFRAGMENTS_H
+
+#include "Constants.h"
+#include "InputFileData.h"
+#include <array>
+#include <string_view>
+
+// Parts of outgoing event lines that follow the event time (e.g. " 13 NotOpenYet"), assembled at compile time
+namespace EventFragments {
+
+inline constexpr std::string_view NO_TEXT;
+
+// A fragment together with what it is made of, for the records of the event (see RecordFormat.h)
+struct FragmentParts {
+    std::string_view line;
+    OutgoingEventID eventId;
+    std::string_view text;
+};
+
+template <size_t Length>
+struct Fragment {
+    std::array<char, Length> bytes{};
+    OutgoingEventID eventId{};
+    std::string_view text;
+
+    constexpr std::string_view view() const { return { bytes.data(), bytes.size() }; }
+    constexpr FragmentParts parts() const { return { view(), eventId, text }; }
+};
+
+constexpr size_t countDigits(size_t number) {
+    size_t digits = 1;
+    for (; number >= 10; number /= 10)
+        digits++;
+
+    return digits;
+}
+
+template <OutgoingEventID eventId, const std::string_view& text>
+constexpr auto makeFragment() {
+    constexpr size_t id = static_cast<size_t>(eventId);
+    constexpr size_t idLength = countDigits(id);
+
+    Fragment<idLength + text.size() + 2> fragment{ {}, eventId, text };
+    fragment.bytes[0] = WORD_DELIMITER;
+
+    size_t number = id;
+    for (size_t i = idLength; i > 0; i--, number /= 10)
+        fragment.bytes[i] = static_cast<char>('0' + number % 10);
+
+    fragment.bytes[idLength + 1] = WORD_DELIMITER;
+    for (size_t i = 0; i < text.size(); i++)
+        fragment.bytes[idLength + 2 + i] = text[i];
+
+    return fragment;
+}
+
+inline constexpr auto CLIENT_HAS_GONE_AWAY = makeFragment<OutgoingEventID::ClientHasGoneAway, NO_TEXT>();
+inline constexpr auto CLIENT_HAS_SAT_DOWN = makeFragment<OutgoingEventID::ClientHasSatDownAtTheTable, NO_TEXT>();
+
+inline constexpr auto NOT_OPEN_YET = makeFragment<OutgoingEventID::Error, ERROR1>();
+inline constexpr auto YOU_SHALL_NOT_PASS = makeFragment<OutgoingEventID::Error, ERROR2>();
+inline constexpr auto CLIENT_UNKNOWN = makeFragment<OutgoingEventID::Error, ERROR3>();
+inline constexpr auto PLACE_IS_BUSY = makeFragment<OutgoingEventID::Error, ERROR4>();
+inline constexpr auto I_CAN_WAIT_NO_LONGER = makeFragment<OutgoingEventID::Error, ERROR5>();
+inline constexpr auto CLIENT_HAS_ALREADY_SAT_DOWN = makeFragment<OutgoingEventID::Error, ERROR6>();
+inline constexpr auto CLIENT_IS_ALREADY_WAITING = makeFragment<OutgoingEventID::Error, ERROR7>();
+
+static_assert(NOT_OPEN_YET.view() == " 13 NotOpenYet");
+static_assert(CLIENT_HAS_GONE_AWAY.view() == " 11 ");
+
+}
+
+#endif //COMPUTERCLUB_EVENTFRAGMENTS_H
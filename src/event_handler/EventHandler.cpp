@@ -1,46 +1,170 @@
 #include "EventHandler.h"
 #include "Constants.h"
+#include "EventFragments.h"
+#include "LiveSnapshot.h"
+#include "RecordFormat.h"
+#include "ReorderBuffer.h"
+#include "SessionLedger.h"
+#include "TextFormat.h"
 #include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
-void EventHandler::HandleEventsOfTheDay(std::vector<std::string>& outputData, Error& error,
-                                        std::vector<Table>& tables)
-{
-    if (!isCorrectInputFileData(error))
+void EventHandler::HandleEventsOfTheDay(std::string& output, Error& error, Tables& tables) {
+    if (!Start(output, error, tables))
         return;
 
-    tables.resize(_inputFileData.computerClubFeatures.numberOfTables);
-    for (auto& table : tables)
-        table = {{ 0, 0 }, { 0, 0 }, 0, false};
-
-    outputData.push_back(_inputFileData.computerClubFeatures.openingTime.toString());
-
-    size_t counter = 0;
-    for (const auto& event: _inputFileData.computerClubEvents) {
-        switch (event.eventId) {
-            case IncomingEventID::ClientHasCome:
-                outputData.push_back(_inputFileData.initialEvents[counter]);
-                handleFirstEvent(event, outputData);
-                break;
-            case IncomingEventID::ClientHasSatDownAtTheTable:
-                outputData.push_back(_inputFileData.initialEvents[counter]);
-                handleSecondEvent(event, outputData, tables);
-                break;
-            case IncomingEventID::ClientIsWaiting:
-                outputData.push_back(_inputFileData.initialEvents[counter]);
-                handleThirdEvent(event, outputData, tables);
-                break;
-            default:
-                outputData.push_back(_inputFileData.initialEvents[counter]);
-                handleFourthEvent(event, outputData, tables);
-                break;
+    for (size_t eventNumber = 0; eventNumber < numberOfEvents(); eventNumber++)
+        HandleEvent(eventNumber, output, tables);
+
+    Finish(output, tables);
+}
+
+void EventHandler::HandleEventsOfTheDayReordered(std::string& output, Error& error, Tables& tables,
+                                                 uint16_t windowMinutes)
+{
+    Open(output, tables);
+
+    ReorderBuffer reorderBuffer(windowMinutes);
+    uint64_t nextEventNumber;
+
+    for (size_t eventNumber = 0; eventNumber < numberOfEvents(); eventNumber++) {
+        if (!reorderBuffer.Push(eventTime(eventNumber))) {
+            error = { ErrorType::IncorrectEventTimeSequence, _inputFileData.initialEvents[eventNumber] };
+            return;
         }
 
-        counter++;
+        while (reorderBuffer.Pop(nextEventNumber))
+            HandleEvent(nextEventNumber, output, tables);
     }
 
-    closeTheClub(outputData, tables);
+    while (reorderBuffer.Pop(nextEventNumber, true))
+        HandleEvent(nextEventNumber, output, tables);
+
+    Finish(output, tables);
+}
+
+void EventHandler::PublishTo(LiveSnapshot* liveSnapshot) {
+    if (liveSnapshot && liveSnapshot->numberOfTables() != _inputFileData.computerClubFeatures.numberOfTables)
+        throw std::invalid_argument("The live snapshot is made for another number of tables");
+
+    _liveSnapshot = liveSnapshot;
+}
+
+void EventHandler::HandleEventsOfTheDayInParallel(std::string& output, Error& error, Tables& tables,
+                                                  size_t numberOfThreads)
+{
+    if (!Start(output, error, tables))
+        return;
+
+    // Segments are handled by EventHandlers of their own, which have nothing to publish or record to
+    bool isOnOneThread = _liveSnapshot || _sessionLedger;
+    auto segmentEnds = isOnOneThread ? std::vector<size_t>{}
+                                     : findSegmentEnds(std::min(numberOfThreads, RunOptions::MAX_NUMBER_OF_THREADS));
+    if (segmentEnds.size() <= 1) {
+        for (size_t eventNumber = 0; eventNumber < numberOfEvents(); eventNumber++)
+            HandleEvent(eventNumber, output, tables);
 
-    outputData.push_back(_inputFileData.computerClubFeatures.closingTime.toString());
+        Finish(output, tables);
+        return;
+    }
+
+    struct Segment {
+        EventHandler eventHandler;
+        std::string output;
+        Tables tables;
+    };
+
+    std::vector<Segment> segments;
+    size_t begin = 0;
+    for (size_t end : segmentEnds) {
+        segments.push_back({ takeSegment(begin, end), {}, {} });
+        begin = end;
+    }
+
+    std::vector<std::exception_ptr> exceptions(segments.size());
+    std::vector<std::thread> threads;
+
+    for (size_t number = 0; number < segments.size(); number++) {
+        threads.emplace_back([&segments, &exceptions, number]() {
+            auto& [eventHandler, segmentOutput, segmentTables] = segments[number];
+
+            try {
+                segmentTables.reset(eventHandler.computerClubFeatures().numberOfTables);
+                for (size_t eventNumber = 0; eventNumber < eventHandler.numberOfEvents(); eventNumber++)
+                    eventHandler.HandleEvent(eventNumber, segmentOutput, segmentTables);
+
+                // Clients left at closing time can only be in the last segment
+                if (number + 1 == segments.size())
+                    eventHandler.Finish(segmentOutput, segmentTables);
+            } catch (...) {
+                exceptions[number] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& exception : exceptions) {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    for (const auto& segment : segments) {
+        output.append(segment.output);
+
+        tables.addTotals(segment.tables);
+    }
+}
+
+bool EventHandler::Start(std::string& output, Error& error, Tables& tables) {
+    if (!isCorrectInputFileData(error))
+        return false;
+
+    Open(output, tables);
+    return true;
+}
+
+void EventHandler::Open(std::string& output, Tables& tables) {
+    tables.reset(_inputFileData.computerClubFeatures.numberOfTables);
+    if (_liveSnapshot)
+        _liveSnapshot->Clear(_inputFileData.computerClubFeatures.openingTime,
+                             _inputFileData.computerClubFeatures.costPerHour);
+    if (_sessionLedger)
+        _sessionLedger->Open(_inputFileData.computerClubFeatures.costPerHour);
+
+    if (_isEchoWritten || _areEventsWritten)
+        writeClubTime(output, _inputFileData.computerClubFeatures.openingTime, false);
+}
+
+void EventHandler::HandleEvent(size_t eventNumber, std::string& output, Tables& tables) {
+    HandleEvent(_inputFileData.computerClubEvents[eventNumber], _inputFileData.initialEvents[eventNumber], output,
+                tables);
+}
+
+void EventHandler::HandleEvent(const Event& event, std::string_view line, std::string& output, Tables& tables) {
+    if (_isEchoWritten)
+        writeIncomingEvent(output, event, line);
+    _numberOfChangedTables = 0;
+    (this->*EVENT_HANDLERS[static_cast<size_t>(event.eventId) - 1])(event, output, tables);
+
+    _numberOfHandledEvents++;
+    if (_liveSnapshot)
+        publishChangedTables(event.eventTime, tables);
+}
+
+void EventHandler::Finish(std::string& output, Tables& tables) {
+    closeTheClub(output, tables);
+    if (_liveSnapshot)
+        publishClosing(tables);
+    if (_sessionLedger)
+        _sessionLedger->Close();
+
+    if (_isEchoWritten || _areEventsWritten)
+        writeClubTime(output, _inputFileData.computerClubFeatures.closingTime, true);
 }
 
 bool EventHandler::isCorrectInputFileData(Error& error) {
@@ -53,6 +177,58 @@ bool EventHandler::isCorrectInputFileData(Error& error) {
     return true;
 }
 
+// Cuts after events at which the club is certainly empty. The occupancy pass only follows arrivals and
+// departures by name: it may see someone who has actually been turned away, but never misses a client who is
+// in the club, so an empty club here is empty in the real handling too (no clients, no queue, no busy tables).
+std::vector<size_t> EventHandler::findSegmentEnds(size_t numberOfSegments) const {
+    const auto& events = _inputFileData.computerClubEvents;
+    const size_t segmentSize = events.size() / numberOfSegments + 1;
+
+    std::vector<size_t> segmentEnds;
+    std::unordered_set<std::string_view> clientsInClub;
+
+    for (size_t eventNumber = 0; eventNumber < events.size(); eventNumber++) {
+        const auto& event = events[eventNumber];
+
+        if (event.eventId == IncomingEventID::ClientHasCome &&
+            event.eventTime.hours >= _inputFileData.computerClubFeatures.openingTime.hours)
+        {
+            clientsInClub.insert(event.eventBody);
+        } else if (event.eventId == IncomingEventID::ClientHasGoneAway) {
+            clientsInClub.erase(event.eventBody);
+        }
+
+        size_t segmentBegin = segmentEnds.empty() ? 0 : segmentEnds.back();
+        if (clientsInClub.empty() && eventNumber + 1 - segmentBegin >= segmentSize &&
+            eventNumber + 1 < events.size())
+        {
+            segmentEnds.push_back(eventNumber + 1);
+        }
+    }
+
+    segmentEnds.push_back(events.size());
+    return segmentEnds;
+}
+
+EventHandler EventHandler::takeSegment(size_t begin, size_t end) {
+    InputFileData segment;
+    segment.computerClubFeatures = _inputFileData.computerClubFeatures;
+
+    auto& events = _inputFileData.computerClubEvents;
+    auto& initialEvents = _inputFileData.initialEvents;
+    segment.computerClubEvents.assign(std::make_move_iterator(events.begin() + static_cast<ptrdiff_t>(begin)),
+                                      std::make_move_iterator(events.begin() + static_cast<ptrdiff_t>(end)));
+    segment.initialEvents.assign(std::make_move_iterator(initialEvents.begin() + static_cast<ptrdiff_t>(begin)),
+                                 std::make_move_iterator(initialEvents.begin() + static_cast<ptrdiff_t>(end)));
+
+    EventHandler eventHandler(std::move(segment));
+    eventHandler._isEchoWritten = _isEchoWritten;
+    eventHandler._areEventsWritten = _areEventsWritten;
+    eventHandler._outputFormat = _outputFormat;
+
+    return eventHandler;
+}
+
 bool EventHandler::isCorrectSequenceOfEventTimes(size_t& eventNumber) {
     for (size_t i = 0; i < _inputFileData.computerClubEvents.size() - 1; i++) {
         if (!(_inputFileData.computerClubEvents.at(i + 1).eventTime >=
@@ -66,197 +242,341 @@ bool EventHandler::isCorrectSequenceOfEventTimes(size_t& eventNumber) {
     return true;
 }
 
-void EventHandler::handleFirstEvent(const Event& event, std::vector<std::string>& outputData) {
+void EventHandler::handleFirstEvent(const Event& event, std::string& output, Tables&) {
     if (_inputFileData.computerClubFeatures.openingTime.hours > event.eventTime.hours) {
-        outputData.push_back(event.eventTime.toString().append(" ")
-                             .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                             .append(" ").append(ERROR1));
+        writeOutgoingEvent(output, event.eventTime, EventFragments::NOT_OPEN_YET.parts());
     } else {
         if (_clientStatuses.find(event.eventBody) != _clientStatuses.end()) {
-            outputData.push_back(event.eventTime.toString().append(" ")
-                                 .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                                 .append(" ").append(ERROR2));
-        }
-        else {
+            writeOutgoingEvent(output, event.eventTime, EventFragments::YOU_SHALL_NOT_PASS.parts());
+        } else {
             _clientStatuses[event.eventBody] = { IncomingEventID::ClientHasCome, 0 };
+            if (_sessionLedger)
+                _sessionLedger->Arrive(event.eventBody, event.eventTime);
         }
     }
 }
 
-void EventHandler::handleSecondEvent(const Event& event, std::vector<std::string>& outputData,
-                                     std::vector<Table>& tables)
-{
-    size_t pos = event.eventBody.find(WORD_DELIMITER);
+void EventHandler::handleSecondEvent(const Event& event, std::string& output, Tables& tables) {
+    std::string_view eventBody = event.eventBody;
+    size_t pos = eventBody.find(WORD_DELIMITER);
 
-    std::string clientName = event.eventBody.substr(0, pos);
-    size_t tableNumber = std::stoi(event.eventBody.substr(pos + 1, event.eventBody.length() - pos - 1));
+    std::string_view clientName = eventBody.substr(0, pos);
+    size_t tableNumber = 0;
+    std::from_chars(eventBody.data() + pos + 1, eventBody.data() + eventBody.size(), tableNumber);
 
     auto it = _clientStatuses.find(clientName);
 
-    if (!isClientKnown(event.eventTime, it, outputData)) {
+    if (!isClientKnown(event.eventTime, it, output)) {
         return;
     } else {
-        auto& currentTable = tables.at(tableNumber - 1);
+        size_t currentTable = tableNumber - 1;
 
-        if (currentTable.isBusy) {
-            outputData.push_back(event.eventTime.toString().append(" ")
-                                 .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                                 .append(" ").append(ERROR4));
+        if (tables.isBusy(currentTable)) {
+            writeOutgoingEvent(output, event.eventTime, EventFragments::PLACE_IS_BUSY.parts());
         } else {
             if (it->second.eventId == IncomingEventID::ClientHasCome)
                 it->second.eventId = IncomingEventID::ClientHasSatDownAtTheTable;
             else
-                freePreviousTable(event.eventTime, tables.at(it->second.numberOfBusyTable - 1));
+                freePreviousTable(event.eventTime, tables, it->second.numberOfBusyTable - 1);
 
-            currentTable.isBusy = true;
-            currentTable.startWorking = event.eventTime;
+            tables.occupy(currentTable, event.eventTime.toMinutes());
+            tableChanged(currentTable);
 
             it->second.numberOfBusyTable = tableNumber;
+            if (_sessionLedger)
+                _sessionLedger->Sit(clientName, tableNumber, event.eventTime);
         }
     }
 }
 
-void EventHandler::handleThirdEvent(const Event& event, std::vector<std::string>& outputData,
-                                    const std::vector<Table>& tables)
-{
+void EventHandler::handleThirdEvent(const Event& event, std::string& output, Tables& tables) {
     auto it = _clientStatuses.find(event.eventBody);
-    if (!isClientKnown(event.eventTime, it, outputData)) {
+    if (!isClientKnown(event.eventTime, it, output)) {
         return;
     } else {
-        if (!isAllTablesBusy(tables)) {
-            outputData.push_back(event.eventTime.toString().append(" ")
-                                 .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                                 .append(" ").append(ERROR5));
+        if (!tables.isAllBusy()) {
+            writeOutgoingEvent(output, event.eventTime, EventFragments::I_CAN_WAIT_NO_LONGER.parts());
         } else {
             if (it->second.eventId == IncomingEventID::ClientHasCome) {
                 if (_waitingClients.size() == _inputFileData.computerClubFeatures.numberOfTables) {
-                    outputData.push_back(event.eventTime.toString().append(" ")
-                                         .append(std::to_string(static_cast<int>(OutgoingEventID::ClientHasGoneAway)))
-                                         .append(" ").append(event.eventBody));
-
-                    _clientStatuses.erase(event.eventBody);
+                    writeOutgoingEvent(output, event.eventTime, EventFragments::CLIENT_HAS_GONE_AWAY.parts(),
+                                       event.eventBody);
+                    if (_sessionLedger) {
+                        _sessionLedger->Leave(event.eventBody, event.eventTime,
+                                              SessionLedger::DepartureReason::QueueOverflow);
+                    }
+
+                    _clientStatuses.erase(it);
                 } else {
                     _waitingClients.push_back(event.eventBody);
-                    _clientStatuses[event.eventBody] = {IncomingEventID::ClientIsWaiting, 0};
+                    it->second = {IncomingEventID::ClientIsWaiting, 0};
+                    if (_sessionLedger)
+                        _sessionLedger->Wait(event.eventBody, event.eventTime);
                 }
             } else if (it->second.eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
-                outputData.push_back(event.eventTime.toString().append(" ")
-                                     .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                                     .append(" ").append(ERROR6));
+                writeOutgoingEvent(output, event.eventTime, EventFragments::CLIENT_HAS_ALREADY_SAT_DOWN.parts());
             } else {
-                outputData.push_back(event.eventTime.toString().append(" ")
-                                     .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                                     .append(" ").append(ERROR7));
+                writeOutgoingEvent(output, event.eventTime, EventFragments::CLIENT_IS_ALREADY_WAITING.parts());
             }
         }
     }
 }
 
-void EventHandler::handleFourthEvent(const Event& event, std::vector<std::string>& outputData,
-                                     std::vector<Table>& tables)
-{
+void EventHandler::handleFourthEvent(const Event& event, std::string& output, Tables& tables) {
     auto it = _clientStatuses.find(event.eventBody);
-    if (!isClientKnown(event.eventTime, it, outputData)) {
+    if (!isClientKnown(event.eventTime, it, output)) {
         return;
     } else {
         if (it->second.eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
-            auto& previousTable = tables.at(it->second.numberOfBusyTable - 1);
-            calculateCurrentTableParameters(previousTable, event.eventTime);
+            size_t previousTable = it->second.numberOfBusyTable - 1;
+            calculateCurrentTableParameters(tables, previousTable, event.eventTime);
+            tableChanged(previousTable);
 
             if (!_waitingClients.empty()) {
-                std::string clientName = _waitingClients.front();
-                _waitingClients.erase(_waitingClients.begin());
+                auto& nextClient = _clientStatuses.find(_waitingClients.front())->second;
+                nextClient = {IncomingEventID::ClientHasSatDownAtTheTable, it->second.numberOfBusyTable};
 
-                _clientStatuses[clientName] = {IncomingEventID::ClientHasSatDownAtTheTable,
-                                               it->second.numberOfBusyTable};
+                tables.restart(previousTable, event.eventTime.toMinutes());
+                if (_sessionLedger)
+                    _sessionLedger->Sit(_waitingClients.front(), it->second.numberOfBusyTable, event.eventTime);
 
-                previousTable.startWorking = event.eventTime;
-                int temp = static_cast<int>(OutgoingEventID::ClientHasSatDownAtTheTable);
+                writeOutgoingEvent(output, event.eventTime, EventFragments::CLIENT_HAS_SAT_DOWN.parts(),
+                                   _waitingClients.front(), it->second.numberOfBusyTable);
 
-                outputData.push_back(event.eventTime.toString().append(" ")
-                                     .append(std::to_string(temp)).append(" ").append(clientName).append(" ")
-                                     .append(std::to_string(it->second.numberOfBusyTable)));
+                _waitingClients.pop_front();
             } else {
-                previousTable.isBusy = false;
-                previousTable.startWorking = {0, 0};
+                tables.release(previousTable);
             }
         } else if (it->second.eventId == IncomingEventID::ClientIsWaiting) {
             _waitingClients.erase(std::ranges::find(_waitingClients, event.eventBody));
         }
 
-        _clientStatuses.erase(event.eventBody);
+        if (_sessionLedger)
+            _sessionLedger->Leave(event.eventBody, event.eventTime, SessionLedger::DepartureReason::Voluntary);
+        _clientStatuses.erase(it);
     }
 }
 
-bool EventHandler::isClientKnown(const Time& eventTime,
-                                 const std::map<std::string, ClientStatus>::iterator& clientNameIterator,
-                                 std::vector<std::string>& outputData)
+bool EventHandler::isClientKnown(const Time& eventTime, const ClientStatuses::iterator& clientNameIterator,
+                                 std::string& output)
 {
     if (clientNameIterator == _clientStatuses.end()) {
-        outputData.push_back(eventTime.toString().append(" ")
-                             .append(std::to_string(static_cast<int>(OutgoingEventID::Error)))
-                             .append(" ").append(ERROR3));
+        writeOutgoingEvent(output, eventTime, EventFragments::CLIENT_UNKNOWN.parts());
         return false;
     } else {
         return true;
     }
 }
 
-void EventHandler::freePreviousTable(const Time& eventTime, Table& previousTable) {
-    calculateCurrentTableParameters(previousTable, eventTime);
+void EventHandler::writeClubTime(std::string& output, const Time& time, bool isClosing) const {
+    if (_outputFormat != OutputFormat::Text) {
+        using RecordFormat::RecordType;
+        RecordFormat::appendRecord(output, _outputFormat, {
+            .type = isClosing ? RecordType::Closing : RecordType::Opening,
+            .time = time,
+        });
+        return;
+    }
 
-    previousTable.isBusy = false;
-    previousTable.startWorking = {0, 0};
+    time.appendTo(output);
+    output.push_back('\n');
 }
 
-void EventHandler::calculateCurrentTableParameters(Table& table, const Time& stopWorking) const {
-    Time temp;
+void EventHandler::writeIncomingEvent(std::string& output, const Event& event, std::string_view line) const {
+    if (_outputFormat == OutputFormat::Text) {
+        output.append(line).push_back('\n');
+        return;
+    }
+
+    RecordFormat::Record record{
+        .type = RecordFormat::RecordType::Event,
+        .time = event.eventTime,
+        .eventId = static_cast<uint16_t>(event.eventId),
+        .clientName = event.eventBody,
+    };
+    if (event.eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
+        std::string_view eventBody = event.eventBody;
+        size_t pos = eventBody.find(WORD_DELIMITER);
+
+        record.clientName = eventBody.substr(0, pos);
+        std::from_chars(eventBody.data() + pos + 1, eventBody.data() + eventBody.size(), record.table);
+    }
 
-    if (stopWorking.hours == table.startWorking.hours) {
-        temp.hours = 0;
-        temp.minutes = stopWorking.minutes - table.startWorking.minutes;
-    } else {
-        if (stopWorking.minutes >= table.startWorking.minutes) {
-            temp.hours = stopWorking.hours - table.startWorking.hours;
-            temp.minutes = stopWorking.minutes - table.startWorking.minutes;
-        } else {
-            temp.hours = stopWorking.hours - 1 - table.startWorking.hours;
-            temp.minutes = stopWorking.minutes + MINUTES_IN_HOUR - table.startWorking.minutes;
+    RecordFormat::appendRecord(output, _outputFormat, record);
+}
+
+void EventHandler::writeOutgoingEvent(std::string& output, const Time& eventTime,
+                                      const EventFragments::FragmentParts& fragment, std::string_view clientName,
+                                      size_t table) const
+{
+    if (!_areEventsWritten)
+        return;
+
+    // The text of an error fragment is the name of the error, and the other fragments have none
+    if (_outputFormat != OutputFormat::Text) {
+        RecordFormat::appendRecord(output, _outputFormat, {
+            .type = RecordFormat::RecordType::GeneratedEvent,
+            .time = eventTime,
+            .eventId = static_cast<uint16_t>(fragment.eventId),
+            .clientName = clientName,
+            .table = table,
+            .errorName = fragment.text,
+        });
+        return;
+    }
+
+    eventTime.appendTo(output);
+    output.append(fragment.line).append(clientName);
+    if (table != 0) {
+        output.push_back(WORD_DELIMITER);
+        appendNumber(output, table);
+    }
+    output.push_back('\n');
+}
+
+void EventHandler::freePreviousTable(const Time& eventTime, Tables& tables, size_t previousTable) {
+    calculateCurrentTableParameters(tables, previousTable, eventTime);
+    tables.release(previousTable);
+    tableChanged(previousTable);
+}
+
+void EventHandler::calculateCurrentTableParameters(Tables& tables, size_t table, const Time& stopWorking) const {
+    uint32_t workingTime = stopWorking.toMinutes() - tables.startWorking(table);
+
+    tables.addWork(table, workingTime, (workingTime + MINUTES_IN_HOUR - 1) / MINUTES_IN_HOUR *
+                                       _inputFileData.computerClubFeatures.costPerHour);
+}
+
+void EventHandler::closeTheClub(std::string& output, Tables& tables) {
+    const Time& closingTime = _inputFileData.computerClubFeatures.closingTime;
+
+    if (_areEventsWritten) {
+        for (const auto& client: _clientStatuses)
+            writeOutgoingEvent(output, closingTime, EventFragments::CLIENT_HAS_GONE_AWAY.parts(), client.first);
+    }
+    if (_sessionLedger) {
+        for (const auto& client: _clientStatuses)
+            _sessionLedger->Leave(client.first, closingTime, SessionLedger::DepartureReason::Closing);
+    }
+
+    // Every busy table belongs to one of the remaining clients, so all of them are settled in a single pass over
+    // the allocated pages without branches, which the compiler is free to vectorize
+    const uint32_t closingMinutes = closingTime.toMinutes();
+    const size_t costPerHour = _inputFileData.computerClubFeatures.costPerHour;
+
+    for (size_t pageNumber : tables.usedPages()) {
+        auto& page = tables.page(pageNumber);
+
+        for (size_t offset = 0; offset < page.size(); offset++) {
+            uint32_t workingTime = (closingMinutes - page.startWorking[offset]) * page.isBusy[offset];
+
+            page.entireWorkingTime[offset] += workingTime;
+            page.income[offset] += (workingTime + MINUTES_IN_HOUR - 1) / MINUTES_IN_HOUR * costPerHour;
         }
     }
 
-    if (temp.minutes + table.entireWorkingTime.minutes >= MINUTES_IN_HOUR) {
-        table.entireWorkingTime.hours += temp.hours + 1;
-        table.entireWorkingTime.minutes += temp.minutes - MINUTES_IN_HOUR;
-    } else {
-        table.entireWorkingTime.hours += temp.hours;
-        table.entireWorkingTime.minutes += temp.minutes;
+    tables.releaseAll();
+}
+
+void EventHandler::publishChangedTables(const Time& time, const Tables& tables) {
+    _liveSnapshot->BeginUpdate();
+
+    for (size_t number = 0; number < _numberOfChangedTables; number++) {
+        size_t table = _changedTables[number];
+        _liveSnapshot->SetTable(table, { tables.isBusy(table), tables.startWorking(table),
+                                         tables.entireWorkingTime(table), tables.income(table) });
+    }
+
+    _liveSnapshot->EndUpdate(_numberOfHandledEvents, time, _clientStatuses.size(), _waitingClients.size());
+}
+
+void EventHandler::publishClosing(const Tables& tables) {
+    _liveSnapshot->BeginUpdate();
+
+    for (size_t pageNumber : tables.usedPages()) {
+        const auto& page = *tables.pageAt(pageNumber);
+
+        for (size_t offset = 0; offset < page.size(); offset++) {
+            _liveSnapshot->SetTable((pageNumber << Tables::PAGE_SHIFT) + offset,
+                                    { static_cast<bool>(page.isBusy[offset]), page.startWorking[offset],
+                                      page.entireWorkingTime[offset], page.income[offset] });
+        }
     }
 
-    if (temp.minutes == 0)
-        table.income += temp.hours * _inputFileData.computerClubFeatures.costPerHour;
-    else
-        table.income += (temp.hours + 1) * _inputFileData.computerClubFeatures.costPerHour;
+    // Everyone has been seen out
+    _liveSnapshot->EndUpdate(_numberOfHandledEvents, _inputFileData.computerClubFeatures.closingTime, 0, 0);
+}
+
+EventHandler::State EventHandler::SaveState() const {
+    State state;
+    state.clientStatuses.assign(_clientStatuses.cbegin(), _clientStatuses.cend());
+    state.waitingClients.assign(_waitingClients.cbegin(), _waitingClients.cend());
+
+    return state;
 }
 
-bool EventHandler::isAllTablesBusy(const std::vector<Table>& tables) {
-    return std::ranges::all_of(tables, [](const Table& table) {
-        return table.isBusy;
-    });
+void EventHandler::RestoreState(State state) {
+    _clientStatuses.clear();
+    for (auto& [name, status] : state.clientStatuses)
+        _clientStatuses.emplace_hint(_clientStatuses.end(), std::move(name), status);
+
+    _waitingClients.assign(std::make_move_iterator(state.waitingClients.begin()),
+                           std::make_move_iterator(state.waitingClients.end()));
 }
 
-void EventHandler::closeTheClub(std::vector<std::string>& outputData, std::vector<Table>& tables) {
-    for (const auto& client: _clientStatuses) {
-        outputData.push_back(_inputFileData.computerClubFeatures.closingTime.toString().append(" ")
-                             .append(std::to_string(static_cast<int>(OutgoingEventID::ClientHasGoneAway))).append(" ")
-                             .append(client.first));
+void EventHandler::WriteStateAsOf(const Time& time, std::string& output, Tables& tables) const {
+    output.append("As of ");
+    time.appendTo(output);
+
+    size_t numberOfSeated = 0, numberOfInside = 0;
+    for (const auto& client : _clientStatuses) {
+        numberOfSeated += client.second.eventId == IncomingEventID::ClientHasSatDownAtTheTable;
+        numberOfInside += client.second.eventId == IncomingEventID::ClientHasCome;
+    }
+
+    output.append("\nSeated ");
+    appendNumber(output, numberOfSeated);
+    output.push_back('\n');
+    for (const auto& [name, status] : _clientStatuses) {
+        if (status.eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
+            output.append(name).push_back(WORD_DELIMITER);
+            appendNumber(output, status.numberOfBusyTable);
+            output.push_back('\n');
+        }
+    }
+
+    output.append("Waiting ");
+    appendNumber(output, _waitingClients.size());
+    output.push_back('\n');
+    for (const auto& name : _waitingClients)
+        output.append(name).push_back('\n');
+
+    output.append("Inside ");
+    appendNumber(output, numberOfInside);
+    output.push_back('\n');
+    for (const auto& [name, status] : _clientStatuses) {
+        if (status.eventId == IncomingEventID::ClientHasCome)
+            output.append(name).push_back('\n');
+    }
+
+    const uint32_t minutes = time.toMinutes();
+    const size_t costPerHour = _inputFileData.computerClubFeatures.costPerHour;
+    size_t revenue = 0;
 
-        if (client.second.eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
-            auto& table = tables.at(client.second.numberOfBusyTable - 1);
-            calculateCurrentTableParameters(table, _inputFileData.computerClubFeatures.closingTime);
+    for (size_t pageNumber : tables.usedPages()) {
+        auto& page = tables.page(pageNumber);
 
-            table.isBusy = false;
-            table.startWorking = { 0, 0 };
+        for (size_t offset = 0; offset < page.size(); offset++) {
+            uint32_t workingTime = (minutes - page.startWorking[offset]) * page.isBusy[offset];
+
+            page.entireWorkingTime[offset] += workingTime;
+            page.income[offset] += (workingTime + MINUTES_IN_HOUR - 1) / MINUTES_IN_HOUR * costPerHour;
+            revenue += page.income[offset];
         }
     }
+
+    output.append("Revenue ");
+    appendNumber(output, revenue);
+    output.push_back('\n');
+    appendTablesReport(output, tables);
 }
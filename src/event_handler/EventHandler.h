@@ -2,39 +2,140 @@
 #define COMPUTERCLUB_EVENTHANDLER_H
 
 #include "InputFileData.h"
+#include "RunOptions.h"
+#include <array>
 #include <map>
 #include <list>
+#include <string_view>
+
+class LiveSnapshot;
+class SessionLedger;
+
+namespace EventFragments {
+struct FragmentParts;
+}
 
 class EventHandler {
 public:
     explicit EventHandler(InputFileData inputFileData)
                         : _inputFileData(std::move(inputFileData)) { }
 
-    void HandleEventsOfTheDay(std::vector<std::string>& outputData, Error& error, std::vector<Table>& tables);
+    void HandleEventsOfTheDay(std::string& output, Error& error, Tables& tables);
+
+    // Same output as HandleEventsOfTheDay. Nothing carries over the moments the club is empty except the table
+    // totals, so the day is cut there into segments that are handled by independent EventHandlers at once.
+    // The input is consumed by the segments, of which there are at most RunOptions::MAX_NUMBER_OF_THREADS.
+    void HandleEventsOfTheDayInParallel(std::string& output, Error& error, Tables& tables, size_t numberOfThreads);
+
+    // Same as HandleEventsOfTheDay for events that may be up to windowMinutes out of order; they are handled in the
+    // order of time (see ReorderBuffer). An event later than that sets IncorrectEventTimeSequence, and output is
+    // left incomplete.
+    void HandleEventsOfTheDayReordered(std::string& output, Error& error, Tables& tables, uint16_t windowMinutes);
+
+    // Step-by-step form of HandleEventsOfTheDay for callers that interleave several days.
+    // Start returns false if the events can't be handled, in which case error is set.
+    bool Start(std::string& output, Error& error, Tables& tables);
+    void HandleEvent(size_t eventNumber, std::string& output, Tables& tables);
+    void Finish(std::string& output, Tables& tables);
+
+    // Start and HandleEvent for events that come from elsewhere, e.g. merged from several logs, one at a time in
+    // the order of time; the input then only holds the features of the club
+    void Open(std::string& output, Tables& tables);
+    void HandleEvent(const Event& event, std::string_view line, std::string& output, Tables& tables);
+
+    size_t numberOfEvents() const { return _inputFileData.computerClubEvents.size(); }
+    const Time& eventTime(size_t eventNumber) const { return _inputFileData.computerClubEvents[eventNumber].eventTime; }
+    // Hands the input back once the day is handled, so that its buffers can be reused
+    InputFileData TakeInputFileData() { return std::move(_inputFileData); }
+
+    // Publishes the tables, clients and queue to liveSnapshot after every event and at closing, for readers on other
+    // threads. The day is then handled on one thread. Throws std::invalid_argument if the number of tables differs.
+    void PublishTo(LiveSnapshot* liveSnapshot);
+
+    // Records every visit of a client to sessionLedger, which gets the visits of the day by closing. The day is
+    // then handled on one thread.
+    void RecordTo(SessionLedger* sessionLedger) { _sessionLedger = sessionLedger; }
+
+    // Only the echo and the generated events of sections are written to output, and nothing at all is formatted
+    // for the ones left out; the tables are kept either way
+    void SelectSections(const ReportSections& sections) {
+        _isEchoWritten = sections.echo;
+        _areEventsWritten = sections.events;
+    }
+
+    // The opening, the closing and the events are written to output as records of format (see RecordFormat.h)
+    // instead of text lines, so that no text is made for them at all; WriteStateAsOf always writes text
+    void WriteAs(OutputFormat format) { _outputFormat = format; }
+
+    const ComputerClubFeatures& computerClubFeatures() const { return _inputFileData.computerClubFeatures; }
+
+    // What carries over from one event to the next besides the tables, for checkpoints of a time index
+    struct State {
+        std::vector<std::pair<std::string, ClientStatus>> clientStatuses;
+        std::vector<std::string> waitingClients;
+    };
+
+    State SaveState() const;
+    void RestoreState(State state);
+
+    // The club right after the events handled so far: who is seated, waiting or just inside, and the tables with
+    // the busy ones settled at time the way closing the club settles them
+    void WriteStateAsOf(const Time& time, std::string& output, Tables& tables) const;
 
 private:
+    using ClientStatuses = std::map<std::string, ClientStatus, std::less<>>;
+    using IncomingEventHandler = void (EventHandler::*)(const Event&, std::string&, Tables&);
+
     InputFileData _inputFileData;
-    std::map<std::string, ClientStatus> _clientStatuses;
+    ClientStatuses _clientStatuses;
     std::list<std::string> _waitingClients;
 
+    uint64_t _numberOfHandledEvents{};
+    LiveSnapshot* _liveSnapshot{};
+    SessionLedger* _sessionLedger{};
+    // The tables the current event has changed, for the live snapshot
+    std::array<size_t, 2> _changedTables{};
+    size_t _numberOfChangedTables{};
+
+    bool _isEchoWritten{true};
+    bool _areEventsWritten{true};
+    OutputFormat _outputFormat{OutputFormat::Text};
+
     bool isCorrectInputFileData(Error& error);
+
+    std::vector<size_t> findSegmentEnds(size_t numberOfSegments) const;
+    EventHandler takeSegment(size_t begin, size_t end);
     bool isCorrectSequenceOfEventTimes(size_t& eventNumber);
 
-    void handleFirstEvent(const Event& event, std::vector<std::string>& outputData);
-    void handleSecondEvent(const Event& event, std::vector<std::string>& outputData, std::vector<Table>& tables);
-    void handleThirdEvent(const Event& event, std::vector<std::string>& outputData, const std::vector<Table>& tables);
-    void handleFourthEvent(const Event& event, std::vector<std::string>& outputData, std::vector<Table>& tables);
+    void handleFirstEvent(const Event& event, std::string& output, Tables& tables);
+    void handleSecondEvent(const Event& event, std::string& output, Tables& tables);
+    void handleThirdEvent(const Event& event, std::string& output, Tables& tables);
+    void handleFourthEvent(const Event& event, std::string& output, Tables& tables);
+
+    // Indexed by IncomingEventID - 1
+    static constexpr std::array<IncomingEventHandler, 4> EVENT_HANDLERS = {
+        &EventHandler::handleFirstEvent,
+        &EventHandler::handleSecondEvent,
+        &EventHandler::handleThirdEvent,
+        &EventHandler::handleFourthEvent,
+    };
+
+    bool isClientKnown(const Time& eventTime, const ClientStatuses::iterator& clientNameIterator, std::string& output);
 
-    bool isClientKnown(const Time& eventTime, const std::map<std::string, ClientStatus>::iterator& clientNameIterator,
-                       std::vector<std::string>& outputData);
+    void writeClubTime(std::string& output, const Time& time, bool isClosing) const;
+    void writeIncomingEvent(std::string& output, const Event& event, std::string_view line) const;
+    void writeOutgoingEvent(std::string& output, const Time& eventTime, const EventFragments::FragmentParts& fragment,
+                            std::string_view clientName = {}, size_t table = 0) const;
 
-    void freePreviousTable(const Time& eventTime, Table& previousTable);
+    void freePreviousTable(const Time& eventTime, Tables& tables, size_t previousTable);
 
-    void calculateCurrentTableParameters(Table& table, const Time& stopWorking) const;
+    void calculateCurrentTableParameters(Tables& tables, size_t table, const Time& stopWorking) const;
 
-    static bool isAllTablesBusy(const std::vector<Table>& tables);
+    void closeTheClub(std::string& output, Tables& tables);
 
-    void closeTheClub(std::vector<std::string>& outputFileData, std::vector<Table>& tables);
+    void tableChanged(size_t table) { _changedTables[_numberOfChangedTables++] = table; }
+    void publishChangedTables(const Time& time, const Tables& tables);
+    void publishClosing(const Tables& tables);
 };
 
 
@@ -0,0 +1,26 @@
+#include "ReorderBuffer.h"
+#include <algorithm>
+#include <functional>
+
+bool ReorderBuffer::Push(const Time& eventTime) {
+    uint16_t minutes = eventTime.toMinutes();
+    if (minutes + _windowMinutes < _latestMinutes)
+        return false;
+
+    _latestMinutes = std::max(_latestMinutes, minutes);
+    _heap.push_back(uint64_t{minutes} << MINUTES_SHIFT | _numberOfEvents++);
+    std::ranges::push_heap(_heap, std::greater<>{});
+
+    return true;
+}
+
+bool ReorderBuffer::Pop(uint64_t& eventNumber, bool isEndOfInput) {
+    if (_heap.empty() || (!isEndOfInput && (_heap.front() >> MINUTES_SHIFT) + _windowMinutes >= _latestMinutes))
+        return false;
+
+    std::ranges::pop_heap(_heap, std::greater<>{});
+    eventNumber = _heap.back() & ((uint64_t{1} << MINUTES_SHIFT) - 1);
+    _heap.pop_back();
+
+    return true;
+}
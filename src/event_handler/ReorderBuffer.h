@@ -0,0 +1,35 @@
+#ifndef COMPUTERCLUB_REORDERBUFFER_H
+#define COMPUTERCLUB_REORDERBUFFER_H
+
+#include "InputFileData.h"
+#include <vector>
+
+// Puts slightly out-of-order events back in order, e.g. those of terminals whose clocks drift apart. Events wait
+// on a min-heap on time until they are more than windowMinutes older than the latest event pushed (the watermark),
+// since nothing that may still come can go before them then. They are released in the order of time, and events
+// at the same time in the order they came. An event that is more than windowMinutes older than the latest one
+// could have to go before events already released, so it is refused.
+// Only the times are kept: events are known by the order they were pushed in, counting from 0, and stay with
+// the caller.
+class ReorderBuffer {
+public:
+    explicit ReorderBuffer(uint16_t windowMinutes) : _windowMinutes(windowMinutes) { }
+
+    // Returns false, without taking the event, if it is later than the window
+    bool Push(const Time& eventTime);
+
+    // The number of the next event that can't be overtaken any more; at the end of the input of all the rest
+    bool Pop(uint64_t& eventNumber, bool isEndOfInput = false);
+
+private:
+    static constexpr size_t MINUTES_SHIFT = 48;
+
+    uint16_t _windowMinutes;
+    uint16_t _latestMinutes{};
+    uint64_t _numberOfEvents{};
+    // The minutes of an event above MINUTES_SHIFT and its number below, so that the keys sort as the events go
+    std::vector<uint64_t> _heap;
+};
+
+
+#endif //COMPUTERCLUB_REORDERBUFFER_H
@@ -1,181 +1,197 @@
 #include "FileParser.h"
 #include "Constants.h"
-#include <fstream>
+#include "DecompressingBlockReader.h"
+#include "LineReader.h"
+#include "TextParsing.h"
 #include <algorithm>
 
 void FileParser::Parse(const std::string& fileName, InputFileData& inputFileData, Error& error) {
-    size_t dotPos = fileName.find_last_of('.');
-    if (dotPos == std::string::npos || fileName.substr(dotPos + 1, fileName.length() - dotPos - 1) != "txt") {
-        error = { ErrorType::IncorrectFileExtension, "The file has an incorrect extension!" };
-        return;
-    }
-
-    std::ifstream txtFile(fileName);
+    auto txtFile = OpenLog(fileName, error);
 
-    if (txtFile.is_open()) {
-        std::string numberOfTables;
-        std::getline(txtFile, numberOfTables);
+    if (txtFile)
+        parse(*txtFile, inputFileData, error);
+}
 
-        if (!isPositiveNumber(numberOfTables)) {
-            error = { ErrorType::IncorrectNumberOfTables, numberOfTables };
-            return;
-        }
+std::unique_ptr<LineReader> FileParser::OpenLog(const std::string& fileName, Error& error) {
+    auto blockReader = openFile(fileName, error);
+    if (!blockReader)
+        return nullptr;
 
-        inputFileData.computerClubFeatures.numberOfTables = stoi(numberOfTables);
+    return std::make_unique<LineReader>(std::move(blockReader));
+}
 
-        std::string workingHours;
-        ErrorType errorType;
-        Time opening{}, closing{};
+bool FileParser::ReadContent(const std::string& fileName, std::string& content, Error& error) {
+    auto blockReader = openFile(fileName, error);
+    if (!blockReader)
+        return false;
 
-        std::getline(txtFile, workingHours);
-        if (!isCorrectWorkingHoursFormat(workingHours, errorType, opening, closing)) {
-            error = { errorType, workingHours};
-            return;
-        }
+    content.clear();
+    for (auto block = blockReader->NextBlock(); !block.empty(); block = blockReader->NextBlock())
+        content.append(block);
 
-        if ((opening.hours > closing.hours) ||
-            (opening.hours == closing.hours && opening.minutes >= closing.minutes))
-        {
-            error = { ErrorType::OpeningTimeIsNotLessThanClosingTime, workingHours};
-            return;
-        }
+    return true;
+}
 
-        inputFileData.computerClubFeatures.openingTime = opening;
-        inputFileData.computerClubFeatures.closingTime = closing;
+void FileParser::ParseContent(std::string_view content, InputFileData& inputFileData, Error& error) {
+    LineReader lineReader(std::make_unique<MemoryBlockReader>(content));
+    parse(lineReader, inputFileData, error);
+}
 
-        std::string costPerHour;
-        std::getline(txtFile, costPerHour);
+std::unique_ptr<BlockReader> FileParser::openFile(const std::string& fileName, Error& error) {
+    if (!isCorrectFileExtension(fileName, error))
+        return nullptr;
 
-        if (!isPositiveNumber(costPerHour)) {
-            error = { ErrorType::IncorrectCostPerHour, costPerHour};
-            return;
-        }
+    auto blockReader = DecompressingBlockReader::Open(fileName, DecompressingBlockReader::CompressionOf(fileName));
+    if (!blockReader)
+        error.errorType = ErrorType::FileIsNotOpen;
 
-        inputFileData.computerClubFeatures.costPerHour = stoi(costPerHour);
+    return blockReader;
+}
 
-        parseEvents(std::move(txtFile), inputFileData, error);
-    } else {
-        error.errorType = ErrorType::FileIsNotOpen;
+// "<name>.txt", or "<name>.txt.gz" and "<name>.txt.zst" if the build can decompress them
+bool FileParser::isCorrectFileExtension(const std::string& fileName, Error& error) {
+    std::string_view logName = fileName;
+    auto compression = DecompressingBlockReader::CompressionOf(fileName);
+    if (compression != DecompressingBlockReader::Compression::None)
+        logName.remove_suffix(logName.size() - logName.find_last_of('.'));
+
+    size_t dotPos = logName.find_last_of('.');
+    if (!DecompressingBlockReader::IsSupported(compression) || dotPos == std::string_view::npos ||
+        logName.substr(dotPos + 1) != "txt")
+    {
+        error = { ErrorType::IncorrectFileExtension, "The file has an incorrect extension!" };
+        return false;
     }
+
+    return true;
 }
 
-bool FileParser::isPositiveNumber(const std::string& data) {
-    if (!data.empty() && data.at(0) >= '1' && data.at(0) <= '9') {
-        return std::ranges::all_of(data.cbegin() + 1, data.cend(), [](char symbol) {
-            return symbol >= '0' && symbol <= '9';
-        });
+void FileParser::parse(LineReader& txtFile, InputFileData& inputFileData, Error& error) {
+    if (ParseHeader(txtFile, inputFileData.computerClubFeatures, error))
+        parseEvents(txtFile, inputFileData, error);
+}
+
+bool FileParser::ParseHeader(LineReader& txtFile, ComputerClubFeatures& computerClubFeatures, Error& error) {
+    std::string numberOfTables;
+    txtFile.GetLine(numberOfTables);
+
+    if (!parsePositiveNumber(numberOfTables, computerClubFeatures.numberOfTables)) {
+        error = { ErrorType::IncorrectNumberOfTables, numberOfTables };
+        return false;
     }
 
-    return false;
-}
+    std::string workingHours;
+    ErrorType errorType;
+    Time opening{}, closing{};
 
-bool FileParser::isCorrectWorkingHoursFormat(const std::string& data, ErrorType& errorType,
-                                             Time& opening, Time& closing)
-{
-    size_t pos = data.find(WORD_DELIMITER);
-    if (pos == std::string::npos) {
-        errorType = ErrorType::IncorrectWorkingHoursFormat;
+    txtFile.GetLine(workingHours);
+    if (!isCorrectWorkingHoursFormat(workingHours, errorType, opening, closing)) {
+        error = { errorType, workingHours};
         return false;
     }
 
-    std::string openingTime = data.substr(0, pos);
-    if (!isCorrectTimeFormat(openingTime, opening)) {
-        errorType = ErrorType::IncorrectOpeningTime;
+    if ((opening.hours > closing.hours) ||
+        (opening.hours == closing.hours && opening.minutes >= closing.minutes))
+    {
+        error = { ErrorType::OpeningTimeIsNotLessThanClosingTime, workingHours};
         return false;
     }
 
-    std::string closingTime = data.substr(pos + 1, data.length() - pos - 1);
-    if (!isCorrectTimeFormat(closingTime, closing)) {
-        errorType = ErrorType::IncorrectClosingTime;
+    computerClubFeatures.openingTime = opening;
+    computerClubFeatures.closingTime = closing;
+
+    std::string costPerHour;
+    txtFile.GetLine(costPerHour);
+
+    if (!parsePositiveNumber(costPerHour, computerClubFeatures.costPerHour)) {
+        error = { ErrorType::IncorrectCostPerHour, costPerHour};
         return false;
     }
 
     return true;
 }
 
-bool FileParser::isCorrectTimeFormat(const std::string& data, Time& time) {
-    size_t pos = data.find(TIME_DELIMITER);
-    if (pos == std::string::npos)
+bool FileParser::isCorrectWorkingHoursFormat(std::string_view data, ErrorType& errorType,
+                                             Time& opening, Time& closing)
+{
+    size_t pos = data.find(WORD_DELIMITER);
+    if (pos == std::string_view::npos) {
+        errorType = ErrorType::IncorrectWorkingHoursFormat;
         return false;
+    }
 
-    std::string hours = data.substr(0, pos);
-    if (hours.length() != 2 || !isCorrectHourFormat(hours))
+    if (!parseTime(data.substr(0, pos), opening)) {
+        errorType = ErrorType::IncorrectOpeningTime;
         return false;
+    }
 
-    std::string minutes = data.substr(pos + 1, data.length() - pos - 1);
-    if (minutes.length() != 2 || !isCorrectMinuteFormat(minutes))
+    if (!parseTime(data.substr(pos + 1), closing)) {
+        errorType = ErrorType::IncorrectClosingTime;
         return false;
-
-    time.hours = stoi(hours);
-    time.minutes = stoi(minutes);
+    }
 
     return true;
 }
 
-bool FileParser::isCorrectHourFormat(const std::string& data) {
-    if (data.at(0) == '0' || data.at(0) == '1')
-        return (data.at(1) >= '0' && data.at(1) <= '9');
-    else if (data.at(0) == '2')
-        return (data.at(1) >= '0' && data.at(1) <= '3');
-    else
-        return false;
-}
-
-bool FileParser::isCorrectMinuteFormat(const std::string& data) {
-    return (data.at(0) >= '0' && data.at(0) <= '5') && (data.at(1) >= '0' && data.at(1) <= '9');
-}
-
-void FileParser::parseEvents(std::ifstream&& txtFile, InputFileData& inputFileData, Error& error) {
+void FileParser::parseEvents(LineReader& txtFile, InputFileData& inputFileData, Error& error) {
     std::string line;
 
-    while (getline(txtFile, line)) {
-        size_t firstPos = line.find(WORD_DELIMITER);
-
-        if (firstPos == std::string::npos) {
-            error = { ErrorType::NoDelimiters, line};
+    while (txtFile.GetLine(line)) {
+        if (!ParseEvent(std::move(line), inputFileData, error))
             return;
-        }
 
-        size_t secondPos = line.find(WORD_DELIMITER, firstPos + 1);
-        if (secondPos == std::string::npos) {
-            error = { ErrorType::TooLittleDelimiters, line};
-            return;
-        }
+        line.clear();
+    }
+}
 
-        std::string time = line.substr(0, firstPos);
-        std::string id = line.substr(firstPos + 1, secondPos - firstPos - 1);
-        std::string body = line.substr(secondPos + 1, line.length() - secondPos - 1);
+bool FileParser::ParseEvent(std::string line, InputFileData& inputFileData, Error& error) {
+    size_t firstPos = line.find(WORD_DELIMITER);
 
-        Time eventTime{};
-        if (!isCorrectTimeFormat(time, eventTime)) {
-            error = { ErrorType::IncorrectEventTime, line };
-            return;
-        }
+    if (firstPos == std::string::npos) {
+        error = { ErrorType::NoDelimiters, line};
+        return false;
+    }
 
-        if (eventTime >= inputFileData.computerClubFeatures.closingTime) {
-            error = { ErrorType::EventTimeIsNotLessThanClosingTime, line };
-            return;
-        }
+    size_t secondPos = line.find(WORD_DELIMITER, firstPos + 1);
+    if (secondPos == std::string::npos) {
+        error = { ErrorType::TooLittleDelimiters, line};
+        return false;
+    }
 
-        IncomingEventID eventId;
-        ErrorType errorType;
-        if (!isCorrectEventId(id, errorType, eventId)) {
-            error = { errorType, line };
-            return;
-        }
+    std::string_view lineView = line;
+    std::string_view time = lineView.substr(0, firstPos);
+    std::string_view id = lineView.substr(firstPos + 1, secondPos - firstPos - 1);
+    std::string_view body = lineView.substr(secondPos + 1);
 
-        if (!isCorrectEventBody(body, eventId, inputFileData.computerClubFeatures.numberOfTables, errorType)) {
-            error = { errorType, line };
-            return;
-        }
+    Time eventTime{};
+    if (!parseTime(time, eventTime)) {
+        error = { ErrorType::IncorrectEventTime, line };
+        return false;
+    }
 
-        inputFileData.computerClubEvents.push_back({eventTime, eventId, body});
-        inputFileData.initialEvents.push_back(line);
-        line.clear();
+    if (eventTime >= inputFileData.computerClubFeatures.closingTime) {
+        error = { ErrorType::EventTimeIsNotLessThanClosingTime, line };
+        return false;
+    }
+
+    IncomingEventID eventId;
+    ErrorType errorType;
+    if (!isCorrectEventId(id, errorType, eventId)) {
+        error = { errorType, line };
+        return false;
+    }
+
+    if (!isCorrectEventBody(body, eventId, inputFileData.computerClubFeatures.numberOfTables, errorType)) {
+        error = { errorType, line };
+        return false;
     }
+
+    inputFileData.computerClubEvents.push_back({eventTime, eventId, std::string(body)});
+    inputFileData.initialEvents.push_back(std::move(line));
+    return true;
 }
 
-bool FileParser::isCorrectEventId(const std::string& data, ErrorType& errorType, IncomingEventID& eventId) {
+bool FileParser::isCorrectEventId(std::string_view data, ErrorType& errorType, IncomingEventID& eventId) {
     if (data.length() == 1 && data.at(0) >= '1' && data.at(0) <= '4') {
         switch (data.at(0)) {
             case '1':
@@ -198,30 +214,28 @@ bool FileParser::isCorrectEventId(const std::string& data, ErrorType& errorType,
     }
 }
 
-bool FileParser::isCorrectEventBody(const std::string& data, IncomingEventID eventId,
+bool FileParser::isCorrectEventBody(std::string_view data, IncomingEventID eventId,
                                     size_t numberOfTables, ErrorType& errorType)
 {
     if (eventId == IncomingEventID::ClientHasSatDownAtTheTable) {
         size_t delimiterPos = data.find(WORD_DELIMITER);
 
-        if (delimiterPos == std::string::npos) {
+        if (delimiterPos == std::string_view::npos) {
             errorType = ErrorType::IncorrectBodyEventWithSecondID;
             return false;
         } else {
-            std::string clientName = data.substr(0, delimiterPos);
-            std::string tableNumber = data.substr(delimiterPos + 1, data.length() - delimiterPos - 1);
-
-            if (!isCorrectClientName(clientName)) {
+            if (!isCorrectClientName(data.substr(0, delimiterPos))) {
                 errorType = ErrorType::IncorrectClientName;
                 return false;
             }
 
-            if (!isPositiveNumber(tableNumber)) {
+            size_t tableNumber;
+            if (!parsePositiveNumber(data.substr(delimiterPos + 1), tableNumber)) {
                 errorType = ErrorType::IncorrectTableNumber;
                 return false;
             }
 
-            if (stoi(tableNumber) > numberOfTables) {
+            if (tableNumber > numberOfTables) {
                 errorType = ErrorType::TableNumberMoreThanNumberOfTables;
                 return false;
             }
@@ -236,7 +250,7 @@ bool FileParser::isCorrectEventBody(const std::string& data, IncomingEventID eve
     return true;
 }
 
-bool FileParser::isCorrectClientName(const std::string& data) {
+bool FileParser::isCorrectClientName(std::string_view data) {
     if (!data.empty()) {
         return std::ranges::all_of(data, [](char symbol) {
             return symbol >= '0' && symbol <= '9' || symbol >= 'a' && symbol <= 'z' || symbol == '_' || symbol == '-';
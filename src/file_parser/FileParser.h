@@ -2,26 +2,41 @@
 #define COMPUTERCLUB_FILEPARSER_H
 
 #include "InputFileData.h"
+#include <memory>
+#include <string_view>
+
+class BlockReader;
+class LineReader;
 
 class FileParser {
 public:
+    // Logs compressed as .txt.gz or .txt.zst are decompressed on another thread while they are parsed
     static void Parse(const std::string& fileName, InputFileData& inputFileData, Error& error);
+    // The same for a log that is already in memory, e.g. received over a socket
+    static void ParseContent(std::string_view content, InputFileData& inputFileData, Error& error);
+    // Reads the whole file without parsing it; the file is checked the same way as by Parse
+    static bool ReadContent(const std::string& fileName, std::string& content, Error& error);
+    // Opens a log to be read line by line; the file is checked the same way as by Parse
+    static std::unique_ptr<LineReader> OpenLog(const std::string& fileName, Error& error);
+    // Reads and checks the three lines that describe the club
+    static bool ParseHeader(LineReader& txtFile, ComputerClubFeatures& computerClubFeatures, Error& error);
+    // Checks one event line against computerClubFeatures and appends it to the events of inputFileData
+    static bool ParseEvent(std::string line, InputFileData& inputFileData, Error& error);
 
 private:
-    static bool isPositiveNumber(const std::string& data);
+    static std::unique_ptr<BlockReader> openFile(const std::string& fileName, Error& error);
+    static bool isCorrectFileExtension(const std::string& fileName, Error& error);
+    static void parse(LineReader& txtFile, InputFileData& inputFileData, Error& error);
 
-    static bool isCorrectWorkingHoursFormat(const std::string& data, ErrorType& errorType,
+    static bool isCorrectWorkingHoursFormat(std::string_view data, ErrorType& errorType,
                                             Time& opening, Time& closing);
-    static bool isCorrectTimeFormat(const std::string& data, Time& time);
-    static bool isCorrectHourFormat(const std::string& data);
-    static bool isCorrectMinuteFormat(const std::string& data);
 
-    static void parseEvents(std::ifstream&& txtFile, InputFileData& inputFileData, Error& error);
+    static void parseEvents(LineReader& txtFile, InputFileData& inputFileData, Error& error);
 
-    static bool isCorrectEventId(const std::string& data, ErrorType& errorType, IncomingEventID& eventId);
-    static bool isCorrectEventBody(const std::string& data, IncomingEventID eventId,
+    static bool isCorrectEventId(std::string_view data, ErrorType& errorType, IncomingEventID& eventId);
+    static bool isCorrectEventBody(std::string_view data, IncomingEventID eventId,
                                    size_t numberOfTables, ErrorType& errorType);
-    static bool isCorrectClientName(const std::string& data);
+    static bool isCorrectClientName(std::string_view data);
 };
 
 
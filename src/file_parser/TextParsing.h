@@ -0,0 +1,51 @@
+#ifndef COMPUTERCLUB_TEXTPARSING_H
+#define COMPUTERCLUB_TEXTPARSING_H
+
+#include "InputFileData.h"
+#include <charconv>
+#include <string_view>
+
+// Validates and converts in one pass. Only digits without leading zeros are accepted, and values that don't fit
+// into int (the range std::stoi used to have) are rejected as malformed instead of throwing.
+inline bool parsePositiveNumber(std::string_view data, size_t& number) {
+    if (data.empty() || data.front() < '1' || data.front() > '9')
+        return false;
+
+    int value = 0;
+    auto [end, errorCode] = std::from_chars(data.data(), data.data() + data.size(), value);
+    if (errorCode != std::errc() || end != data.data() + data.size())
+        return false;
+
+    number = static_cast<size_t>(value);
+    return true;
+}
+
+// Fixed-width "HH:MM" checked and converted as one 64-bit word: every digit byte must be 0x30..0x39, that is
+// its high nibble is 3 both before and after adding 6
+inline bool parseTime(std::string_view data, Time& time) {
+    if (data.size() != 5)
+        return false;
+
+    auto byte = [&data](size_t index) { return static_cast<uint64_t>(static_cast<unsigned char>(data[index])); };
+    uint64_t word = byte(0) | byte(1) << 8 | byte(2) << 16 | byte(3) << 24 | byte(4) << 32;
+
+    constexpr uint64_t DIGITS_MASK = 0xF0F000F0F0;
+    constexpr uint64_t DIGITS_HIGH_NIBBLES = 0x3030003030;
+    constexpr uint64_t DIGITS_OVERFLOW = 0x0606000606;
+
+    bool isDigits = (word & DIGITS_MASK) == DIGITS_HIGH_NIBBLES &&
+                    ((word + DIGITS_OVERFLOW) & DIGITS_MASK) == DIGITS_HIGH_NIBBLES;
+    bool isDelimiter = ((word >> 16) & 0xFF) == static_cast<uint64_t>(':');
+
+    uint64_t digits = word - DIGITS_HIGH_NIBBLES;
+    auto hours = static_cast<uint16_t>((digits & 0xFF) * 10 + ((digits >> 8) & 0xFF));
+    auto minutes = static_cast<uint16_t>(((digits >> 24) & 0xFF) * 10 + ((digits >> 32) & 0xFF));
+
+    if (!(isDigits & isDelimiter & (hours < 24) & (minutes < 60)))
+        return false;
+
+    time = { hours, minutes };
+    return true;
+}
+
+#endif //COMPUTERCLUB_TEXTPARSING_H
@@ -0,0 +1,108 @@
+#include "LiveSnapshot.h"
+#include "Constants.h"
+#include <stdexcept>
+#include <thread>
+
+// Data is stored and loaded with relaxed atomics and ordered by fences around the sequence, as in
+// H.-J. Boehm, "Can seqlocks get along with programming language memory models?"
+
+LiveSnapshot::LiveSnapshot(size_t numberOfTables) : _numberOfTables(numberOfTables) {
+    if (numberOfTables > MAX_NUMBER_OF_TABLES)
+        throw std::invalid_argument("The live snapshot can't have that many tables");
+
+    _tableWords = std::make_unique<std::atomic<uint64_t>[]>(2 * numberOfTables);
+}
+
+size_t LiveSnapshot::Snapshot::runningIncome(size_t table) const {
+    const auto& tableState = tables[table];
+    if (!tableState.isBusy)
+        return tableState.income;
+
+    uint32_t workingTime = time.toMinutes() - tableState.startWorking;
+    return tableState.income + (workingTime + MINUTES_IN_HOUR - 1) / MINUTES_IN_HOUR * costPerHour;
+}
+
+size_t LiveSnapshot::Read(Snapshot& snapshot) const {
+    snapshot.tables.resize(_numberOfTables);
+
+    for (size_t attempt = 0; ; attempt++) {
+        uint64_t sequence = _sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        snapshot.numberOfEvents = _numberOfEvents.load(std::memory_order_relaxed);
+        snapshot.time = Time::fromMinutes(_minutes.load(std::memory_order_relaxed));
+        snapshot.numberOfClients = _numberOfClients.load(std::memory_order_relaxed);
+        snapshot.numberOfWaitingClients = _numberOfWaitingClients.load(std::memory_order_relaxed);
+        snapshot.numberOfBusyTables = _numberOfBusyTables.load(std::memory_order_relaxed);
+        snapshot.revenue = _revenue.load(std::memory_order_relaxed);
+        snapshot.costPerHour = _costPerHour.load(std::memory_order_relaxed);
+
+        for (size_t table = 0; table < _numberOfTables; table++) {
+            snapshot.tables[table] = unpackTableState(_tableWords[2 * table].load(std::memory_order_relaxed),
+                                                      _tableWords[2 * table + 1].load(std::memory_order_relaxed));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) == sequence)
+            return attempt;
+    }
+}
+
+void LiveSnapshot::Clear(const Time& openingTime, size_t costPerHour) {
+    BeginUpdate();
+
+    for (size_t word = 0; word < 2 * _numberOfTables; word++)
+        _tableWords[word].store(0, std::memory_order_relaxed);
+
+    _numberOfEvents.store(0, std::memory_order_relaxed);
+    _minutes.store(openingTime.toMinutes(), std::memory_order_relaxed);
+    _numberOfClients.store(0, std::memory_order_relaxed);
+    _numberOfWaitingClients.store(0, std::memory_order_relaxed);
+    _numberOfBusyTables.store(0, std::memory_order_relaxed);
+    _revenue.store(0, std::memory_order_relaxed);
+    _costPerHour.store(costPerHour, std::memory_order_relaxed);
+
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void LiveSnapshot::BeginUpdate() {
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LiveSnapshot::SetTable(size_t table, const TableState& tableState) {
+    // Only the writer stores, so the previous state can be read back without ordering
+    auto& word = _tableWords[2 * table];
+    auto& income = _tableWords[2 * table + 1];
+    bool wasBusy = word.load(std::memory_order_relaxed) >> 63;
+
+    _numberOfBusyTables.store(_numberOfBusyTables.load(std::memory_order_relaxed) + tableState.isBusy - wasBusy,
+                              std::memory_order_relaxed);
+    _revenue.store(_revenue.load(std::memory_order_relaxed) + tableState.income -
+                   income.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    word.store(packTableState(tableState), std::memory_order_relaxed);
+    income.store(tableState.income, std::memory_order_relaxed);
+}
+
+void LiveSnapshot::EndUpdate(uint64_t numberOfEvents, const Time& time, size_t numberOfClients,
+                             size_t numberOfWaitingClients)
+{
+    _numberOfEvents.store(numberOfEvents, std::memory_order_relaxed);
+    _minutes.store(time.toMinutes(), std::memory_order_relaxed);
+    _numberOfClients.store(numberOfClients, std::memory_order_relaxed);
+    _numberOfWaitingClients.store(numberOfWaitingClients, std::memory_order_relaxed);
+
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+uint64_t LiveSnapshot::packTableState(const TableState& tableState) {
+    return uint64_t{tableState.isBusy} << 63 | uint64_t{tableState.startWorking} << 32 | tableState.entireWorkingTime;
+}
+
+LiveSnapshot::TableState LiveSnapshot::unpackTableState(uint64_t word, uint64_t income) {
+    return { static_cast<bool>(word >> 63), static_cast<uint16_t>(word >> 32), static_cast<uint32_t>(word), income };
+}
@@ -0,0 +1,76 @@
+#ifndef COMPUTERCLUB_LIVESNAPSHOT_H
+#define COMPUTERCLUB_LIVESNAPSHOT_H
+
+#include "InputFileData.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Summary of a club that one EventHandler publishes after every event while any number of other threads read it.
+// It is a seqlock: the writer never waits, it makes the sequence odd, stores what the event changed and makes the
+// sequence even again. A reader copies everything and retries if the sequence was odd or has moved meanwhile.
+// Every table has a slot of its own, so the number of tables is fixed at construction.
+class LiveSnapshot {
+public:
+    // Every table takes 16 bytes that Clear and Read go through, so the slots are limited to 16 MiB
+    static constexpr size_t MAX_NUMBER_OF_TABLES = size_t{1} << 20;
+
+    struct TableState {
+        bool isBusy{};
+        uint16_t startWorking{};
+        uint32_t entireWorkingTime{};
+        size_t income{};
+    };
+
+    struct Snapshot {
+        uint64_t numberOfEvents{};
+        Time time;
+        size_t numberOfClients{};
+        size_t numberOfWaitingClients{};
+        size_t numberOfBusyTables{};
+        size_t revenue{};
+        size_t costPerHour{};
+        std::vector<TableState> tables;
+
+        // The income of a table with its current session counted up to time
+        size_t runningIncome(size_t table) const;
+    };
+
+    // Throws std::invalid_argument if numberOfTables is above MAX_NUMBER_OF_TABLES
+    explicit LiveSnapshot(size_t numberOfTables);
+
+    size_t numberOfTables() const { return _numberOfTables; }
+
+    // Copies a consistent state into snapshot, reusing its buffers. Returns the number of attempts that had to be
+    // thrown away because the writer was in the middle of an update.
+    size_t Read(Snapshot& snapshot) const;
+
+    // Writer side, for one thread at a time. Clear starts a new day. The tables stored between BeginUpdate and
+    // EndUpdate become visible together with the summary of EndUpdate.
+    void Clear(const Time& openingTime, size_t costPerHour);
+    void BeginUpdate();
+    void SetTable(size_t table, const TableState& tableState);
+    void EndUpdate(uint64_t numberOfEvents, const Time& time, size_t numberOfClients, size_t numberOfWaitingClients);
+
+private:
+    // Kept apart from the data, which the writer stores into all the time
+    alignas(64) std::atomic<uint64_t> _sequence{};
+
+    alignas(64) std::atomic<uint64_t> _numberOfEvents{};
+    std::atomic<uint32_t> _minutes{};
+    std::atomic<size_t> _numberOfClients{};
+    std::atomic<size_t> _numberOfWaitingClients{};
+    std::atomic<size_t> _numberOfBusyTables{};
+    std::atomic<size_t> _revenue{};
+    std::atomic<size_t> _costPerHour{};
+
+    // Per table: isBusy in bit 63, startWorking in bits 32-47, entireWorkingTime in bits 0-31; then the income
+    size_t _numberOfTables;
+    std::unique_ptr<std::atomic<uint64_t>[]> _tableWords;
+
+    static uint64_t packTableState(const TableState& tableState);
+    static TableState unpackTableState(uint64_t word, uint64_t income);
+};
+
+
+#endif //COMPUTERCLUB_LIVESNAPSHOT_H
@@ -0,0 +1,101 @@
+#include "LogMerger.h"
+#include "FileParser.h"
+#include <algorithm>
+
+namespace {
+
+bool operator==(const Time& first, const Time& second) {
+    return first.hours == second.hours && first.minutes == second.minutes;
+}
+
+bool operator==(const ComputerClubFeatures& first, const ComputerClubFeatures& second) {
+    return first.numberOfTables == second.numberOfTables && first.openingTime == second.openingTime &&
+           first.closingTime == second.closingTime && first.costPerHour == second.costPerHour;
+}
+
+}
+
+bool LogMerger::Open(const std::vector<std::string>& fileNames, Error& error, uint16_t reorderWindowMinutes) {
+    _reorderWindowMinutes = reorderWindowMinutes;
+    _sources.clear();
+    _heap.clear();
+
+    for (const auto& fileName : fileNames) {
+        auto& source = _sources.emplace_back();
+        source.fileName = fileName;
+
+        source.txtFile = FileParser::OpenLog(fileName, error);
+        if (!source.txtFile) {
+            error.errorStr = fileName;
+            return false;
+        }
+
+        if (!FileParser::ParseHeader(*source.txtFile, source.nextEvent.computerClubFeatures, error))
+            return false;
+
+        if (_sources.size() == 1) {
+            _computerClubFeatures = source.nextEvent.computerClubFeatures;
+        } else if (!(source.nextEvent.computerClubFeatures == _computerClubFeatures)) {
+            error = { ErrorType::DifferentLogHeaders, fileName };
+            return false;
+        }
+    }
+
+    for (size_t sourceNumber = 0; sourceNumber < _sources.size(); sourceNumber++) {
+        if (!readNextEvent(sourceNumber, error) && error.errorType != ErrorType::Success)
+            return false;
+    }
+
+    std::ranges::make_heap(_heap, [this](size_t first, size_t second) { return isLater(first, second); });
+    return true;
+}
+
+bool LogMerger::Next(Event& event, std::string& line, Error& error) {
+    if (_heap.empty())
+        return false;
+
+    auto isLaterSource = [this](size_t first, size_t second) { return isLater(first, second); };
+    std::ranges::pop_heap(_heap, isLaterSource);
+    size_t sourceNumber = _heap.back();
+    _heap.pop_back();
+
+    auto& source = _sources[sourceNumber];
+    event = std::move(source.nextEvent.computerClubEvents.back());
+    line = std::move(source.nextEvent.initialEvents.back());
+    source.latestMinutes = std::max(source.latestMinutes, event.eventTime.toMinutes());
+
+    if (readNextEvent(sourceNumber, error))
+        std::ranges::push_heap(_heap, isLaterSource);
+
+    return error.errorType == ErrorType::Success;
+}
+
+// Parses the next line of a source and adds the source to the heap; false at the end of the log or on error
+bool LogMerger::readNextEvent(size_t sourceNumber, Error& error) {
+    auto& source = _sources[sourceNumber];
+    auto& events = source.nextEvent.computerClubEvents;
+    events.clear();
+    source.nextEvent.initialEvents.clear();
+
+    std::string line;
+    if (!source.txtFile->GetLine(line))
+        return false;
+
+    if (!FileParser::ParseEvent(std::move(line), source.nextEvent, error))
+        return false;
+
+    if (events.back().eventTime.toMinutes() + _reorderWindowMinutes < source.latestMinutes) {
+        error = { ErrorType::IncorrectEventTimeSequence, source.nextEvent.initialEvents.back() };
+        return false;
+    }
+
+    _heap.push_back(sourceNumber);
+    return true;
+}
+
+bool LogMerger::isLater(size_t first, size_t second) const {
+    uint16_t firstMinutes = _sources[first].nextEvent.computerClubEvents.back().eventTime.toMinutes();
+    uint16_t secondMinutes = _sources[second].nextEvent.computerClubEvents.back().eventTime.toMinutes();
+
+    return firstMinutes != secondMinutes ? firstMinutes > secondMinutes : first > second;
+}
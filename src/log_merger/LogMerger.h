@@ -0,0 +1,47 @@
+#ifndef COMPUTERCLUB_LOGMERGER_H
+#define COMPUTERCLUB_LOGMERGER_H
+
+#include "InputFileData.h"
+#include "LineReader.h"
+#include <memory>
+#include <vector>
+
+// Merges the events of several logs of one club, e.g. one per check-in terminal, into one stream in the order of
+// time. Each log has to be in the order of time itself; the logs are read line by line as the merge goes, with a
+// heap of the next event of every log. Events at the same time come from the logs in the order they were given,
+// and from one log in its own order, so the same logs always make the same day. With a reorder window the events
+// of a log may be up to that many minutes out of order, and so is the merged stream then, which is meant to go
+// through a ReorderBuffer with the same window.
+class LogMerger {
+public:
+    // Opens the logs and checks that their headers are correct and the same. Returns false with error set
+    // otherwise; for errors about a whole log errorStr is its name.
+    bool Open(const std::vector<std::string>& fileNames, Error& error, uint16_t reorderWindowMinutes = 0);
+
+    const ComputerClubFeatures& computerClubFeatures() const { return _computerClubFeatures; }
+
+    // The next event and its line. Returns false at the end of all logs, or with error set if a line is incorrect
+    // or earlier than the latest one of its log by more than the reorder window.
+    bool Next(Event& event, std::string& line, Error& error);
+
+private:
+    struct Source {
+        std::string fileName;
+        std::unique_ptr<LineReader> txtFile;
+        // The next event of the log, parsed into a one-event input
+        InputFileData nextEvent;
+        uint16_t latestMinutes{};
+    };
+
+    ComputerClubFeatures _computerClubFeatures;
+    uint16_t _reorderWindowMinutes{};
+    std::vector<Source> _sources;
+    // Sources that have an event left, as a min-heap on (time of the next event, number of the source)
+    std::vector<size_t> _heap;
+
+    bool readNextEvent(size_t sourceNumber, Error& error);
+    bool isLater(size_t first, size_t second) const;
+};
+
+
+#endif //COMPUTERCLUB_LOGMERGER_H
@@ -1,17 +1,149 @@
 #include "TaskSolver.h"
+#include "CommandLine.h"
+#include "OutputWriter.h"
+#include "PhaseProfile.h"
+#include "ResultCache.h"
+#include "LedgerSinks.h"
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+#include "ClubServer.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+#include "BatchRunner.h"
+#include <filesystem>
+#endif
+#include <fstream>
 #include <iostream>
+#include <memory>
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
+    CommandLineOptions options;
+    Error error;
+
+    CommandLine::Parse(argc, argv, options, error);
+    if (error.errorType == ErrorType::IncorrectCommandLineOption) {
+        std::cout << error.errorStr << std::endl;
+        std::cout << "The command line option or its value is incorrect!" << std::endl;
+        return static_cast<int>(ErrorType::IncorrectCommandLineOption);
+    }
+
+    std::unique_ptr<ResultCache> resultCache;
+    if (!options.cacheDirectory.empty())
+        resultCache = std::make_unique<ResultCache>(options.cacheDirectory, uintmax_t{options.cacheSizeMiB} << 20);
+
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+    if (!options.serveSocketPath.empty()) {
+        ClubServer clubServer(options.serveSocketPath, options.numberOfWorkers, options.runOptions,
+                              resultCache.get(), options.pathRoot);
+        int exitCode = clubServer.Serve();
+
+        if (resultCache)
+            std::cerr << resultCache->statsLine() << std::endl;
+        return exitCode;
+    }
+#endif
+
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+    bool isShardWorker = !options.shardManifestPath.empty() || !options.shardResultPath.empty();
+    bool isBatch = !options.batchManifestPath.empty() || !options.workDirectory.empty();
+
+    if (isShardWorker || isBatch) {
+        if (!options.fileNames.empty() || (isShardWorker && isBatch) ||
+            (isShardWorker && (options.shardManifestPath.empty() || options.shardResultPath.empty())) ||
+            (isBatch && (options.batchManifestPath.empty() || options.workDirectory.empty())))
+        {
+            std::cout << "The number of command line arguments is less or more than required!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectQuantityOfArguments);
+        }
+
+        // The merged report is made of the text reports of the logs
+        if (options.runOptions.outputFormat != OutputFormat::Text) {
+            std::cout << "--format" << std::endl;
+            std::cout << "The command line option or its value is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectCommandLineOption);
+        }
+
+        if (isShardWorker)
+            return BatchRunner::RunShard(options.shardManifestPath, options.shardResultPath, options.runOptions);
+
+        // The workers are this very program, wherever it was started from
+        std::error_code errorCode;
+        auto binaryPath = std::filesystem::read_symlink("/proc/self/exe", errorCode);
+
+        BatchRunner batchRunner({ options.batchManifestPath, options.workDirectory, options.numberOfShards,
+                                  options.numberOfWorkers, options.numberOfRetries, options.workerCommand,
+                                  errorCode ? std::string(argv[0]) : binaryPath.string(), options.runOptions });
+        return batchRunner.Run();
+    }
+#endif
+
+    // Several logs are merged into one day; the other modes take one log
+    bool isMerged = options.fileNames.size() > 1;
+    bool isTimeIndexed = options.indexCheckpointInterval != 0 || options.hasAsOfTime;
+
+    if (options.fileNames.empty() || (isMerged && isTimeIndexed)) {
         std::cout << "The number of command line arguments is less or more than required!" << std::endl;
         return static_cast<int>(ErrorType::IncorrectQuantityOfArguments);
     }
 
+    std::unique_ptr<PhaseProfile> phaseProfile;
+    if (!options.perfStatsPath.empty())
+        phaseProfile = std::make_unique<PhaseProfile>();
+
+    std::ofstream ledgerFile;
+    std::unique_ptr<LedgerSink> ledgerSink;
+    std::unique_ptr<SessionLedger> sessionLedger;
+    if (!options.ledgerPath.empty()) {
+        ledgerFile.open(options.ledgerPath, std::ios::binary | std::ios::trunc);
+        if (!ledgerFile.is_open()) {
+            std::cout << options.ledgerPath << std::endl;
+            std::cout << "The file is not open!" << std::endl;
+            return static_cast<int>(ErrorType::FileIsNotOpen);
+        }
+
+        if (options.isLedgerCsv)
+            ledgerSink = std::make_unique<CsvLedgerSink>(ledgerFile);
+        else
+            ledgerSink = std::make_unique<ColumnarLedgerSink>(ledgerFile);
+        sessionLedger = std::make_unique<SessionLedger>(*ledgerSink);
+    }
+
+    OutputWriter outputWriter(std::cout);
+    int exitCode;
+
     try {
-        TaskSolver taskSolver;
-        return taskSolver.run(argv[argc - 1]);
+        TaskSolver taskSolver(&outputWriter, options.runOptions, resultCache.get(), phaseProfile.get(),
+                              sessionLedger.get());
+        const auto& fileName = options.fileNames.front();
+
+        if (isMerged) {
+            exitCode = taskSolver.runMerged(options.fileNames);
+        } else if (!isTimeIndexed) {
+            exitCode = taskSolver.run(fileName);
+        } else {
+            exitCode = 0;
+            if (options.indexCheckpointInterval != 0)
+                exitCode = taskSolver.buildTimeIndex(fileName, options.indexCheckpointInterval);
+            if (exitCode == 0 && options.hasAsOfTime)
+                exitCode = taskSolver.runAsOf(fileName, options.asOfTime);
+        }
     } catch (const std::exception& exception) {
+        outputWriter.Flush();
         std::cout << "Caught an unexpected exception: " << exception.what() << std::endl;
-        return static_cast<int>(ErrorType::UnexpectedError);
+        exitCode = static_cast<int>(ErrorType::UnexpectedError);
+    }
+
+    // The report on stdout stays the same with and without the cache and the counters
+    if (resultCache) {
+        outputWriter.Flush();
+        std::cerr << resultCache->statsLine() << std::endl;
     }
+
+    if (phaseProfile) {
+        if (options.perfStatsPath == "-")
+            std::cerr << phaseProfile->ToJson();
+        else
+            std::ofstream(options.perfStatsPath) << phaseProfile->ToJson();
+    }
+
+    return exitCode;
 }
@@ -0,0 +1,110 @@
+#include "PerfCounters.h"
+#include <chrono>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct CounterConfig {
+    uint32_t type;
+    uint64_t config;
+    // Tried when the PMU has no event for the first one
+    uint32_t fallbackType;
+    uint64_t fallbackConfig;
+};
+
+constexpr uint64_t cacheMissConfig(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr std::array<CounterConfig, PerfCounters::NUMBER_OF_COUNTERS> COUNTER_CONFIGS = {{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D),
+      PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D) },
+    // The generic cache-miss event is the last level cache on x86 and most ARM cores
+    { PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_LL), PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+}};
+
+}
+
+PerfCounters::PerfCounters() {
+    _fds.fill(-1);
+
+    auto open = [](uint32_t type, uint64_t config) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        // Threads started later on, e.g. the block reader and the OutputWriter, are counted too
+        attributes.inherit = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    };
+
+    for (size_t counter = 0; counter < NUMBER_OF_COUNTERS; counter++) {
+        const auto& config = COUNTER_CONFIGS[counter];
+
+        int fd = open(config.type, config.config);
+        if (fd < 0 && (config.fallbackType != config.type || config.fallbackConfig != config.config))
+            fd = open(config.fallbackType, config.fallbackConfig);
+
+        if (fd < 0 && _unavailableReason.empty())
+            _unavailableReason = std::string(COUNTER_NAMES[counter]) + ": " + std::strerror(errno);
+
+        _fds[counter] = fd;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : _fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+PerfCounters::Sample PerfCounters::Read() const {
+    Sample sample;
+    sample.wallNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    for (size_t counter = 0; counter < NUMBER_OF_COUNTERS; counter++) {
+        // value, time enabled, time running
+        uint64_t data[3]{};
+        if (_fds[counter] < 0 || read(_fds[counter], data, sizeof(data)) != sizeof(data))
+            continue;
+
+        sample.values[counter] = data[2] == 0 ? 0 :
+                                 static_cast<uint64_t>(static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                                                       static_cast<double>(data[2]));
+    }
+
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() : _unavailableReason("perf_event_open is not supported on this platform") {
+    _fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+PerfCounters::Sample PerfCounters::Read() const {
+    Sample sample;
+    sample.wallNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch()).count());
+    return sample;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef COMPUTERCLUB_PERFCOUNTERS_H
+#define COMPUTERCLUB_PERFCOUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Hardware counters of the calling thread and of the threads it starts after the construction (user space only)
+// through perf_event_open. Every counter is opened on its own, so a PMU or a container that lacks some of them
+// still gives the rest; on other platforms, or where perf_event_open is forbidden, no counter is available and
+// only the wall time is measured.
+class PerfCounters {
+public:
+    enum Counter {
+        Cycles,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        BranchMisses,
+        NUMBER_OF_COUNTERS,
+    };
+
+    static constexpr std::array<std::string_view, NUMBER_OF_COUNTERS> COUNTER_NAMES = {
+        "cycles", "instructions", "l1dMisses", "llcMisses", "branchMisses",
+    };
+
+    struct Sample {
+        std::array<uint64_t, NUMBER_OF_COUNTERS> values{};
+        uint64_t wallNs{};
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool isAvailable(Counter counter) const { return _fds[counter] >= 0; }
+    // Why the first unavailable counter couldn't be opened; empty if all of them are counting
+    const std::string& unavailableReason() const { return _unavailableReason; }
+
+    // Values since construction, scaled up if the kernel had to multiplex the counters
+    Sample Read() const;
+
+private:
+    std::array<int, NUMBER_OF_COUNTERS> _fds;
+    std::string _unavailableReason;
+};
+
+
+#endif //COMPUTERCLUB_PERFCOUNTERS_H
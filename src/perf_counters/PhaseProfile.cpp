@@ -0,0 +1,95 @@
+#include "PhaseProfile.h"
+#include "TextFormat.h"
+#include <charconv>
+
+namespace {
+
+void appendDouble(std::string& output, double number) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number, std::chars_format::fixed, 3);
+    output.append(buffer, result.ptr);
+}
+
+void appendString(std::string& output, std::string_view text) {
+    output.push_back('"');
+    for (char symbol : text) {
+        if (symbol == '"' || symbol == '\\')
+            output.push_back('\\');
+        output.push_back(symbol);
+    }
+    output.push_back('"');
+}
+
+}
+
+void PhaseProfile::add(Phase phase, const PerfCounters::Sample& start, const PerfCounters::Sample& stop) {
+    auto& total = _totals[phase];
+
+    for (size_t counter = 0; counter < PerfCounters::NUMBER_OF_COUNTERS; counter++)
+        total.values[counter] += stop.values[counter] - start.values[counter];
+    total.wallNs += stop.wallNs - start.wallNs;
+}
+
+std::string PhaseProfile::ToJson() const {
+    bool isAnyAvailable = false;
+    for (size_t counter = 0; counter < PerfCounters::NUMBER_OF_COUNTERS; counter++)
+        isAnyAvailable |= _perfCounters.isAvailable(static_cast<PerfCounters::Counter>(counter));
+
+    std::string json = "{\"countersAvailable\": ";
+    json.append(isAnyAvailable ? "true" : "false").append(", \"unavailableReason\": ");
+    if (_perfCounters.unavailableReason().empty())
+        json.append("null");
+    else
+        appendString(json, _perfCounters.unavailableReason());
+    json.append(", \"events\": ");
+    appendNumber(json, _numberOfEvents);
+    json.append(", \"phases\": [");
+
+    const double events = _numberOfEvents == 0 ? 1.0 : static_cast<double>(_numberOfEvents);
+
+    for (size_t phase = 0; phase < NUMBER_OF_PHASES; phase++) {
+        const auto& total = _totals[phase];
+
+        json.append(phase == 0 ? "\n  {" : ",\n  {").append("\"name\": ");
+        appendString(json, PHASE_NAMES[phase]);
+        json.append(", \"wallNs\": ");
+        appendNumber(json, total.wallNs);
+
+        std::string perEvent = "\"perEvent\": {\"wallNs\": ";
+        appendDouble(perEvent, static_cast<double>(total.wallNs) / events);
+
+        for (size_t counter = 0; counter < PerfCounters::NUMBER_OF_COUNTERS; counter++) {
+            bool isAvailable = _perfCounters.isAvailable(static_cast<PerfCounters::Counter>(counter));
+
+            json.append(", ");
+            appendString(json, PerfCounters::COUNTER_NAMES[counter]);
+            json.append(": ");
+            perEvent.append(", ");
+            appendString(perEvent, PerfCounters::COUNTER_NAMES[counter]);
+            perEvent.append(": ");
+
+            if (isAvailable) {
+                appendNumber(json, total.values[counter]);
+                appendDouble(perEvent, static_cast<double>(total.values[counter]) / events);
+            } else {
+                json.append("null");
+                perEvent.append("null");
+            }
+        }
+
+        json.append(", \"ipc\": ");
+        if (_perfCounters.isAvailable(PerfCounters::Cycles) && _perfCounters.isAvailable(PerfCounters::Instructions) &&
+            total.values[PerfCounters::Cycles] != 0)
+        {
+            appendDouble(json, static_cast<double>(total.values[PerfCounters::Instructions]) /
+                               static_cast<double>(total.values[PerfCounters::Cycles]));
+        } else {
+            json.append("null");
+        }
+
+        json.append(", ").append(perEvent).append("}}");
+    }
+
+    json.append("\n]}\n");
+    return json;
+}
@@ -0,0 +1,62 @@
+#ifndef COMPUTERCLUB_PHASEPROFILE_H
+#define COMPUTERCLUB_PHASEPROFILE_H
+
+#include "PerfCounters.h"
+#include <array>
+#include <string>
+
+// Hardware counters and wall time split by the phases of a run, accumulated over any number of runs. The background
+// threads of a run, the block reader of Parse and the OutputWriter of Output, are counted towards the phase they
+// work in, provided that the profile is made before they are started.
+class PhaseProfile {
+public:
+    enum Phase {
+        Parse,
+        SequenceCheck,
+        Dispatch,
+        Close,
+        Output,
+        NUMBER_OF_PHASES,
+    };
+
+    static constexpr std::array<std::string_view, NUMBER_OF_PHASES> PHASE_NAMES = {
+        "parse", "sequenceCheck", "dispatch", "close", "output",
+    };
+
+    // Counts the enclosing block towards a phase; does nothing without a profile
+    class Scope {
+    public:
+        Scope(PhaseProfile* profile, Phase phase) : _profile(profile), _phase(phase) {
+            if (_profile)
+                _start = _profile->_perfCounters.Read();
+        }
+        ~Scope() {
+            if (_profile)
+                _profile->add(_phase, _start, _profile->_perfCounters.Read());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PhaseProfile* _profile;
+        Phase _phase;
+        PerfCounters::Sample _start;
+    };
+
+    void AddEvents(size_t numberOfEvents) { _numberOfEvents += numberOfEvents; }
+
+    // {"countersAvailable": ..., "unavailableReason": ..., "events": ..., "phases": [{"name": ..., "wallNs": ...,
+    //  "cycles": ..., ..., "ipc": ..., "perEvent": {...}}, ...]}. Counters that aren't available are null.
+    std::string ToJson() const;
+
+private:
+    PerfCounters _perfCounters;
+    std::array<PerfCounters::Sample, NUMBER_OF_PHASES> _totals{};
+    size_t _numberOfEvents{};
+
+    void add(Phase phase, const PerfCounters::Sample& start, const PerfCounters::Sample& stop);
+};
+
+
+#endif //COMPUTERCLUB_PHASEPROFILE_H
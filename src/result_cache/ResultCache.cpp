@@ -0,0 +1,225 @@
+#include "ResultCache.h"
+#include "TextFormat.h"
+#include "XxHash64.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// The first line of an entry: "<magic> <engine version> <input size> <exit code> <report size>"
+constexpr std::string_view ENTRY_MAGIC = "YCCRESULT";
+
+bool parseField(std::string_view& header, auto& value) {
+    auto [ptr, ec] = std::from_chars(header.data(), header.data() + header.size(), value);
+    if (ec != std::errc())
+        return false;
+
+    header.remove_prefix(static_cast<size_t>(ptr - header.data()));
+    if (!header.empty() && header.front() == ' ')
+        header.remove_prefix(1);
+    return true;
+}
+
+}
+
+ResultCache::ResultCache(fs::path directory, uintmax_t sizeLimit) : _directory(std::move(directory)),
+                                                                    _sizeLimit(sizeLimit)
+{
+    std::error_code errorCode;
+    fs::create_directories(_directory, errorCode);
+    _size = scanEntries();
+}
+
+ResultCache::Key ResultCache::MakeKey(std::string_view content, uint32_t reportVariant) {
+    return { XxHash64::hash(content, ENGINE_VERSION | uint64_t{reportVariant} << 32), content.size() };
+}
+
+bool ResultCache::Find(const Key& key, int& exitCode, std::string& report) {
+    fs::path path = entryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        _misses++;
+        return false;
+    }
+
+    std::error_code errorCode;
+    uintmax_t fileSize = fs::file_size(path, errorCode);
+    std::string header;
+    uint32_t engineVersion = 0;
+    size_t inputSize = 0, reportSize = 0;
+
+    bool isEntry = !errorCode && std::getline(file, header) && header.size() > ENTRY_MAGIC.size() &&
+                   header.starts_with(ENTRY_MAGIC) && header[ENTRY_MAGIC.size()] == ' ';
+    if (isEntry) {
+        std::string_view fields = std::string_view(header).substr(ENTRY_MAGIC.size() + 1);
+        uintmax_t headerSize = header.size() + 1;
+
+        isEntry = parseField(fields, engineVersion) && parseField(fields, inputSize) &&
+                  parseField(fields, exitCode) && parseField(fields, reportSize) &&
+                  fileSize >= headerSize && reportSize <= fileSize - headerSize;
+    }
+
+    // A damaged entry would be a miss on every run from now on, so it is removed
+    if (!isEntry) {
+        file.close();
+        fs::remove(path, errorCode);
+        _misses++;
+        return false;
+    }
+
+    if (engineVersion != ENGINE_VERSION || inputSize != key.inputSize) {
+        _misses++;
+        return false;
+    }
+
+    report.resize(reportSize);
+    if (!file.read(report.data(), static_cast<std::streamsize>(reportSize))) {
+        _misses++;
+        return false;
+    }
+
+    // The modification time is the time of the last use, which the eviction goes by
+    fs::last_write_time(path, fs::file_time_type::clock::now(), errorCode);
+
+    _hits++;
+    return true;
+}
+
+void ResultCache::Store(const Key& key, int exitCode, std::string_view report) {
+    fs::path path = entryPath(key);
+
+    // A name no other writer uses, in the same directory so that the rename is atomic
+    std::ostringstream temporaryName;
+    temporaryName << path.filename().string() << '.' << std::this_thread::get_id() << '.'
+                  << fs::file_time_type::clock::now().time_since_epoch().count() << ".tmp";
+    fs::path temporaryPath = _directory / temporaryName.str();
+
+    std::string header(ENTRY_MAGIC);
+    header.push_back(' ');
+    appendNumber(header, ENGINE_VERSION);
+    header.push_back(' ');
+    appendNumber(header, key.inputSize);
+    header.append(" ").append(std::to_string(exitCode)).push_back(' ');
+    appendNumber(header, report.size());
+    header.push_back('\n');
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(report.data(), static_cast<std::streamsize>(report.size()));
+
+        if (!file.flush()) {
+            file.close();
+            std::error_code errorCode;
+            fs::remove(temporaryPath, errorCode);
+            return;
+        }
+    }
+
+    std::error_code errorCode;
+    fs::rename(temporaryPath, path, errorCode);
+    if (errorCode) {
+        fs::remove(temporaryPath, errorCode);
+        return;
+    }
+
+    _stores++;
+    if ((_size += header.size() + report.size()) > _sizeLimit)
+        evict();
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    return { _hits, _misses, _stores, _evictions };
+}
+
+std::string ResultCache::statsLine() const {
+    Stats current = stats();
+    size_t lookups = current.hits + current.misses;
+    size_t hitRate = lookups == 0 ? 0 : (current.hits * 1000 + lookups / 2) / lookups;
+
+    std::string line = "Result cache: ";
+    appendNumber(line, current.hits);
+    line.append(" hits, ");
+    appendNumber(line, current.misses);
+    line.append(" misses, hit rate ");
+    appendNumber(line, hitRate / 10);
+    line.push_back('.');
+    appendNumber(line, hitRate % 10);
+    line.append("%, ");
+    appendNumber(line, current.stores);
+    line.append(" stored, ");
+    appendNumber(line, current.evictions);
+    line.append(" evicted");
+
+    return line;
+}
+
+fs::path ResultCache::entryPath(const Key& key) const {
+    char hash[16];
+    auto result = std::to_chars(hash, hash + sizeof(hash), key.hash, 16);
+
+    std::string name = "v" + std::to_string(ENGINE_VERSION) + "-";
+    name.append(sizeof(hash) - static_cast<size_t>(result.ptr - hash), '0').append(hash, result.ptr)
+        .append(ENTRY_EXTENSION);
+    return _directory / name;
+}
+
+uintmax_t ResultCache::scanEntries() {
+    uintmax_t size = 0;
+    std::error_code errorCode;
+
+    for (const auto& entry : fs::directory_iterator(_directory, errorCode)) {
+        if (entry.path().extension() == ENTRY_EXTENSION)
+            size += entry.file_size(errorCode);
+    }
+
+    return size;
+}
+
+void ResultCache::evict() {
+    std::lock_guard lock(_evictionMutex);
+
+    struct Entry {
+        fs::path path;
+        uintmax_t size;
+        fs::file_time_type lastUse;
+    };
+
+    // Other processes share the directory, so the actual entries are listed rather than trusted to the estimate
+    std::vector<Entry> entries;
+    uintmax_t size = 0;
+    std::error_code errorCode;
+
+    for (const auto& entry : fs::directory_iterator(_directory, errorCode)) {
+        if (entry.path().extension() != ENTRY_EXTENSION)
+            continue;
+
+        Entry current{ entry.path(), entry.file_size(errorCode), entry.last_write_time(errorCode) };
+        if (!errorCode) {
+            size += current.size;
+            entries.push_back(std::move(current));
+        }
+    }
+
+    // Down to 90% of the limit, so that the next few stores don't trigger another scan
+    uintmax_t target = _sizeLimit / 10 * 9;
+    std::ranges::sort(entries, {}, &Entry::lastUse);
+
+    for (const auto& entry : entries) {
+        if (size <= target)
+            break;
+
+        if (fs::remove(entry.path, errorCode)) {
+            size -= entry.size;
+            _evictions++;
+        }
+    }
+
+    _size = size;
+}
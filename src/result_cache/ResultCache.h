@@ -0,0 +1,65 @@
+#ifndef COMPUTERCLUB_RESULTCACHE_H
+#define COMPUTERCLUB_RESULTCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// On-disk cache of reports keyed by the content of the input file. An entry is looked up by the XXH64 hash of
+// the input bytes and the engine version, so a log that hasn't changed is answered without being parsed.
+// Entries are written to a temporary file and renamed into place, which keeps the cache consistent when several
+// processes fill it at once. When the entries outgrow the size limit, the least recently used ones are removed.
+class ResultCache {
+public:
+    // Bump whenever the report for the same input may change, so that old entries are never matched
+    static constexpr uint32_t ENGINE_VERSION = 1;
+    static constexpr std::string_view ENTRY_EXTENSION = ".result";
+
+    struct Key {
+        uint64_t hash{};
+        size_t inputSize{};
+    };
+
+    struct Stats {
+        size_t hits{};
+        size_t misses{};
+        size_t stores{};
+        size_t evictions{};
+    };
+
+    ResultCache(std::filesystem::path directory, uintmax_t sizeLimit);
+
+    // reportVariant tells apart the reports of the same content under options that change them
+    static Key MakeKey(std::string_view content, uint32_t reportVariant = 0);
+
+    // Returns false on a miss. The cache never fails a run, so any I/O error is a miss as well.
+    bool Find(const Key& key, int& exitCode, std::string& report);
+    void Store(const Key& key, int exitCode, std::string_view report);
+
+    Stats stats() const;
+    // "Result cache: <hits> hits, <misses> misses, hit rate <percent>%, <stores> stored, <evictions> evicted"
+    std::string statsLine() const;
+
+private:
+    std::filesystem::path _directory;
+    uintmax_t _sizeLimit;
+
+    // Estimate of the size of the entries, corrected by every eviction scan
+    std::atomic<uintmax_t> _size{0};
+    std::mutex _evictionMutex;
+
+    std::atomic<size_t> _hits{0};
+    std::atomic<size_t> _misses{0};
+    std::atomic<size_t> _stores{0};
+    std::atomic<size_t> _evictions{0};
+
+    std::filesystem::path entryPath(const Key& key) const;
+    uintmax_t scanEntries();
+    void evict();
+};
+
+
+#endif //COMPUTERCLUB_RESULTCACHE_H
@@ -0,0 +1,85 @@
+#ifndef COMPUTERCLUB_XXHASH64_H
+#define COMPUTERCLUB_XXHASH64_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// XXH64 (https://github.com/Cyan4973/xxHash) — a non-cryptographic hash that runs at memory bandwidth
+namespace XxHash64 {
+
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const char* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input) {
+    return rotateLeft(accumulator + input * PRIME2, 31) * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+    return (accumulator ^ round(0, value)) * PRIME1 + PRIME4;
+}
+
+// Little-endian input is assumed, as on every platform the project is built for
+inline uint64_t hash(std::string_view data, uint64_t seed = 0) {
+    const char* pos = data.data();
+    const char* end = pos + data.size();
+    uint64_t result;
+
+    if (data.size() >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2, v2 = seed + PRIME2, v3 = seed, v4 = seed - PRIME1;
+
+        for (; end - pos >= 32; pos += 32) {
+            v1 = round(v1, read64(pos));
+            v2 = round(v2, read64(pos + 8));
+            v3 = round(v3, read64(pos + 16));
+            v4 = round(v4, read64(pos + 24));
+        }
+
+        result = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        result = mergeRound(mergeRound(mergeRound(mergeRound(result, v1), v2), v3), v4);
+    } else {
+        result = seed + PRIME5;
+    }
+
+    result += data.size();
+
+    for (; end - pos >= 8; pos += 8)
+        result = rotateLeft(result ^ round(0, read64(pos)), 27) * PRIME1 + PRIME4;
+    if (end - pos >= 4) {
+        result = rotateLeft(result ^ (read32(pos) * PRIME1), 23) * PRIME2 + PRIME3;
+        pos += 4;
+    }
+    for (; pos < end; pos++)
+        result = rotateLeft(result ^ (static_cast<uint8_t>(*pos) * PRIME5), 11) * PRIME1;
+
+    result ^= result >> 33;
+    result *= PRIME2;
+    result ^= result >> 29;
+    result *= PRIME3;
+    result ^= result >> 32;
+
+    return result;
+}
+
+}
+
+#endif //COMPUTERCLUB_XXHASH64_H
@@ -0,0 +1,168 @@
+#include "LedgerSinks.h"
+#include "TextFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+using Visit = SessionLedger::Visit;
+
+// Calls visitor with an accessor of every column in the order of the file
+template <typename Visitor>
+void forEachColumn(Visitor&& visitor) {
+    visitor([](auto& visit) -> auto& { return visit.nameOffset; });
+    visitor([](auto& visit) -> auto& { return visit.nameLength; });
+    visitor([](auto& visit) -> auto& { return visit.arrival; });
+    visitor([](auto& visit) -> auto& { return visit.queueEntry; });
+    visitor([](auto& visit) -> auto& { return visit.queueExit; });
+    visitor([](auto& visit) -> auto& { return visit.departure; });
+    visitor([](auto& visit) -> auto& { return visit.reason; });
+    visitor([](auto& visit) -> auto& { return visit.numberOfSeats; });
+
+    for (size_t seat = 0; seat < SessionLedger::MAX_SEATS; seat++) {
+        visitor([seat](auto& visit) -> auto& { return visit.seats[seat].table; });
+        visitor([seat](auto& visit) -> auto& { return visit.seats[seat].start; });
+        visitor([seat](auto& visit) -> auto& { return visit.seats[seat].end; });
+    }
+
+    visitor([](auto& visit) -> auto& { return visit.billedHours; });
+    visitor([](auto& visit) -> auto& { return visit.billed; });
+}
+
+template <typename Field>
+using ColumnType = std::remove_cvref_t<std::invoke_result_t<Field, const Visit&>>;
+
+// Sizes come from the file, so the buffer grows a chunk at a time as the bytes really arrive, and a damaged size
+// fails at the end of the stream instead of allocating all of it up front
+constexpr size_t READ_CHUNK_SIZE = size_t{1} << 20;
+
+bool readExactly(std::istream& stream, std::string& buffer, size_t size) {
+    buffer.clear();
+    while (buffer.size() < size) {
+        size_t offset = buffer.size();
+        buffer.resize(offset + std::min(size - offset, READ_CHUNK_SIZE));
+        if (!stream.read(buffer.data() + offset, static_cast<std::streamsize>(buffer.size() - offset)))
+            return false;
+    }
+
+    return true;
+}
+
+void appendUint32(std::string& output, uint32_t value) {
+    output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendTime(std::string& output, uint16_t minutes) {
+    if (minutes != SessionLedger::NO_TIME)
+        Time::fromMinutes(minutes).appendTo(output);
+}
+
+}
+
+void CsvLedgerSink::Write(const SessionLedger::Batch& batch) {
+    _buffer.clear();
+    if (!_isHeaderWritten) {
+        _buffer.append(CSV_HEADER);
+        _isHeaderWritten = true;
+    }
+
+    for (const auto& visit : batch.visits) {
+        _buffer.append(batch.name(visit)).push_back(',');
+        for (uint16_t time : { visit.arrival, visit.queueEntry, visit.queueExit, visit.departure }) {
+            appendTime(_buffer, time);
+            _buffer.push_back(',');
+        }
+
+        _buffer.append(REASON_NAMES[static_cast<size_t>(visit.reason)]).push_back(',');
+        appendNumber(_buffer, visit.numberOfSeats);
+        _buffer.push_back(',');
+
+        for (size_t seat = 0; seat < std::min<size_t>(visit.numberOfSeats, SessionLedger::MAX_SEATS); seat++) {
+            if (seat != 0)
+                _buffer.push_back(' ');
+            appendNumber(_buffer, visit.seats[seat].table);
+            _buffer.push_back('@');
+            appendTime(_buffer, visit.seats[seat].start);
+            _buffer.push_back('-');
+            appendTime(_buffer, visit.seats[seat].end);
+        }
+        _buffer.push_back(',');
+
+        appendNumber(_buffer, visit.billedHours);
+        _buffer.push_back(',');
+        appendNumber(_buffer, visit.billed);
+        _buffer.push_back('\n');
+    }
+
+    _stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+}
+
+void ColumnarLedgerSink::Write(const SessionLedger::Batch& batch) {
+    _buffer.clear();
+    if (!_isMagicWritten) {
+        _buffer.append(MAGIC);
+        _isMagicWritten = true;
+    }
+
+    appendUint32(_buffer, static_cast<uint32_t>(batch.visits.size()));
+    appendUint32(_buffer, static_cast<uint32_t>(batch.names.size()));
+    _buffer.append(batch.names);
+
+    forEachColumn([this, &batch]<typename Field>(Field field) {
+        using Type = ColumnType<Field>;
+
+        size_t offset = _buffer.size();
+        _buffer.resize(offset + batch.visits.size() * sizeof(Type));
+        for (const auto& visit : batch.visits) {
+            std::memcpy(_buffer.data() + offset, &field(visit), sizeof(Type));
+            offset += sizeof(Type);
+        }
+    });
+
+    _stream.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+}
+
+bool ColumnarLedgerReader::Next(SessionLedger::Batch& batch) {
+    if (!_isMagicRead) {
+        _buffer.resize(ColumnarLedgerSink::MAGIC.size());
+        if (!_stream.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size())) ||
+            _buffer != ColumnarLedgerSink::MAGIC)
+        {
+            return false;
+        }
+        _isMagicRead = true;
+    }
+
+    uint32_t numberOfVisits, namesSize;
+    if (!_stream.read(reinterpret_cast<char*>(&numberOfVisits), sizeof(numberOfVisits)) ||
+        !_stream.read(reinterpret_cast<char*>(&namesSize), sizeof(namesSize)))
+    {
+        return false;
+    }
+
+    size_t visitSize = 0;
+    forEachColumn([&visitSize]<typename Field>(Field) { visitSize += sizeof(ColumnType<Field>); });
+
+    if (!readExactly(_stream, _buffer, namesSize + size_t{numberOfVisits} * visitSize))
+        return false;
+
+    batch.names.assign(_buffer, 0, namesSize);
+    batch.visits.assign(numberOfVisits, {});
+
+    size_t offset = namesSize;
+    forEachColumn([this, &batch, &offset]<typename Field>(Field field) {
+        for (auto& visit : batch.visits) {
+            std::memcpy(&field(visit), _buffer.data() + offset, sizeof(ColumnType<Field>));
+            offset += sizeof(ColumnType<Field>);
+        }
+    });
+
+    // A name out of the names would be read past them
+    for (const auto& visit : batch.visits) {
+        if (size_t{visit.nameOffset} + visit.nameLength > namesSize)
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef COMPUTERCLUB_LEDGERSINKS_H
+#define COMPUTERCLUB_LEDGERSINKS_H
+
+#include "SessionLedger.h"
+#include <iostream>
+
+// CSV_HEADER and then a line per visit, e.g.
+// alice,09:00,,,11:08,voluntary,2,1@09:05-09:08 2@09:08-11:08,3,30
+// Times that didn't happen are empty, and seats lists the stored seat intervals as <table>@<start>-<end>.
+class CsvLedgerSink : public LedgerSink {
+public:
+    static constexpr std::string_view CSV_HEADER =
+        "client,arrival,queue_entry,queue_exit,departure,reason,number_of_seats,seats,billed_hours,billed\n";
+    static constexpr std::string_view REASON_NAMES[] = { "voluntary", "queue_overflow", "closing" };
+
+    explicit CsvLedgerSink(std::ostream& stream) : _stream(stream) { }
+
+    void Write(const SessionLedger::Batch& batch) override;
+
+private:
+    std::ostream& _stream;
+    bool _isHeaderWritten{false};
+    // Keeps its capacity between batches
+    std::string _buffer;
+};
+
+// Binary and columnar: MAGIC once, then per batch the number of visits and the size of the names as uint32, the
+// names, and every field of SessionLedger::Visit as a column of its own in the order of declaration, seats[i] as
+// the table, start and end columns of seat i. Numbers are in the byte order of the machine. A column of a field
+// compresses well and can be read alone, and a batch takes one write.
+class ColumnarLedgerSink : public LedgerSink {
+public:
+    static constexpr std::string_view MAGIC = "CLUBLDG1";
+
+    explicit ColumnarLedgerSink(std::ostream& stream) : _stream(stream) { }
+
+    void Write(const SessionLedger::Batch& batch) override;
+
+private:
+    std::ostream& _stream;
+    bool _isMagicWritten{false};
+    std::string _buffer;
+};
+
+// Reads back what ColumnarLedgerSink writes, a batch at a time
+class ColumnarLedgerReader {
+public:
+    explicit ColumnarLedgerReader(std::istream& stream) : _stream(stream) { }
+
+    // Returns false at the end of the stream, and if it isn't a ledger, is cut off or has a damaged batch
+    bool Next(SessionLedger::Batch& batch);
+
+private:
+    std::istream& _stream;
+    bool _isMagicRead{false};
+    std::string _buffer;
+};
+
+
+#endif //COMPUTERCLUB_LEDGERSINKS_H
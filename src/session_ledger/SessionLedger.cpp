@@ -0,0 +1,88 @@
+#include "SessionLedger.h"
+#include "Constants.h"
+
+void SessionLedger::Open(size_t costPerHour) {
+    _costPerHour = costPerHour;
+    _openVisits.clear();
+}
+
+void SessionLedger::Arrive(std::string_view client, const Time& time) {
+    auto& visit = _openVisits.emplace(client, OpenVisit{}).first->second.visit;
+    visit.arrival = time.toMinutes();
+}
+
+void SessionLedger::Wait(std::string_view client, const Time& time) {
+    auto it = _openVisits.find(client);
+    if (it != _openVisits.end())
+        it->second.visit.queueEntry = time.toMinutes();
+}
+
+void SessionLedger::Sit(std::string_view client, size_t table, const Time& time) {
+    auto it = _openVisits.find(client);
+    if (it == _openVisits.end())
+        return;
+
+    auto& [visit, seat] = it->second;
+    uint16_t minutes = time.toMinutes();
+
+    if (seat.table != 0)
+        endSeat(it->second, minutes);
+    if (visit.queueEntry != NO_TIME && visit.queueExit == NO_TIME)
+        visit.queueExit = minutes;
+
+    seat = { static_cast<uint32_t>(table), minutes, minutes };
+}
+
+void SessionLedger::Leave(std::string_view client, const Time& time, DepartureReason reason) {
+    auto it = _openVisits.find(client);
+    if (it == _openVisits.end())
+        return;
+
+    auto& visit = it->second.visit;
+    uint16_t minutes = time.toMinutes();
+
+    if (it->second.seat.table != 0)
+        endSeat(it->second, minutes);
+    if (visit.queueEntry != NO_TIME && visit.queueExit == NO_TIME)
+        visit.queueExit = minutes;
+
+    visit.departure = minutes;
+    visit.reason = reason;
+    visit.nameOffset = static_cast<uint32_t>(_batch.names.size());
+    visit.nameLength = static_cast<uint16_t>(client.size());
+    _batch.names.append(client);
+    _batch.visits.push_back(visit);
+
+    _openVisits.erase(it);
+    _numberOfVisits++;
+
+    if (_batch.visits.size() >= _batchSize)
+        flush();
+}
+
+void SessionLedger::Close() {
+    flush();
+}
+
+void SessionLedger::endSeat(OpenVisit& openVisit, uint16_t time) const {
+    auto& [visit, seat] = openVisit;
+    seat.end = time;
+
+    uint32_t hours = (seat.end - seat.start + MINUTES_IN_HOUR - 1) / MINUTES_IN_HOUR;
+    visit.billedHours += hours;
+    visit.billed += hours * _costPerHour;
+
+    if (visit.numberOfSeats < MAX_SEATS)
+        visit.seats[visit.numberOfSeats] = seat;
+    visit.numberOfSeats++;
+    seat.table = 0;
+}
+
+void SessionLedger::flush() {
+    if (_batch.visits.empty())
+        return;
+
+    _sink.Write(_batch);
+    _batch.visits.clear();
+    _batch.names.clear();
+}
@@ -0,0 +1,108 @@
+#ifndef COMPUTERCLUB_SESSIONLEDGER_H
+#define COMPUTERCLUB_SESSIONLEDGER_H
+
+#include "InputFileData.h"
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class LedgerSink;
+
+// A record per visit of a client, from arrival to departure, that EventHandler keeps while it handles the day.
+// Only the visits in progress are held: a finished visit goes into the current batch, and the batch goes to the
+// sink once it is full and at closing, so memory depends on how many clients are in the club at once, not on how
+// many visits the day has. A visit starts with an accepted arrival; clients who are turned away have none.
+class SessionLedger {
+public:
+    static constexpr uint16_t NO_TIME = 0xFFFF;
+    static constexpr size_t MAX_SEATS = 4;
+    static constexpr size_t BATCH_SIZE = 4096;
+
+    enum class DepartureReason : uint8_t {
+        // The client has gone away, event 4
+        Voluntary,
+        // The client wanted to wait while the queue was full, event 11 on event 3
+        QueueOverflow,
+        // The client was still there at closing time, event 11
+        Closing,
+    };
+
+    struct Seat {
+        // 1-based, as in the log
+        uint32_t table{};
+        uint16_t start{};
+        uint16_t end{};
+    };
+
+    // Fixed-size, with times in minutes since midnight and NO_TIME for what didn't happen. The name is kept in the
+    // names of the batch.
+    struct Visit {
+        uint32_t nameOffset{};
+        uint16_t nameLength{};
+        uint16_t arrival{NO_TIME};
+        uint16_t queueEntry{NO_TIME};
+        uint16_t queueExit{NO_TIME};
+        uint16_t departure{NO_TIME};
+        DepartureReason reason{};
+        // All the seat intervals of the visit, of which the first MAX_SEATS are in seats
+        uint16_t numberOfSeats{};
+        std::array<Seat, MAX_SEATS> seats{};
+        // Every seat interval is billed by the started hour, as the tables are
+        uint32_t billedHours{};
+        uint64_t billed{};
+    };
+
+    struct Batch {
+        std::vector<Visit> visits;
+        std::string names;
+
+        std::string_view name(const Visit& visit) const {
+            return { names.data() + visit.nameOffset, visit.nameLength };
+        }
+    };
+
+    explicit SessionLedger(LedgerSink& sink, size_t batchSize = BATCH_SIZE) : _sink(sink), _batchSize(batchSize) { }
+
+    // Starts a day; visits left over from a day that has failed are dropped
+    void Open(size_t costPerHour);
+    void Arrive(std::string_view client, const Time& time);
+    void Wait(std::string_view client, const Time& time);
+    // Ends the seat interval of the client if there is one
+    void Sit(std::string_view client, size_t table, const Time& time);
+    void Leave(std::string_view client, const Time& time, DepartureReason reason);
+    // Hands the visits finished since the last batch to the sink
+    void Close();
+
+    uint64_t numberOfVisits() const { return _numberOfVisits; }
+    size_t numberOfOpenVisits() const { return _openVisits.size(); }
+
+private:
+    struct OpenVisit {
+        Visit visit;
+        // The table is 0 while the client isn't seated
+        Seat seat;
+    };
+
+    LedgerSink& _sink;
+    size_t _batchSize;
+    size_t _costPerHour{};
+    std::map<std::string, OpenVisit, std::less<>> _openVisits;
+    Batch _batch;
+    uint64_t _numberOfVisits{};
+
+    void endSeat(OpenVisit& openVisit, uint16_t time) const;
+    void flush();
+};
+
+// Where the batches of a ledger go; one implementation per format, see LedgerSinks.h
+class LedgerSink {
+public:
+    virtual ~LedgerSink() = default;
+
+    virtual void Write(const SessionLedger::Batch& batch) = 0;
+};
+
+
+#endif //COMPUTERCLUB_SESSIONLEDGER_H
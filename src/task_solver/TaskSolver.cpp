@@ -1,142 +1,531 @@
 #include "TaskSolver.h"
 #include "FileParser.h"
+#include "DecompressingBlockReader.h"
+#include "LogMerger.h"
 #include "EventHandler.h"
+#include "OutputWriter.h"
+#include "PhaseProfile.h"
+#include "RecordFormat.h"
+#include "ReorderBuffer.h"
+#include "ResultCache.h"
+#include "TimeIndex.h"
+#include "TextFormat.h"
+#include <algorithm>
+#include <deque>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
-int TaskSolver::run(const std::string& fileName) {
-    FileParser::Parse(fileName, _inputFileData, _error);
-
-    if (_error.errorType != ErrorType::Success) {
-        switch (_error.errorType) {
-            case ErrorType::IncorrectFileExtension:
-                std::cout << fileName << std::endl;
-                std::cout << "The input file has an incorrect extension!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectFileExtension);
-
-            case ErrorType::FileIsNotOpen:
-                std::cout << fileName << std::endl;
-                std::cout << "The file is not open!" << std::endl;
-                return static_cast<int>(ErrorType::FileIsNotOpen);
-
-            case ErrorType::IncorrectNumberOfTables:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The number of tables is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectNumberOfTables);
-
-            case ErrorType::IncorrectWorkingHoursFormat:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "There is an error in delimiter symbol in working hours format!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectWorkingHoursFormat);
-
-            case ErrorType::IncorrectOpeningTime:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The opening time format is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectOpeningTime);
-
-            case ErrorType::IncorrectClosingTime:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The closing time format is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectClosingTime);
-
-            case ErrorType::OpeningTimeIsNotLessThanClosingTime:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The opening time is not less than the closing time!" << std::endl;
-                return static_cast<int>(ErrorType::OpeningTimeIsNotLessThanClosingTime);
-
-            case ErrorType::IncorrectCostPerHour:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The cost per hour in computer club is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectCostPerHour);
-
-            case ErrorType::NoDelimiters:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "There is no delimiters in event description!" << std::endl;
-                return static_cast<int>(ErrorType::NoDelimiters);
-
-            case ErrorType::TooLittleDelimiters:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "There is only one delimiter in event description!" << std::endl;
-                return static_cast<int>(ErrorType::TooLittleDelimiters);
-
-            case ErrorType::IncorrectEventTime:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The event time format is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectEventTime);
-
-            case ErrorType::EventTimeIsNotLessThanClosingTime:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The event time is not less than closing time!" << std::endl;
-                return static_cast<int>(ErrorType::EventTimeIsNotLessThanClosingTime);
-
-            case ErrorType::IncorrectEventID:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The event ID format is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectEventID);
-
-            case ErrorType::IncorrectBodyEventWithSecondID:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "There is no delimiter for event body with second ID!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectBodyEventWithSecondID);
-
-            case ErrorType::IncorrectClientName:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The client name included in event body is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectClientName);
-
-            case ErrorType::IncorrectTableNumber:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The table number included in event body is incorrect!" << std::endl;
-                return static_cast<int>(ErrorType::IncorrectTableNumber);
-
-            default:
-                std::cout << _error.errorStr << std::endl;
-                std::cout << "The table number more than number of tables!" << std::endl;
-                return static_cast<int>(ErrorType::TableNumberMoreThanNumberOfTables);
+namespace {
+
+// 0 for the report of the task, so that its entries stay valid
+uint32_t reportVariant(const RunOptions& runOptions) {
+    const auto& sections = runOptions.reportSections;
+    uint32_t sectionBits = uint32_t{!sections.echo} | (uint32_t{!sections.events} << 1) |
+                           (uint32_t{!sections.tables} << 2) | (uint32_t{sections.totals} << 3);
+
+    return runOptions.reorderWindowMinutes | (sectionBits << 16);
+}
+
+}
+
+int TaskSolver::run(const std::string& fileName, std::ostream& stream) {
+    reset();
+    // A report from the cache has no visits to record
+    if (_resultCache && !_sessionLedger) {
+        // Reports about files that can't be read mention the file name and are never cached
+        if (!FileParser::ReadContent(fileName, _content, _error))
+            return solve(fileName, stream);
+
+        return solveCached(_content, fileName, stream);
+    }
+
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Parse);
+        FileParser::Parse(fileName, _inputFileData, _error);
+    }
+
+    return solve(fileName, stream);
+}
+
+int TaskSolver::runContent(std::string_view content, std::ostream& stream) {
+    reset();
+    if (_resultCache && !_sessionLedger)
+        return solveCached(content, "<content>", stream);
+
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Parse);
+        FileParser::ParseContent(content, _inputFileData, _error);
+    }
+
+    return solve("<content>", stream);
+}
+
+int TaskSolver::runMerged(const std::vector<std::string>& fileNames, std::ostream& stream) {
+    reset();
+
+    // The merger names the log in errorStr for errors about a whole log
+    LogMerger logMerger;
+    if (!logMerger.Open(fileNames, _error, _runOptions.reorderWindowMinutes))
+        return printError(_error.errorStr, stream);
+
+    EventHandler eventHandler(InputFileData{ logMerger.computerClubFeatures(), {}, {} });
+    eventHandler.SelectSections(_runOptions.reportSections);
+    eventHandler.WriteAs(_runOptions.outputFormat);
+    eventHandler.RecordTo(_sessionLedger);
+    eventHandler.Open(_result, _tables);
+
+    // Events wait in arrival order for the reorder buffer to release them; a handled one is marked by an empty line
+    ReorderBuffer reorderBuffer(_runOptions.reorderWindowMinutes);
+    std::deque<std::pair<Event, std::string>> waitingEvents;
+    uint64_t firstWaitingEvent = 0, nextEventNumber;
+
+    auto handleReleasedEvents = [&](bool isEndOfInput) {
+        while (reorderBuffer.Pop(nextEventNumber, isEndOfInput)) {
+            auto& [waitingEvent, waitingLine] = waitingEvents[nextEventNumber - firstWaitingEvent];
+            eventHandler.HandleEvent(waitingEvent, waitingLine, _result, _tables);
+            waitingLine.clear();
         }
+
+        while (!waitingEvents.empty() && waitingEvents.front().second.empty()) {
+            waitingEvents.pop_front();
+            firstWaitingEvent++;
+        }
+    };
+
+    Event event;
+    std::string line;
+
+    while (logMerger.Next(event, line, _error)) {
+        if (_runOptions.reorderWindowMinutes == 0) {
+            eventHandler.HandleEvent(event, line, _result, _tables);
+            continue;
+        }
+
+        if (!reorderBuffer.Push(event.eventTime)) {
+            _error = { ErrorType::IncorrectEventTimeSequence, line };
+            break;
+        }
+
+        waitingEvents.emplace_back(std::move(event), std::move(line));
+        handleReleasedEvents(false);
     }
 
-    EventHandler eventHandler(std::move(_inputFileData));
-    eventHandler.HandleEventsOfTheDay(_outputData, _error, _tables);
+    if (_error.errorType != ErrorType::Success)
+        return printError(_error.errorStr, stream);
+
+    handleReleasedEvents(true);
+    eventHandler.Finish(_result, _tables);
+    printResult(stream);
 
-    if (_error.errorType == ErrorType::IncorrectEventTimeSequence) {
-        std::cout << _error.errorStr << std::endl;
-        std::cout << "The time sequence of events is incorrect!" << std::endl;
-        return static_cast<int>(ErrorType::IncorrectEventTimeSequence);
+    return static_cast<int>(_error.errorType);
+}
+
+int TaskSolver::buildTimeIndex(const std::string& fileName, size_t checkpointInterval, std::ostream& stream) {
+    reset();
+    if (!isIndexableLog(fileName))
+        return printError(fileName, stream);
+
+    if (FileParser::ReadContent(fileName, _content, _error))
+        FileParser::ParseContent(_content, _inputFileData, _error);
+
+    if (_error.errorType == ErrorType::Success)
+        TimeIndex::Build(fileName, _content, std::move(_inputFileData), checkpointInterval, _error);
+
+    if (_error.errorType != ErrorType::Success)
+        return printError(fileName, stream);
+
+    return static_cast<int>(_error.errorType);
+}
+
+int TaskSolver::runAsOf(const std::string& fileName, const Time& time, std::ostream& stream) {
+    reset();
+    if (!isIndexableLog(fileName) || !TimeIndex::Query(fileName, time, _result, _error))
+        return printError(fileName, stream);
+
+    if (_outputWriter)
+        _outputWriter->Write(std::exchange(_result, {}));
+    else
+        stream << _result << std::flush;
+
+    return static_cast<int>(_error.errorType);
+}
+
+// The index points into the log as it is on disk, so a compressed log can't have one
+bool TaskSolver::isIndexableLog(const std::string& fileName) {
+    if (DecompressingBlockReader::CompressionOf(fileName) == DecompressingBlockReader::Compression::None)
+        return true;
+
+    _error.errorType = ErrorType::IncorrectFileExtension;
+    return false;
+}
+
+// The report depends on nothing but the file content, so it is cached by the content
+int TaskSolver::solveCached(std::string_view content, const std::string& fileName, std::ostream& stream) {
+    auto key = ResultCache::MakeKey(content, reportVariant(_runOptions));
+    int exitCode;
+    std::string report;
+
+    if (_resultCache->Find(key, exitCode, report)) {
+        printCachedResult(report, exitCode, stream);
+        return exitCode;
     }
 
-    writeResultInfo();
-    collectResultInfo();
+    // The text report is cached, and the other formats are made from it
+    std::ostringstream reportStream;
+    OutputWriter* outputWriter = std::exchange(_outputWriter, nullptr);
+    OutputFormat outputFormat = std::exchange(_runOptions.outputFormat, OutputFormat::Text);
 
-    std::cout << _result << std::endl;
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Parse);
+        FileParser::ParseContent(content, _inputFileData, _error);
+    }
+
+    try {
+        exitCode = solve(fileName, reportStream);
+    } catch (...) {
+        _outputWriter = outputWriter;
+        _runOptions.outputFormat = outputFormat;
+        throw;
+    }
+    _outputWriter = outputWriter;
+    _runOptions.outputFormat = outputFormat;
+
+    report = reportStream.str();
+    _resultCache->Store(key, exitCode, report);
+    printCachedResult(report, exitCode, stream);
+
+    return exitCode;
+}
+
+void TaskSolver::printCachedResult(std::string_view report, int exitCode, std::ostream& stream) {
+    // Anything but a report of the day is an error message, which is text in every format
+    if (_runOptions.outputFormat != OutputFormat::Text && exitCode == static_cast<int>(ErrorType::Success)) {
+        printRecords(report, stream);
+    } else if (_outputWriter) {
+        _outputWriter->Write(std::string(report));
+    } else {
+        stream << report;
+        stream.flush();
+    }
+}
+
+void TaskSolver::reset() {
+    _inputFileData.computerClubEvents.clear();
+    _inputFileData.initialEvents.clear();
+    _error = {};
+    _result.clear();
+    _tables.reset(0);
+}
+
+int TaskSolver::solve(const std::string& fileName, std::ostream& stream) {
+    if (_error.errorType != ErrorType::Success)
+        return printError(fileName, stream);
+
+    _result.reserve(estimateResultSize());
+
+    EventHandler eventHandler(std::move(_inputFileData));
+    eventHandler.SelectSections(_runOptions.reportSections);
+    eventHandler.WriteAs(_runOptions.outputFormat);
+    eventHandler.RecordTo(_sessionLedger);
+    if (_runOptions.reorderWindowMinutes > 0) {
+        // Reordering interleaves all the phases, so the whole day counts as dispatch
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Dispatch);
+        eventHandler.HandleEventsOfTheDayReordered(_result, _error, _tables, _runOptions.reorderWindowMinutes);
+    } else if (_phaseProfile) {
+        handleEventsOfTheDayProfiled(eventHandler);
+    } else if (_runOptions.numberOfThreads > 1) {
+        eventHandler.HandleEventsOfTheDayInParallel(_result, _error, _tables, _runOptions.numberOfThreads);
+    } else {
+        eventHandler.HandleEventsOfTheDay(_result, _error, _tables);
+    }
+
+    if (_error.errorType == ErrorType::IncorrectEventTimeSequence)
+        return printError(fileName, stream);
+
+    _inputFileData = eventHandler.TakeInputFileData();
+
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Output);
+        printResult(stream);
+    }
 
     return static_cast<int>(_error.errorType);
 }
 
-void TaskSolver::writeResultInfo() {
-    size_t tableNumber = 1;
-    for (const auto& table: _tables) {
-        _outputData.push_back(std::to_string(tableNumber++).append(" ").append(std::to_string(table.income))
-                              .append(" ").append(table.entireWorkingTime.toString()));
+int TaskSolver::printError(const std::string& fileName, std::ostream& stream) {
+    // Error messages go straight to the stream, so a previous report must not still be in flight
+    if (_outputWriter)
+        _outputWriter->Flush();
+
+    switch (_error.errorType) {
+        case ErrorType::IncorrectFileExtension:
+            stream << fileName << std::endl;
+            stream << "The input file has an incorrect extension!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectFileExtension);
+
+        case ErrorType::FileIsNotOpen:
+            stream << fileName << std::endl;
+            stream << "The file is not open!" << std::endl;
+            return static_cast<int>(ErrorType::FileIsNotOpen);
+
+        case ErrorType::IncorrectNumberOfTables:
+            stream << _error.errorStr << std::endl;
+            stream << "The number of tables is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectNumberOfTables);
+
+        case ErrorType::IncorrectWorkingHoursFormat:
+            stream << _error.errorStr << std::endl;
+            stream << "There is an error in delimiter symbol in working hours format!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectWorkingHoursFormat);
+
+        case ErrorType::IncorrectOpeningTime:
+            stream << _error.errorStr << std::endl;
+            stream << "The opening time format is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectOpeningTime);
+
+        case ErrorType::IncorrectClosingTime:
+            stream << _error.errorStr << std::endl;
+            stream << "The closing time format is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectClosingTime);
+
+        case ErrorType::OpeningTimeIsNotLessThanClosingTime:
+            stream << _error.errorStr << std::endl;
+            stream << "The opening time is not less than the closing time!" << std::endl;
+            return static_cast<int>(ErrorType::OpeningTimeIsNotLessThanClosingTime);
+
+        case ErrorType::IncorrectCostPerHour:
+            stream << _error.errorStr << std::endl;
+            stream << "The cost per hour in computer club is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectCostPerHour);
+
+        case ErrorType::NoDelimiters:
+            stream << _error.errorStr << std::endl;
+            stream << "There is no delimiters in event description!" << std::endl;
+            return static_cast<int>(ErrorType::NoDelimiters);
+
+        case ErrorType::TooLittleDelimiters:
+            stream << _error.errorStr << std::endl;
+            stream << "There is only one delimiter in event description!" << std::endl;
+            return static_cast<int>(ErrorType::TooLittleDelimiters);
+
+        case ErrorType::IncorrectEventTime:
+            stream << _error.errorStr << std::endl;
+            stream << "The event time format is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectEventTime);
+
+        case ErrorType::EventTimeIsNotLessThanClosingTime:
+            stream << _error.errorStr << std::endl;
+            stream << "The event time is not less than closing time!" << std::endl;
+            return static_cast<int>(ErrorType::EventTimeIsNotLessThanClosingTime);
+
+        case ErrorType::IncorrectEventID:
+            stream << _error.errorStr << std::endl;
+            stream << "The event ID format is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectEventID);
+
+        case ErrorType::IncorrectBodyEventWithSecondID:
+            stream << _error.errorStr << std::endl;
+            stream << "There is no delimiter for event body with second ID!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectBodyEventWithSecondID);
+
+        case ErrorType::IncorrectClientName:
+            stream << _error.errorStr << std::endl;
+            stream << "The client name included in event body is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectClientName);
+
+        case ErrorType::IncorrectTableNumber:
+            stream << _error.errorStr << std::endl;
+            stream << "The table number included in event body is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectTableNumber);
+
+        case ErrorType::IncorrectEventTimeSequence:
+            stream << _error.errorStr << std::endl;
+            stream << "The time sequence of events is incorrect!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectEventTimeSequence);
+
+        case ErrorType::IncorrectTimeIndex:
+            stream << fileName << std::endl;
+            stream << "The time index is missing, damaged or out of date!" << std::endl;
+            return static_cast<int>(ErrorType::IncorrectTimeIndex);
+
+        case ErrorType::DifferentLogHeaders:
+            stream << fileName << std::endl;
+            stream << "The number of tables, working hours or cost per hour differ from the first log!" << std::endl;
+            return static_cast<int>(ErrorType::DifferentLogHeaders);
+
+        default:
+            stream << _error.errorStr << std::endl;
+            stream << "The table number more than number of tables!" << std::endl;
+            return static_cast<int>(ErrorType::TableNumberMoreThanNumberOfTables);
+    }
+}
+
+// The same steps as EventHandler::HandleEventsOfTheDay, each counted towards its own phase
+void TaskSolver::handleEventsOfTheDayProfiled(EventHandler& eventHandler) {
+    bool isStarted;
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::SequenceCheck);
+        isStarted = eventHandler.Start(_result, _error, _tables);
+    }
+    if (!isStarted)
+        return;
+
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Dispatch);
+        for (size_t eventNumber = 0; eventNumber < eventHandler.numberOfEvents(); eventNumber++)
+            eventHandler.HandleEvent(eventNumber, _result, _tables);
+    }
+    {
+        PhaseProfile::Scope scope(_phaseProfile, PhaseProfile::Close);
+        eventHandler.Finish(_result, _tables);
+    }
+
+    _phaseProfile->AddEvents(eventHandler.numberOfEvents());
+}
+
+void TaskSolver::printResult(std::ostream& stream) {
+    if (_runOptions.outputFormat != OutputFormat::Text) {
+        printResultRecords(stream);
+        return;
+    }
+
+    const auto& sections = _runOptions.reportSections;
+    if (_outputWriter)
+        _outputWriter->Write(std::exchange(_result, {}));
+    else
+        stream << _result;
+
+    // The per-table report is formatted and written out in chunks, so that it never has to exist as a whole
+    std::string chunk;
+    for (size_t first = 0; sections.tables && first < _tables.size(); first += REPORT_CHUNK_TABLES) {
+        chunk.clear();
+        appendTablesReport(chunk, _tables, first, std::min(first + REPORT_CHUNK_TABLES, _tables.size()));
+
+        if (_outputWriter)
+            _outputWriter->Write(chunk);
+        else
+            stream << chunk;
     }
+
+    chunk.clear();
+    if (sections.totals)
+        appendTotalsReport(chunk, _tables);
+    chunk.push_back('\n');
+
+    if (_outputWriter) {
+        _outputWriter->Write(std::move(chunk));
+    } else {
+        stream << chunk;
+        stream.flush();
+    }
+}
+
+// The handlers have written the records of the events, and the records of the tables and the totals (for the
+// sections selected) are made straight from them, in chunks written out one by one from the same buffer
+void TaskSolver::printResultRecords(std::ostream& stream) {
+    _chunk.clear();
+    if (_runOptions.outputFormat == OutputFormat::Csv) {
+        _chunk.append(RecordFormat::CSV_HEADER);
+        writeChunk(stream);
+    }
+
+    if (_outputWriter)
+        _outputWriter->Write(std::exchange(_result, {}));
+    else
+        stream << _result;
+
+    const auto& sections = _runOptions.reportSections;
+    for (size_t first = 0; sections.tables && first < _tables.size(); first += REPORT_CHUNK_TABLES) {
+        RecordFormat::appendTableRecords(_chunk, _runOptions.outputFormat, _tables, first,
+                                         std::min(first + REPORT_CHUNK_TABLES, _tables.size()));
+        writeChunk(stream);
+    }
+
+    if (sections.totals) {
+        RecordFormat::appendRecord(_chunk, _runOptions.outputFormat,
+                                   { .type = RecordFormat::RecordType::Total, .income = _tables.totalIncome() });
+    }
+
+    writeChunk(stream);
+    if (!_outputWriter)
+        stream.flush();
 }
 
-void TaskSolver::collectResultInfo() {
-    std::ostringstream oss;
+// A cached report is text, so its records are made from its lines, in chunks of REPORT_CHUNK_BYTES written out
+// one by one from the same buffer
+void TaskSolver::printRecords(std::string_view report, std::ostream& stream) {
+    _chunk.clear();
+    if (_runOptions.outputFormat == OutputFormat::Csv)
+        _chunk.append(RecordFormat::CSV_HEADER);
 
-    for (const auto& outputLine : _outputData) {
-        oss << outputLine << '\n';
+    bool isOpened = false;
+    for (size_t offset = 0; offset < report.size(); ) {
+        offset = RecordFormat::appendReportRecords(_chunk, _runOptions.outputFormat, report, offset,
+                                                   REPORT_CHUNK_BYTES, isOpened);
+        if (_chunk.size() >= REPORT_CHUNK_BYTES)
+            writeChunk(stream);
     }
 
-    _result = oss.str();
+    writeChunk(stream);
+    if (!_outputWriter)
+        stream.flush();
+}
+
+void TaskSolver::writeChunk(std::ostream& stream) {
+    if (_outputWriter)
+        _outputWriter->Write(_chunk);
+    else
+        stream.write(_chunk.data(), static_cast<std::streamsize>(_chunk.size()));
+
+    _chunk.clear();
+}
+
+// Echoed input lines plus roughly one generated line per event, so that the handlers never reallocate;
+// nothing for the sections that aren't written
+size_t TaskSolver::estimateResultSize() const {
+    const auto& sections = _runOptions.reportSections;
+    if (!sections.hasEventLog())
+        return 0;
+
+    // A record is longer than its text line by the names of its fields and their punctuation
+    constexpr size_t RECORD_OVERHEAD = 56;
+    const size_t lineOverhead = _runOptions.outputFormat == OutputFormat::Text ? 1 : RECORD_OVERHEAD;
+
+    size_t inputSize = 0;
+    for (const auto& line : _inputFileData.initialEvents)
+        inputSize += line.size() + lineOverhead;
+
+    constexpr size_t GENERATED_LINE_SIZE = 32;
+    return (sections.echo + sections.events) * inputSize + GENERATED_LINE_SIZE * 2;
 }
 
 // Artificial method for testing
-const Time& TaskSolver::getEntireWorkingTimeOfTable(size_t tableNumber) const {
-    return _tables.at(tableNumber - 1).entireWorkingTime;
+std::string TaskSolver::getOutputResult() const {
+    std::string result = _result;
+    appendTablesReport(result, _tables);
+
+    return result;
+}
+
+// Artificial method for testing
+Time TaskSolver::getEntireWorkingTimeOfTable(size_t tableNumber) const {
+    checkTableNumber(tableNumber);
+    return Time::fromMinutes(_tables.entireWorkingTime(tableNumber - 1));
 }
 
 // Artificial method for testing
 size_t TaskSolver::getTableIncome(size_t tableNumber) const {
-    return _tables.at(tableNumber -1).income;
+    checkTableNumber(tableNumber);
+    return _tables.income(tableNumber - 1);
+}
+
+size_t TaskSolver::getRevenue() const {
+    return _tables.totalIncome();
+}
+
+void TaskSolver::checkTableNumber(size_t tableNumber) const {
+    if (tableNumber == 0 || tableNumber > _tables.size())
+        throw std::out_of_range("There is no table " + std::to_string(tableNumber));
 }
\ No newline at end of file
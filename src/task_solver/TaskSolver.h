@@ -2,24 +2,81 @@
 #define COMPUTERCLUB_TASKSOLVER_H
 
 #include "InputFileData.h"
+#include "RunOptions.h"
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+class EventHandler;
+class OutputWriter;
+class PhaseProfile;
+class ResultCache;
+class SessionLedger;
 
 class TaskSolver {
 public:
-    int run(const std::string& fileName);
+    static constexpr size_t REPORT_CHUNK_TABLES = 65536;
+    static constexpr size_t REPORT_CHUNK_BYTES = 1 << 20;
+
+    // Without an output writer the report is printed synchronously to the stream passed to run.
+    // With a result cache run answers unchanged files from the cache, and the getters below are not filled then.
+    // With a phase profile every run adds its counters to it; events are handled on one thread then.
+    // With a session ledger every run records the visits of its day to it; the result cache isn't used then, and
+    // events are handled on one thread.
+    // A TaskSolver may be reused for any number of runs; its buffers keep their capacity between them.
+    explicit TaskSolver(OutputWriter* outputWriter = nullptr, RunOptions runOptions = {},
+                        ResultCache* resultCache = nullptr, PhaseProfile* phaseProfile = nullptr,
+                        SessionLedger* sessionLedger = nullptr)
+                       : _outputWriter(outputWriter), _runOptions(runOptions), _resultCache(resultCache),
+                         _phaseProfile(phaseProfile), _sessionLedger(sessionLedger) { }
+
+    int run(const std::string& fileName, std::ostream& stream = std::cout);
+    int runContent(std::string_view content, std::ostream& stream = std::cout);
 
-    const Time& getEntireWorkingTimeOfTable(size_t tableNumber) const;
+    // The day of one club from several logs, e.g. one per check-in terminal, merged by time as they are read.
+    // The result cache and the phase profile are not used for them.
+    int runMerged(const std::vector<std::string>& fileNames, std::ostream& stream = std::cout);
+
+    // Handles the day of the file once and writes its time index next to it; prints only errors.
+    // Compressed logs can't be indexed.
+    int buildTimeIndex(const std::string& fileName, size_t checkpointInterval, std::ostream& stream = std::cout);
+    // Prints the state of the club as of time from the time index of the file, without handling the whole day
+    int runAsOf(const std::string& fileName, const Time& time, std::ostream& stream = std::cout);
+
+    Time getEntireWorkingTimeOfTable(size_t tableNumber) const;
     size_t getTableIncome(size_t tableNumber) const;
-    const std::string& getOutputResult() const { return _result; }
+    // The income of all the tables after the last run; not filled in when the report comes from the cache
+    size_t getRevenue() const;
+    std::string getOutputResult() const;
 
 private:
+    OutputWriter* _outputWriter;
+    RunOptions _runOptions;
+    ResultCache* _resultCache;
+    PhaseProfile* _phaseProfile;
+    SessionLedger* _sessionLedger;
     InputFileData _inputFileData;
     Error _error;
-    std::vector<Table> _tables;
-    std::vector<std::string> _outputData;
+    Tables _tables;
     std::string _result;
+    std::string _content;
+    // Records are serialized into it chunk by chunk; it keeps its capacity between runs
+    std::string _chunk;
+
+    void reset();
+    bool isIndexableLog(const std::string& fileName);
+    int solve(const std::string& fileName, std::ostream& stream);
+    int solveCached(std::string_view content, const std::string& fileName, std::ostream& stream);
+    int printError(const std::string& fileName, std::ostream& stream);
+    void printCachedResult(std::string_view report, int exitCode, std::ostream& stream);
+    void handleEventsOfTheDayProfiled(EventHandler& eventHandler);
 
-    void writeResultInfo();
-    void collectResultInfo();
+    void printResult(std::ostream& stream);
+    void printResultRecords(std::ostream& stream);
+    void printRecords(std::string_view report, std::ostream& stream);
+    void writeChunk(std::ostream& stream);
+    size_t estimateResultSize() const;
+    void checkTableNumber(size_t tableNumber) const;
 };
 
 
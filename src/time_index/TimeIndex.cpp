@@ -0,0 +1,370 @@
+#include "TimeIndex.h"
+#include "Constants.h"
+#include "EventHandler.h"
+#include "FileParser.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = { 'Y', 'C', 'C', 'I', 'N', 'D', 'E', 'X' };
+// Bump whenever the layout below or the meaning of a checkpoint changes
+constexpr uint32_t INDEX_VERSION = 1;
+constexpr size_t NUMBER_OF_HEADER_LINES = 3;
+constexpr uint32_t MINUTES_IN_DAY = 24 * MINUTES_IN_HOUR;
+// The largest number of tables and cost per hour the log may have
+constexpr uint64_t MAX_NUMBER = std::numeric_limits<int>::max();
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t openingMinutes;
+    uint32_t closingMinutes;
+    uint32_t padding;
+    // The log the index was built from
+    uint64_t logSize;
+    int64_t logModificationTime;
+    uint64_t numberOfTables;
+    uint64_t costPerHour;
+    uint64_t numberOfEvents;
+    uint64_t numberOfCheckpoints;
+};
+
+// The state before event eventNumber; the checkpoints follow the header in the order of events
+struct CheckpointEntry {
+    uint64_t eventNumber;
+    uint64_t logOffset;
+    uint64_t stateOffset;
+    uint64_t stateSize;
+    // The time of event eventNumber - 1
+    uint32_t lastEventMinutes;
+    uint32_t padding;
+};
+
+template <typename Value>
+void appendValue(std::string& data, const Value& value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& data, std::string_view text) {
+    appendValue(data, static_cast<uint32_t>(text.size()));
+    data.append(text);
+}
+
+template <typename Value>
+bool readValue(std::string_view& data, Value& value) {
+    if (data.size() < sizeof(value))
+        return false;
+
+    std::memcpy(&value, data.data(), sizeof(value));
+    data.remove_prefix(sizeof(value));
+    return true;
+}
+
+// A count of records that can't even fit into the rest of data is damage, and resizing to it might not fit into memory
+bool readCount(std::string_view& data, uint64_t& count, size_t minRecordSize) {
+    return readValue(data, count) && count <= data.size() / minRecordSize;
+}
+
+bool readString(std::string_view& data, std::string& text) {
+    uint32_t size;
+    if (!readValue(data, size) || data.size() < size)
+        return false;
+
+    text.assign(data.substr(0, size));
+    data.remove_prefix(size);
+    return true;
+}
+
+int64_t modificationTime(const std::string& fileName, std::error_code& errorCode) {
+    return static_cast<int64_t>(fs::last_write_time(fileName, errorCode).time_since_epoch().count());
+}
+
+void saveCheckpoint(std::string& data, const EventHandler::State& state, const Tables& tables) {
+    appendValue(data, static_cast<uint64_t>(state.clientStatuses.size()));
+    for (const auto& [name, status] : state.clientStatuses) {
+        appendString(data, name);
+        appendValue(data, static_cast<uint8_t>(status.eventId));
+        appendValue(data, static_cast<uint64_t>(status.numberOfBusyTable));
+    }
+
+    appendValue(data, static_cast<uint64_t>(state.waitingClients.size()));
+    for (const auto& name : state.waitingClients)
+        appendString(data, name);
+
+    // Only the tables that have ever been seated
+    std::string tableData;
+    uint64_t numberOfTables = 0;
+
+    for (size_t pageNumber : tables.usedPages()) {
+        const auto& page = *tables.pageAt(pageNumber);
+
+        for (size_t offset = 0; offset < page.size(); offset++) {
+            if (!page.isBusy[offset] && page.entireWorkingTime[offset] == 0)
+                continue;
+
+            appendValue(tableData, static_cast<uint64_t>((pageNumber << Tables::PAGE_SHIFT) + offset));
+            appendValue(tableData, page.isBusy[offset]);
+            appendValue(tableData, page.startWorking[offset]);
+            appendValue(tableData, page.entireWorkingTime[offset]);
+            appendValue(tableData, static_cast<uint64_t>(page.income[offset]));
+            numberOfTables++;
+        }
+    }
+
+    appendValue(data, numberOfTables);
+    data.append(tableData);
+}
+
+bool loadCheckpoint(std::string_view data, EventHandler::State& state, Tables& tables) {
+    uint64_t numberOfClients;
+    if (!readCount(data, numberOfClients, sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint64_t)))
+        return false;
+
+    state.clientStatuses.resize(numberOfClients);
+    for (auto& [name, status] : state.clientStatuses) {
+        uint8_t eventId;
+        uint64_t numberOfBusyTable;
+        if (!readString(data, name) || !readValue(data, eventId) || !readValue(data, numberOfBusyTable) ||
+            eventId > static_cast<uint8_t>(IncomingEventID::ClientHasGoneAway) || numberOfBusyTable > tables.size())
+        {
+            return false;
+        }
+
+        status = { static_cast<IncomingEventID>(eventId), numberOfBusyTable };
+    }
+
+    uint64_t numberOfWaitingClients;
+    if (!readCount(data, numberOfWaitingClients, sizeof(uint32_t)))
+        return false;
+
+    state.waitingClients.resize(numberOfWaitingClients);
+    for (auto& name : state.waitingClients) {
+        if (!readString(data, name))
+            return false;
+    }
+
+    uint64_t numberOfTables;
+    if (!readValue(data, numberOfTables))
+        return false;
+
+    for (uint64_t i = 0; i < numberOfTables; i++) {
+        uint64_t table, income;
+        uint8_t isBusy;
+        uint16_t startWorking;
+        uint32_t entireWorkingTime;
+
+        if (!readValue(data, table) || !readValue(data, isBusy) || !readValue(data, startWorking) ||
+            !readValue(data, entireWorkingTime) || !readValue(data, income) || table >= tables.size())
+        {
+            return false;
+        }
+
+        tables.restore(table, isBusy, startWorking, entireWorkingTime, income);
+    }
+
+    return data.empty();
+}
+
+}
+
+bool TimeIndex::Build(const std::string& logFileName, std::string_view content, InputFileData inputFileData,
+                      size_t checkpointInterval, Error& error)
+{
+    // Every line after the header is an event, otherwise the log wouldn't have been parsed
+    std::vector<uint64_t> eventOffsets;
+    eventOffsets.reserve(inputFileData.computerClubEvents.size() + 1);
+
+    size_t numberOfLines = 0;
+    for (size_t pos = content.find('\n'); pos != std::string_view::npos; pos = content.find('\n', pos + 1)) {
+        if (++numberOfLines >= NUMBER_OF_HEADER_LINES)
+            eventOffsets.push_back(pos + 1);
+    }
+    eventOffsets.resize(inputFileData.computerClubEvents.size() + 1, content.size());
+
+    const auto& features = inputFileData.computerClubFeatures;
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.openingMinutes = features.openingTime.toMinutes();
+    header.closingMinutes = features.closingTime.toMinutes();
+    header.numberOfTables = features.numberOfTables;
+    header.costPerHour = features.costPerHour;
+    header.numberOfEvents = inputFileData.computerClubEvents.size();
+
+    std::error_code errorCode;
+    header.logSize = content.size();
+    header.logModificationTime = modificationTime(logFileName, errorCode);
+
+    std::string output;
+    Tables tables;
+    EventHandler eventHandler(std::move(inputFileData));
+    if (!eventHandler.Start(output, error, tables))
+        return false;
+
+    std::vector<CheckpointEntry> checkpoints;
+    std::string states;
+
+    for (size_t eventNumber = 0; ; eventNumber++) {
+        if (eventNumber % checkpointInterval == 0) {
+            CheckpointEntry checkpoint{};
+            checkpoint.eventNumber = eventNumber;
+            checkpoint.logOffset = eventOffsets[eventNumber];
+            checkpoint.stateOffset = states.size();
+            checkpoint.lastEventMinutes = eventNumber == 0 ? 0 : eventHandler.eventTime(eventNumber - 1).toMinutes();
+
+            saveCheckpoint(states, eventHandler.SaveState(), tables);
+            checkpoint.stateSize = states.size() - checkpoint.stateOffset;
+            checkpoints.push_back(checkpoint);
+        }
+
+        if (eventNumber == eventHandler.numberOfEvents())
+            break;
+
+        output.clear();
+        eventHandler.HandleEvent(eventNumber, output, tables);
+    }
+
+    header.numberOfCheckpoints = checkpoints.size();
+    const uint64_t statesOffset = sizeof(header) + checkpoints.size() * sizeof(CheckpointEntry);
+    for (auto& checkpoint : checkpoints)
+        checkpoint.stateOffset += statesOffset;
+
+    // Written aside and renamed into place, so that a query never sees half an index
+    std::string indexFileName = IndexFileName(logFileName);
+    std::string temporaryFileName = indexFileName + ".tmp";
+    {
+        std::ofstream file(temporaryFileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(checkpoints.data()),
+                   static_cast<std::streamsize>(checkpoints.size() * sizeof(CheckpointEntry)));
+        file.write(states.data(), static_cast<std::streamsize>(states.size()));
+
+        if (!file.flush()) {
+            error = { ErrorType::IncorrectTimeIndex, indexFileName };
+            return false;
+        }
+    }
+
+    fs::rename(temporaryFileName, indexFileName, errorCode);
+    if (errorCode) {
+        fs::remove(temporaryFileName, errorCode);
+        error = { ErrorType::IncorrectTimeIndex, indexFileName };
+        return false;
+    }
+
+    return true;
+}
+
+bool TimeIndex::Query(const std::string& logFileName, const Time& time, std::string& report, Error& error) {
+    error = { ErrorType::IncorrectTimeIndex, IndexFileName(logFileName) };
+
+    // Every size and count of the index is checked before anything is allocated for it, so that a damaged index
+    // is an error and not a crash
+    std::error_code errorCode;
+    uint64_t indexSize = fs::file_size(IndexFileName(logFileName), errorCode);
+    std::ifstream indexFile(IndexFileName(logFileName), std::ios::binary);
+    IndexHeader header{};
+    if (errorCode || !indexFile.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION ||
+        header.numberOfCheckpoints == 0 ||
+        header.numberOfCheckpoints > (indexSize - sizeof(header)) / sizeof(CheckpointEntry) ||
+        header.openingMinutes >= header.closingMinutes || header.closingMinutes >= MINUTES_IN_DAY ||
+        header.numberOfTables == 0 || header.numberOfTables > MAX_NUMBER ||
+        header.costPerHour == 0 || header.costPerHour > MAX_NUMBER)
+    {
+        return false;
+    }
+
+    if (fs::file_size(logFileName, errorCode) != header.logSize ||
+        modificationTime(logFileName, errorCode) != header.logModificationTime || errorCode)
+    {
+        return false;
+    }
+
+    InputFileData inputFileData;
+    auto& features = inputFileData.computerClubFeatures;
+    features.numberOfTables = header.numberOfTables;
+    features.openingTime = Time::fromMinutes(header.openingMinutes);
+    features.closingTime = Time::fromMinutes(header.closingMinutes);
+    features.costPerHour = header.costPerHour;
+
+    // From the closing time on everyone has left
+    const bool isClosed = time >= features.closingTime;
+    const uint32_t minutes = isClosed ? header.closingMinutes : time.toMinutes();
+
+    auto readCheckpoint = [&indexFile](uint64_t number, CheckpointEntry& checkpoint) {
+        indexFile.seekg(static_cast<std::streamoff>(sizeof(IndexHeader) + number * sizeof(CheckpointEntry)));
+        return static_cast<bool>(indexFile.read(reinterpret_cast<char*>(&checkpoint), sizeof(checkpoint)));
+    };
+
+    // The last checkpoint none of whose preceding events is later than the requested time
+    uint64_t first = 0, last = header.numberOfCheckpoints;
+    while (last - first > 1) {
+        uint64_t middle = first + (last - first) / 2;
+
+        CheckpointEntry checkpoint;
+        if (!readCheckpoint(middle, checkpoint))
+            return false;
+
+        if (checkpoint.lastEventMinutes <= minutes)
+            first = middle;
+        else
+            last = middle;
+    }
+
+    CheckpointEntry checkpoint;
+    if (!readCheckpoint(first, checkpoint) || checkpoint.stateOffset > indexSize ||
+        checkpoint.stateSize > indexSize - checkpoint.stateOffset)
+    {
+        return false;
+    }
+
+    std::string stateData(checkpoint.stateSize, '\0');
+    indexFile.seekg(static_cast<std::streamoff>(checkpoint.stateOffset));
+    if (!indexFile.read(stateData.data(), static_cast<std::streamsize>(stateData.size())))
+        return false;
+
+    EventHandler::State state;
+    Tables tables;
+    tables.reset(features.numberOfTables);
+    if (!loadCheckpoint(stateData, state, tables))
+        return false;
+
+    // The events after the checkpoint up to the requested time
+    std::ifstream logFile(logFileName, std::ios::binary);
+    logFile.seekg(static_cast<std::streamoff>(checkpoint.logOffset));
+
+    std::string line;
+    Error lineError;
+    for (uint64_t eventNumber = checkpoint.eventNumber; eventNumber < header.numberOfEvents; eventNumber++) {
+        if (!std::getline(logFile, line) || !FileParser::ParseEvent(std::move(line), inputFileData, lineError))
+            return false;
+
+        if (inputFileData.computerClubEvents.back().eventTime.toMinutes() > minutes) {
+            inputFileData.computerClubEvents.pop_back();
+            inputFileData.initialEvents.pop_back();
+            break;
+        }
+    }
+
+    EventHandler eventHandler(std::move(inputFileData));
+    eventHandler.RestoreState(std::move(state));
+
+    std::string output;
+    for (size_t eventNumber = 0; eventNumber < eventHandler.numberOfEvents(); eventNumber++)
+        eventHandler.HandleEvent(eventNumber, output, tables);
+    if (isClosed) {
+        eventHandler.Finish(output, tables);
+        eventHandler.RestoreState({});
+    }
+
+    eventHandler.WriteStateAsOf(Time::fromMinutes(minutes), report, tables);
+
+    error = {};
+    return true;
+}
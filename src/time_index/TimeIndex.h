@@ -0,0 +1,29 @@
+#ifndef COMPUTERCLUB_TIMEINDEX_H
+#define COMPUTERCLUB_TIMEINDEX_H
+
+#include "InputFileData.h"
+#include <string>
+#include <string_view>
+
+// Sidecar index of a log for "as of HH:MM" queries. Every checkpointInterval events it keeps the byte offset of the
+// next event line and a checkpoint of the handler state and the tables. A query binary searches the checkpoints on
+// disk, loads the last one before the requested time and replays at most checkpointInterval events from the log,
+// so it takes about the same time however long the day is.
+class TimeIndex {
+public:
+    static constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 1024;
+
+    static std::string IndexFileName(const std::string& logFileName) { return logFileName + ".idx"; }
+
+    // content is the log as it is on disk and inputFileData what it is parsed into. Returns false with error set
+    // if the events can't be handled or the index can't be written.
+    static bool Build(const std::string& logFileName, std::string_view content, InputFileData inputFileData,
+                      size_t checkpointInterval, Error& error);
+
+    // Appends the state of the club as of time (see EventHandler::WriteStateAsOf); from the closing time on that is
+    // the end of the day. Returns false with error set if the index is missing, damaged or older than the log.
+    static bool Query(const std::string& logFileName, const Time& time, std::string& report, Error& error);
+};
+
+
+#endif //COMPUTERCLUB_TIMEINDEX_H
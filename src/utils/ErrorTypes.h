@@ -22,6 +22,12 @@ enum class ErrorType {
     IncorrectTableNumber,
     TableNumberMoreThanNumberOfTables,
     IncorrectEventTimeSequence,
+    IncorrectCommandLineOption,
+    IncorrectTimeIndex,
+    DifferentLogHeaders,
+    IncorrectManifest,
+    FailedShard,
+    IncorrectRequest,
     UnexpectedError = -1,
 };
 
@@ -2,6 +2,7 @@
 #define COMPUTERCLUB_INPUTFILEDATA_H
 
 #include "ErrorTypes.h"
+#include "Tables.h"
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -14,21 +15,22 @@ struct Time {
         return (hours > time.hours || (hours == time.hours && minutes >= time.minutes));
     }
 
+    void appendTo(std::string& result) const {
+        const char buffer[] = { static_cast<char>('0' + hours / 10), static_cast<char>('0' + hours % 10), ':',
+                                static_cast<char>('0' + minutes / 10), static_cast<char>('0' + minutes % 10) };
+        result.append(buffer, sizeof(buffer));
+    }
+
+    uint16_t toMinutes() const { return static_cast<uint16_t>(hours * 60 + minutes); }
+
+    static Time fromMinutes(uint32_t minutes) {
+        return { static_cast<uint16_t>(minutes / 60), static_cast<uint16_t>(minutes % 60) };
+    }
+
     std::string toString() const {
         std::string result;
-        if (hours < 10) {
-            result.append("0").append(std::to_string(hours));
-            if (minutes < 10)
-                return result.append(":").append("0").append(std::to_string(minutes));
-            else
-                return result.append(":").append(std::to_string(minutes));
-        } else {
-            result.append(std::to_string(hours));
-            if (minutes < 10)
-                return result.append(":").append("0").append(std::to_string(minutes));
-            else
-                return result.append(":").append(std::to_string(minutes));
-        }
+        appendTo(result);
+        return result;
     }
 };
 
@@ -69,12 +71,6 @@ struct ClientStatus {
     size_t numberOfBusyTable{};
 };
 
-struct Table {
-    Time startWorking, entireWorkingTime;
-    size_t income{};
-    bool isBusy{false};
-};
-
 enum class OutgoingEventID {
     ClientHasGoneAway = 11,
     ClientHasSatDownAtTheTable,
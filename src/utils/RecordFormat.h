@@ -0,0 +1,224 @@
+#ifndef COMPUTERCLUB_RECORDFORMAT_H
+#define COMPUTERCLUB_RECORDFORMAT_H
+
+#include "Constants.h"
+#include "RunOptions.h"
+#include "TextFormat.h"
+#include <charconv>
+#include <string_view>
+
+// Typed records of a report for machine-readable output. Client names are [a-z0-9_-] and error names are fixed
+// (see Constants.h), so no field ever needs quoting or escaping, and records are appended field by field to an
+// output whose capacity is kept between chunks, without allocating anything else.
+namespace RecordFormat {
+
+enum class RecordType {
+    Opening,
+    Closing,
+    // An echoed input event, IncomingEventID
+    Event,
+    // A generated event, OutgoingEventID
+    GeneratedEvent,
+    Table,
+    // The income of all the tables
+    Total,
+};
+
+inline constexpr std::string_view RECORD_TYPE_NAMES[] = {
+    "opening", "closing", "event", "generated", "table", "total",
+};
+
+// Fields that don't apply to the record type stay empty or 0
+struct Record {
+    RecordType type{};
+    Time time{};
+    uint16_t eventId{};
+    std::string_view clientName{};
+    size_t table{};
+    std::string_view errorName{};
+    size_t income{};
+    uint32_t minutes{};
+};
+
+inline constexpr std::string_view CSV_HEADER = "type,time,id,client,table,error,income,minutes\n";
+
+inline void appendJsonField(std::string& output, std::string_view name, std::string_view value) {
+    output.append(",\"").append(name).append("\":\"").append(value).push_back('"');
+}
+
+inline void appendJsonField(std::string& output, std::string_view name, size_t value) {
+    output.append(",\"").append(name).append("\":");
+    appendNumber(output, value);
+}
+
+// {"type":"generated","time":"12:33","id":12,"client":"client4","table":1}
+inline void appendJsonLine(std::string& output, const Record& record) {
+    output.append("{\"type\":\"").append(RECORD_TYPE_NAMES[static_cast<size_t>(record.type)]).push_back('"');
+
+    if (record.type == RecordType::Table) {
+        appendJsonField(output, "table", record.table);
+        appendJsonField(output, "income", record.income);
+        appendJsonField(output, "minutes", record.minutes);
+        output.append("}\n");
+        return;
+    }
+
+    if (record.type == RecordType::Total) {
+        appendJsonField(output, "income", record.income);
+        output.append("}\n");
+        return;
+    }
+
+    output.append(",\"time\":\"");
+    record.time.appendTo(output);
+    output.push_back('"');
+
+    if (record.eventId != 0)
+        appendJsonField(output, "id", record.eventId);
+    if (!record.clientName.empty())
+        appendJsonField(output, "client", record.clientName);
+    if (record.table != 0)
+        appendJsonField(output, "table", record.table);
+    if (!record.errorName.empty())
+        appendJsonField(output, "error", record.errorName);
+
+    output.append("}\n");
+}
+
+// generated,12:33,12,client4,1,,,  under CSV_HEADER
+inline void appendCsvLine(std::string& output, const Record& record) {
+    output.append(RECORD_TYPE_NAMES[static_cast<size_t>(record.type)]).push_back(',');
+    if (record.type != RecordType::Table && record.type != RecordType::Total)
+        record.time.appendTo(output);
+    output.push_back(',');
+    if (record.eventId != 0)
+        appendNumber(output, record.eventId);
+    output.push_back(',');
+    output.append(record.clientName).push_back(',');
+    if (record.table != 0)
+        appendNumber(output, record.table);
+    output.push_back(',');
+    output.append(record.errorName).push_back(',');
+
+    if (record.type == RecordType::Table) {
+        appendNumber(output, record.income);
+        output.push_back(',');
+        appendNumber(output, record.minutes);
+    } else if (record.type == RecordType::Total) {
+        appendNumber(output, record.income);
+        output.push_back(',');
+    } else {
+        output.push_back(',');
+    }
+    output.push_back('\n');
+}
+
+inline void appendRecord(std::string& output, OutputFormat format, const Record& record) {
+    if (format == OutputFormat::Csv)
+        appendCsvLine(output, record);
+    else
+        appendJsonLine(output, record);
+}
+
+// The minutes of the "HH:MM" the line starts with
+inline uint16_t parseTimeOfLine(std::string_view line) {
+    return static_cast<uint16_t>(((line[0] - '0') * 10 + (line[1] - '0')) * MINUTES_IN_HOUR +
+                                 (line[3] - '0') * 10 + (line[4] - '0'));
+}
+
+// One line of a text report as written by EventHandler, appendTablesReport and appendTotalsReport: "HH:MM" for
+// the opening (before any event) and the closing, "HH:MM <id> <body>" for events, "<table> <income> <HH:MM>" for
+// tables and "Revenue <income>" for the totals. The lines come from the engine itself, so they are trusted to be
+// well-formed.
+inline Record parseReportLine(std::string_view line, bool isOpened) {
+    Record record;
+
+    if (line.starts_with(REVENUE_PREFIX)) {
+        record.type = RecordType::Total;
+        std::from_chars(line.data() + REVENUE_PREFIX.size(), line.data() + line.size(), record.income);
+        return record;
+    }
+
+    if (line.size() < 3 || line[2] != TIME_DELIMITER) {
+        size_t incomePos = line.find(WORD_DELIMITER) + 1;
+        size_t timePos = line.find(WORD_DELIMITER, incomePos) + 1;
+
+        record.type = RecordType::Table;
+        std::from_chars(line.data(), line.data() + incomePos - 1, record.table);
+        std::from_chars(line.data() + incomePos, line.data() + timePos - 1, record.income);
+        record.minutes = parseTimeOfLine(line.substr(timePos));
+        return record;
+    }
+
+    record.time = Time::fromMinutes(parseTimeOfLine(line));
+    if (line.size() == 5) {
+        record.type = isOpened ? RecordType::Closing : RecordType::Opening;
+        return record;
+    }
+
+    size_t bodyPos = line.find(WORD_DELIMITER, 6) + 1;
+    std::from_chars(line.data() + 6, line.data() + bodyPos - 1, record.eventId);
+    std::string_view body = line.substr(bodyPos);
+
+    record.type = record.eventId >= static_cast<uint16_t>(OutgoingEventID::ClientHasGoneAway)
+                  ? RecordType::GeneratedEvent : RecordType::Event;
+
+    if (record.eventId == static_cast<uint16_t>(OutgoingEventID::Error)) {
+        record.errorName = body;
+    } else if (record.eventId == static_cast<uint16_t>(IncomingEventID::ClientHasSatDownAtTheTable) ||
+               record.eventId == static_cast<uint16_t>(OutgoingEventID::ClientHasSatDownAtTheTable)) {
+        size_t tablePos = body.find(WORD_DELIMITER);
+        record.clientName = body.substr(0, tablePos);
+        std::from_chars(body.data() + tablePos + 1, body.data() + body.size(), record.table);
+    } else {
+        record.clientName = body;
+    }
+
+    return record;
+}
+
+// Converts the lines of a text report from offset on until output reaches chunkSize or the report ends, and
+// returns where to go on from. isOpened tells whether the opening line has been passed.
+inline size_t appendReportRecords(std::string& output, OutputFormat format, std::string_view report, size_t offset,
+                                  size_t chunkSize, bool& isOpened)
+{
+    while (offset < report.size() && output.size() < chunkSize) {
+        size_t lineEnd = report.find('\n', offset);
+        if (lineEnd == std::string_view::npos)
+            lineEnd = report.size();
+
+        std::string_view line = report.substr(offset, lineEnd - offset);
+        offset = lineEnd + 1;
+        if (line.empty())
+            continue;
+
+        Record record = parseReportLine(line, isOpened);
+        isOpened = true;
+        appendRecord(output, format, record);
+    }
+
+    return offset;
+}
+
+// Table records straight from the tables, like appendTablesReport
+inline void appendTableRecords(std::string& output, OutputFormat format, const Tables& tables, size_t first,
+                               size_t last)
+{
+    Record record{ .type = RecordType::Table };
+
+    for (size_t table = first; table < last; ) {
+        const auto* page = tables.pageAt(table >> Tables::PAGE_SHIFT);
+        size_t pageEnd = std::min(last, ((table >> Tables::PAGE_SHIFT) + 1) << Tables::PAGE_SHIFT);
+
+        for (; table < pageEnd; table++) {
+            record.table = table + 1;
+            record.income = page ? page->income[table & (Tables::PAGE_SIZE - 1)] : 0;
+            record.minutes = page ? page->entireWorkingTime[table & (Tables::PAGE_SIZE - 1)] : 0;
+            appendRecord(output, format, record);
+        }
+    }
+}
+
+}
+
+#endif //COMPUTERCLUB_RECORDFORMAT_H
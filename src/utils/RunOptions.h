@@ -0,0 +1,50 @@
+#ifndef COMPUTERCLUB_RUNOPTIONS_H
+#define COMPUTERCLUB_RUNOPTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+
+enum class OutputFormat {
+    // The report of the task, byte for byte
+    Text,
+    // One JSON object per line, see RecordFormat.h
+    JsonLines,
+    // A header line, then one line per record, see RecordFormat.h
+    Csv,
+};
+
+// The parts of a report; the default ones make up the report of the task. The opening and closing times are written
+// with the echo or the generated events.
+struct ReportSections {
+    // The events of the log, as they are in it
+    bool echo{true};
+    // The events the club generates: errors, clients who have gone away and seats from the queue
+    bool events{true};
+    // A "<table number> <income> <HH:MM>" line per table
+    bool tables{true};
+    // "Revenue <income of all the tables>"
+    bool totals{false};
+
+    bool hasEventLog() const { return echo || events; }
+    bool operator==(const ReportSections&) const = default;
+};
+
+struct RunOptions {
+    // A segment takes a thread of its own, so that more threads than this are taken as this many
+    static constexpr size_t MAX_NUMBER_OF_THREADS = 256;
+
+    // The day is split into segments at the moments the club is empty, and the segments are handled in parallel
+    size_t numberOfThreads{1};
+
+    // Events up to this many minutes out of order are put back in order instead of failing the day; the day is
+    // handled on one thread then. 0 keeps the strict check of the order.
+    uint16_t reorderWindowMinutes{};
+
+    // Errors about the input are printed as text in every format
+    OutputFormat outputFormat{OutputFormat::Text};
+
+    // Sections that aren't selected are never formatted
+    ReportSections reportSections{};
+};
+
+#endif //COMPUTERCLUB_RUNOPTIONS_H
@@ -0,0 +1,171 @@
+#ifndef COMPUTERCLUB_TABLES_H
+#define COMPUTERCLUB_TABLES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Table state is stored sparsely: tables are grouped in pages of PAGE_SIZE, and a page is allocated only when one
+// of its tables is first seated. Memory thus follows the tables actually used rather than the declared number of
+// tables, and a table whose page is missing reads as never used. Inside a page the state is stored column-wise,
+// so that closing the club sweeps contiguous arrays. Times are kept in minutes since midnight.
+class Tables {
+public:
+    static constexpr size_t PAGE_SHIFT = 10;
+    static constexpr size_t PAGE_SIZE = size_t{1} << PAGE_SHIFT;
+
+    struct Page {
+        std::vector<uint8_t> isBusy;
+        std::vector<uint16_t> startWorking;
+        std::vector<uint32_t> entireWorkingTime;
+        std::vector<size_t> income;
+
+        size_t size() const { return isBusy.size(); }
+    };
+
+    size_t size() const { return _numberOfTables; }
+
+    void reset(size_t numberOfTables) {
+        // Released pages keep their capacity for the next day
+        for (size_t pageNumber : _usedPages)
+            _freePages.push_back(std::move(_pages[pageNumber]));
+
+        _numberOfTables = numberOfTables;
+        _numberOfBusyTables = 0;
+        _usedPages.clear();
+        _pages.clear();
+        _pages.resize((numberOfTables + PAGE_SIZE - 1) >> PAGE_SHIFT);
+    }
+
+    bool isBusy(size_t table) const {
+        const Page* page = findPage(table);
+        return page && page->isBusy[table & (PAGE_SIZE - 1)];
+    }
+
+    bool isAllBusy() const { return _numberOfBusyTables == _numberOfTables; }
+
+    uint16_t startWorking(size_t table) const { return findPage(table)->startWorking[table & (PAGE_SIZE - 1)]; }
+
+    uint32_t entireWorkingTime(size_t table) const {
+        const Page* page = findPage(table);
+        return page ? page->entireWorkingTime[table & (PAGE_SIZE - 1)] : 0;
+    }
+
+    size_t income(size_t table) const {
+        const Page* page = findPage(table);
+        return page ? page->income[table & (PAGE_SIZE - 1)] : 0;
+    }
+
+    void occupy(size_t table, uint16_t startWorking) {
+        Page& page = usePage(table);
+        page.isBusy[table & (PAGE_SIZE - 1)] = 1;
+        page.startWorking[table & (PAGE_SIZE - 1)] = startWorking;
+        _numberOfBusyTables++;
+    }
+
+    // The table passes to the next client without getting free
+    void restart(size_t table, uint16_t startWorking) {
+        findPage(table)->startWorking[table & (PAGE_SIZE - 1)] = startWorking;
+    }
+
+    void release(size_t table) {
+        Page* page = findPage(table);
+        page->isBusy[table & (PAGE_SIZE - 1)] = 0;
+        page->startWorking[table & (PAGE_SIZE - 1)] = 0;
+        _numberOfBusyTables--;
+    }
+
+    void addWork(size_t table, uint32_t workingTime, size_t income) {
+        Page* page = findPage(table);
+        page->entireWorkingTime[table & (PAGE_SIZE - 1)] += workingTime;
+        page->income[table & (PAGE_SIZE - 1)] += income;
+    }
+
+    // Puts a table into a given state, e.g. one restored from a checkpoint
+    void restore(size_t table, bool isBusy, uint16_t startWorking, uint32_t entireWorkingTime, size_t income) {
+        Page& page = usePage(table);
+        size_t offset = table & (PAGE_SIZE - 1);
+
+        _numberOfBusyTables += static_cast<size_t>(isBusy) - page.isBusy[offset];
+        page.isBusy[offset] = isBusy;
+        page.startWorking[offset] = startWorking;
+        page.entireWorkingTime[offset] = entireWorkingTime;
+        page.income[offset] = income;
+    }
+
+    // Pages allocated since reset, in the order of allocation
+    const std::vector<size_t>& usedPages() const { return _usedPages; }
+
+    size_t totalIncome() const {
+        size_t totalIncome = 0;
+        for (size_t pageNumber : _usedPages) {
+            for (size_t income : _pages[pageNumber]->income)
+                totalIncome += income;
+        }
+
+        return totalIncome;
+    }
+
+    Page& page(size_t pageNumber) { return *_pages[pageNumber]; }
+    const Page* pageAt(size_t pageNumber) const { return _pages[pageNumber].get(); }
+
+    void releaseAll() {
+        for (size_t pageNumber : _usedPages) {
+            std::ranges::fill(_pages[pageNumber]->isBusy, 0);
+            std::ranges::fill(_pages[pageNumber]->startWorking, 0);
+        }
+
+        _numberOfBusyTables = 0;
+    }
+
+    // Adds up the working time and income of tables handled elsewhere, e.g. in another part of the day
+    void addTotals(const Tables& tables) {
+        for (size_t pageNumber : tables._usedPages) {
+            const Page& source = *tables._pages[pageNumber];
+            Page& destination = usePage(pageNumber << PAGE_SHIFT);
+
+            for (size_t offset = 0; offset < source.size(); offset++) {
+                destination.entireWorkingTime[offset] += source.entireWorkingTime[offset];
+                destination.income[offset] += source.income[offset];
+            }
+        }
+    }
+
+private:
+    size_t _numberOfTables{};
+    size_t _numberOfBusyTables{};
+
+    std::vector<std::unique_ptr<Page>> _pages;
+    std::vector<size_t> _usedPages;
+    std::vector<std::unique_ptr<Page>> _freePages;
+
+    Page* findPage(size_t table) const { return _pages[table >> PAGE_SHIFT].get(); }
+
+    Page& usePage(size_t table) {
+        size_t pageNumber = table >> PAGE_SHIFT;
+        if (_pages[pageNumber])
+            return *_pages[pageNumber];
+
+        std::unique_ptr<Page> page;
+        if (_freePages.empty()) {
+            page = std::make_unique<Page>();
+        } else {
+            page = std::move(_freePages.back());
+            _freePages.pop_back();
+        }
+
+        // The last page covers only the tables that remain
+        size_t size = std::min(PAGE_SIZE, _numberOfTables - (pageNumber << PAGE_SHIFT));
+        page->isBusy.assign(size, 0);
+        page->startWorking.assign(size, 0);
+        page->entireWorkingTime.assign(size, 0);
+        page->income.assign(size, 0);
+
+        _usedPages.push_back(pageNumber);
+        _pages[pageNumber] = std::move(page);
+        return *_pages[pageNumber];
+    }
+};
+
+#endif //COMPUTERCLUB_TABLES_H
@@ -0,0 +1,52 @@
+#ifndef COMPUTERCLUB_TEXTFORMAT_H
+#define COMPUTERCLUB_TEXTFORMAT_H
+
+#include "InputFileData.h"
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <string_view>
+
+inline void appendNumber(std::string& output, size_t number) {
+    char buffer[20];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    output.append(buffer, result.ptr);
+}
+
+// One "<table number> <income> <HH:MM>" line per table in [first, last). Tables that were never seated have no
+// storage and are written as "<table number> 0 00:00".
+inline void appendTablesReport(std::string& output, const Tables& tables, size_t first, size_t last) {
+    for (size_t table = first; table < last; ) {
+        const auto* page = tables.pageAt(table >> Tables::PAGE_SHIFT);
+        size_t pageEnd = std::min(last, ((table >> Tables::PAGE_SHIFT) + 1) << Tables::PAGE_SHIFT);
+
+        for (; table < pageEnd; table++) {
+            appendNumber(output, table + 1);
+            if (!page) {
+                output.append(" 0 00:00\n");
+                continue;
+            }
+
+            output.push_back(' ');
+            appendNumber(output, page->income[table & (Tables::PAGE_SIZE - 1)]);
+            output.push_back(' ');
+            Time::fromMinutes(page->entireWorkingTime[table & (Tables::PAGE_SIZE - 1)]).appendTo(output);
+            output.push_back('\n');
+        }
+    }
+}
+
+inline void appendTablesReport(std::string& output, const Tables& tables) {
+    appendTablesReport(output, tables, 0, tables.size());
+}
+
+inline constexpr std::string_view REVENUE_PREFIX = "Revenue ";
+
+// "Revenue <income of all the tables>"
+inline void appendTotalsReport(std::string& output, const Tables& tables) {
+    output.append(REVENUE_PREFIX);
+    appendNumber(output, tables.totalIncome());
+    output.push_back('\n');
+}
+
+#endif //COMPUTERCLUB_TEXTFORMAT_H
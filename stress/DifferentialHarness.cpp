@@ -0,0 +1,483 @@
+#include "DifferentialHarness.h"
+#include "ReferenceEngine.h"
+#include "TaskSolver.h"
+#include "ResultCache.h"
+#include "SessionLedger.h"
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+#include "ClubServer.h"
+#include "ClubClient.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+#include "BatchRunner.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+#include <zstd.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Wide enough for most of the reordered logs to be put back in order
+constexpr uint16_t REORDER_WINDOW_MINUTES = 30;
+constexpr uintmax_t CACHE_SIZE_LIMIT = 64 << 20;
+constexpr size_t NUMBER_OF_BATCH_CLUBS = 4;
+
+// The ledger mode checks the report with a ledger attached, not the ledger itself
+class DiscardingLedgerSink : public LedgerSink {
+public:
+    void Write(const SessionLedger::Batch&) override { }
+};
+
+// ext4 writes a file that is truncated and written again out to the disk when it is closed, which takes longer
+// than all the modes together, so the file is made anew instead
+void writeFile(const std::string& path, std::string_view content) {
+    fs::remove(path);
+    std::ofstream file(path, std::ios::binary);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), {} };
+}
+
+// The header goes to both terminals and an event to the terminal of the parity of its minute, so events of the
+// same time stay in one terminal in the order of the log. Only for logs that are correct.
+void splitIntoTerminals(std::string_view content, const std::string& firstPath, const std::string& secondPath) {
+    std::string terminals[2];
+    size_t lineNumber = 0;
+
+    for (size_t position = 0; position < content.size(); lineNumber++) {
+        size_t end = std::min(content.find('\n', position), content.size());
+        auto line = content.substr(position, end - position);
+        position = end + 1;
+
+        if (lineNumber < 3) {
+            for (auto& terminal : terminals)
+                terminal.append(line).push_back('\n');
+        } else {
+            terminals[(line[3] - '0') % 2].append(line).push_back('\n');
+        }
+    }
+
+    writeFile(firstPath, terminals[0]);
+    writeFile(secondPath, terminals[1]);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+DifferentialHarness::DifferentialHarness(StressOptions options)
+                                        : _options(std::move(options)), _logGenerator(_options.seed) { }
+
+DifferentialHarness::~DifferentialHarness() = default;
+
+std::vector<std::string_view> DifferentialHarness::ModeNames() {
+    std::vector<std::string_view> names = {
+        "content", "streaming", "parallel", "reordered", "merged", "cache-store", "cache-hit", "ledger"
+    };
+#ifdef COMPUTERCLUB_HAS_ZLIB
+    names.emplace_back("gzip");
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+    names.emplace_back("zstd");
+#endif
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+    names.emplace_back("server");
+#endif
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+    names.emplace_back(BATCH);
+#endif
+
+    return names;
+}
+
+bool DifferentialHarness::Run(std::ostream& stream) {
+    std::error_code errorCode;
+    fs::create_directories(_options.workDirectory, errorCode);
+    if (errorCode) {
+        stream << _options.workDirectory << std::endl;
+        stream << "The work directory can't be created!" << std::endl;
+        return false;
+    }
+
+    if (!addModes(stream))
+        return false;
+
+    _statistics.assign(1, { std::string(REFERENCE) });
+    for (const auto& mode : _modes)
+        _statistics.push_back({ std::string(mode.name) });
+    if (_isBatchSelected)
+        _statistics.push_back({ std::string(BATCH) });
+
+    std::string content;
+    bool isMatching = true;
+
+    for (uint64_t logNumber = _options.firstLog; logNumber < _options.firstLog + _options.numberOfLogs; logNumber++) {
+        _logGenerator.Generate(logNumber, content);
+
+        reference::TaskSolver referenceSolver;
+        auto start = std::chrono::steady_clock::now();
+        auto expected = runCaught([&](std::ostream& output) { return referenceSolver.run(content, output); });
+        _statistics[0].seconds += secondsSince(start);
+        _statistics[0].numberOfLogs++;
+        _statistics[0].numberOfBytes += content.size();
+        _referenceExitCodes[expected.exitCode]++;
+
+        for (size_t modeNumber = 0; modeNumber < _modes.size(); modeNumber++) {
+            const auto& mode = _modes[modeNumber];
+            if (!mode.isComparable(expected.exitCode))
+                continue;
+
+            mode.prepare(content);
+            start = std::chrono::steady_clock::now();
+            auto outcome = runCaught([&](std::ostream& output) { return mode.run(content, output); });
+
+            auto& statistics = _statistics[modeNumber + 1];
+            statistics.seconds += secondsSince(start);
+            statistics.numberOfLogs++;
+            statistics.numberOfBytes += content.size();
+
+            if (outcome.exitCode != expected.exitCode || outcome.output != expected.output) {
+                statistics.numberOfMismatches++;
+                describeMismatch(mode.name, logNumber, content, outcome, expected, stream);
+                isMatching = false;
+            }
+        }
+
+        if (_isBatchSelected) {
+            bool isSuccess = expected.exitCode == static_cast<int>(ErrorType::Success);
+            addBatchLog(logNumber, content, expected, isSuccess ? referenceSolver.getRevenue() : 0);
+            if (_batchLogs.size() >= _options.batchSize)
+                isMatching &= runBatch(stream);
+        }
+
+        uint64_t numberOfLogsDone = logNumber - _options.firstLog + 1;
+        if (_options.progressInterval != 0 && numberOfLogsDone % _options.progressInterval == 0)
+            stream << numberOfLogsDone << " logs done" << std::endl;
+    }
+
+    if (!_batchLogs.empty())
+        isMatching &= runBatch(stream);
+
+    return isMatching;
+}
+
+void DifferentialHarness::PrintReport(std::ostream& stream) const {
+    if (_statistics.empty())
+        return;
+
+    const auto& reference = _statistics.front();
+    double referenceRate = reference.seconds > 0 ? static_cast<double>(reference.numberOfLogs) / reference.seconds : 0;
+
+    stream << std::left << std::setw(12) << "mode" << std::right << std::setw(10) << "logs" << std::setw(12)
+           << "mismatches" << std::setw(12) << "seconds" << std::setw(12) << "logs/s" << std::setw(10) << "MB/s"
+           << std::setw(14) << "vs reference" << '\n';
+
+    for (const auto& statistics : _statistics) {
+        double rate = statistics.seconds > 0 ? static_cast<double>(statistics.numberOfLogs) / statistics.seconds : 0;
+        double megabytesPerSecond = statistics.seconds > 0 ?
+                                    static_cast<double>(statistics.numberOfBytes) / 1e6 / statistics.seconds : 0;
+
+        stream << std::left << std::setw(12) << statistics.name << std::right << std::setw(10)
+               << statistics.numberOfLogs << std::setw(12) << statistics.numberOfMismatches << std::fixed
+               << std::setprecision(3) << std::setw(12) << statistics.seconds << std::setprecision(0)
+               << std::setw(12) << rate << std::setprecision(1) << std::setw(10) << megabytesPerSecond
+               << std::setprecision(2) << std::setw(13) << (referenceRate > 0 ? rate / referenceRate : 0) << 'x'
+               << std::defaultfloat << '\n';
+    }
+
+    stream << "Exit codes of the reference:";
+    for (const auto& [exitCode, numberOfLogs] : _referenceExitCodes)
+        stream << ' ' << exitCode << ": " << numberOfLogs;
+    stream << std::endl;
+}
+
+bool DifferentialHarness::isSelected(std::string_view mode) const {
+    return _options.modes.empty() || std::ranges::find(_options.modes, mode) != _options.modes.end();
+}
+
+bool DifferentialHarness::addModes(std::ostream& stream) {
+    auto modeNames = ModeNames();
+    for (const auto& mode : _options.modes) {
+        if (std::ranges::find(modeNames, mode) == modeNames.end()) {
+            stream << mode << std::endl;
+            stream << "There is no such mode in this build!" << std::endl;
+            return false;
+        }
+    }
+
+    fs::path directory = _options.workDirectory;
+    std::string logPath = (directory / "log.txt").string();
+    auto noFiles = [](std::string_view) { };
+    auto always = [](int) { return true; };
+    auto onSuccess = [](int exitCode) { return exitCode == static_cast<int>(ErrorType::Success); };
+
+    // Each mode keeps its TaskSolver between logs, as a worker of the server does
+    auto contentMode = [&](std::string_view name, RunOptions runOptions, auto isComparable) {
+        if (!isSelected(name))
+            return;
+
+        auto taskSolver = std::make_shared<TaskSolver>(nullptr, runOptions);
+        _modes.push_back({ name, noFiles, [taskSolver](std::string_view content, std::ostream& output) {
+            return taskSolver->runContent(content, output);
+        }, isComparable });
+    };
+    auto fileMode = [&](std::string_view name, const std::string& path,
+                        std::function<void(std::string_view)> prepare) {
+        if (!isSelected(name))
+            return;
+
+        auto taskSolver = std::make_shared<TaskSolver>();
+        _modes.push_back({ name, std::move(prepare), [taskSolver, path](std::string_view, std::ostream& output) {
+            return taskSolver->run(path, output);
+        }, always });
+    };
+
+    contentMode("content", {}, always);
+    fileMode("streaming", logPath, [logPath](std::string_view content) { writeFile(logPath, content); });
+    contentMode("parallel", { .numberOfThreads = _options.numberOfThreads }, always);
+
+    // A log out of order fails in another place than in the strict order, or not at all, and a day without events,
+    // on which the strict check of the order throws, is a day like any other
+    RunOptions reorderOptions;
+    reorderOptions.reorderWindowMinutes = REORDER_WINDOW_MINUTES;
+    contentMode("reordered", reorderOptions, [](int exitCode) {
+        return exitCode != static_cast<int>(ErrorType::IncorrectEventTimeSequence) &&
+               exitCode != static_cast<int>(ErrorType::UnexpectedError);
+    });
+
+    // The first error of a log split in two depends on which terminal is read first, so only correct logs
+    if (isSelected("merged")) {
+        std::vector<std::string> terminalPaths = { (directory / "terminal-1.txt").string(),
+                                                   (directory / "terminal-2.txt").string() };
+        auto taskSolver = std::make_shared<TaskSolver>();
+        _modes.push_back({ "merged", [terminalPaths](std::string_view content) {
+            splitIntoTerminals(content, terminalPaths[0], terminalPaths[1]);
+        }, [taskSolver, terminalPaths](std::string_view, std::ostream& output) {
+            return taskSolver->runMerged(terminalPaths, output);
+        }, onSuccess });
+    }
+
+    // The same cache for both: a log is stored by the first and answered from the cache by the second
+    if (isSelected("cache-store") || isSelected("cache-hit")) {
+        auto cachePath = directory / "cache";
+        fs::remove_all(cachePath);
+        auto resultCache = std::make_shared<ResultCache>(cachePath, CACHE_SIZE_LIMIT);
+        auto taskSolver = std::make_shared<TaskSolver>(nullptr, RunOptions{}, resultCache.get());
+        auto run = [resultCache, taskSolver](std::string_view content, std::ostream& output) {
+            return taskSolver->runContent(content, output);
+        };
+
+        for (std::string_view name : { "cache-store", "cache-hit" }) {
+            if (isSelected(name))
+                _modes.push_back({ name, noFiles, run, always });
+        }
+    }
+
+    if (isSelected("ledger")) {
+        auto ledgerSink = std::make_shared<DiscardingLedgerSink>();
+        auto sessionLedger = std::make_shared<SessionLedger>(*ledgerSink);
+        auto taskSolver = std::make_shared<TaskSolver>(nullptr, RunOptions{}, nullptr, nullptr, sessionLedger.get());
+        _modes.push_back({ "ledger", noFiles, [ledgerSink, sessionLedger, taskSolver](std::string_view content,
+                                                                                        std::ostream& output) {
+            return taskSolver->runContent(content, output);
+        }, always });
+    }
+
+#ifdef COMPUTERCLUB_HAS_ZLIB
+    std::string gzipPath = logPath + ".gz";
+    fileMode("gzip", gzipPath, [gzipPath](std::string_view content) {
+        fs::remove(gzipPath);
+        gzFile file = gzopen(gzipPath.c_str(), "wb1");
+        gzwrite(file, content.data(), static_cast<unsigned>(content.size()));
+        gzclose(file);
+    });
+#endif
+
+#ifdef COMPUTERCLUB_HAS_ZSTD
+    std::string zstdPath = logPath + ".zst";
+    fileMode("zstd", zstdPath, [zstdPath](std::string_view content) {
+        std::string compressed(ZSTD_compressBound(content.size()), '\0');
+        compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), content.data(), content.size(), 1));
+        writeFile(zstdPath, compressed);
+    });
+#endif
+
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+    if (isSelected("server")) {
+        std::string socketPath = (directory / "club.sock").string();
+        auto clubServer = std::make_shared<ClubServer>(socketPath, _options.numberOfThreads, RunOptions{});
+        if (!clubServer->Start()) {
+            stream << socketPath << std::endl;
+            stream << "The socket of the server can't be bound!" << std::endl;
+            return false;
+        }
+
+        _modes.push_back({ "server", noFiles, [clubServer, socketPath](std::string_view content,
+                                                                       std::ostream& output) {
+            std::string report;
+            int exitCode = ClubClient::RunContent(socketPath, content, report);
+            output << report;
+            return exitCode;
+        }, always });
+    }
+#endif
+
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+    if (isSelected(BATCH)) {
+        if (_options.binaryPath.empty()) {
+            stream << BATCH << std::endl;
+            stream << "The batch mode needs the path to the program for its workers!" << std::endl;
+            return false;
+        }
+
+        fs::create_directories(directory / BATCH);
+        _isBatchSelected = true;
+    }
+#endif
+
+    return true;
+}
+
+void DifferentialHarness::addBatchLog(uint64_t logNumber, std::string_view content, const Outcome& outcome,
+                                      size_t revenue)
+{
+    auto path = fs::path(_options.workDirectory) / BATCH / ("log-" + std::to_string(_batchLogs.size()) + ".txt");
+    writeFile(path.string(), content);
+    _batchLogs.push_back({ logNumber, path.string(), outcome, revenue });
+}
+
+// The batch prints the report of every log after "<club> <path>", then the revenue of every club and the total
+bool DifferentialHarness::runBatch(std::ostream& stream) {
+    auto& statistics = _statistics.back();
+    auto batchDirectory = fs::path(_options.workDirectory) / BATCH;
+    std::string expected;
+    std::map<std::string, size_t> revenueByClub;
+    size_t totalRevenue = 0;
+
+    std::string manifest;
+    for (const auto& log : _batchLogs) {
+        std::string club = "club" + std::to_string(log.logNumber % NUMBER_OF_BATCH_CLUBS);
+        manifest.append(club).append(" ").append(log.path).append("\n");
+
+        expected.append(club).append(" ").append(log.path).append("\n").append(log.outcome.output);
+        revenueByClub[club] += log.revenue;
+        totalRevenue += log.revenue;
+        statistics.numberOfBytes += fs::file_size(log.path);
+    }
+    writeFile((batchDirectory / "logs.manifest").string(), manifest);
+
+    expected.append("Revenue by club:\n");
+    for (const auto& [club, revenue] : revenueByClub)
+        expected.append(club).append(" ").append(std::to_string(revenue)).append("\n");
+    expected.append("Total ").append(std::to_string(totalRevenue)).append("\n");
+
+    bool isMatching = true;
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+    // A shard with a result is never run again, so every batch starts in an empty work directory
+    auto workDirectory = batchDirectory / "work";
+    fs::remove_all(workDirectory);
+
+    BatchOptions batchOptions;
+    batchOptions.manifestPath = (batchDirectory / "logs.manifest").string();
+    batchOptions.workDirectory = workDirectory.string();
+    batchOptions.numberOfWorkers = _options.numberOfThreads;
+    batchOptions.numberOfRetries = 0;
+    batchOptions.binaryPath = _options.binaryPath;
+
+    std::ostringstream output;
+    auto start = std::chrono::steady_clock::now();
+    int exitCode = BatchRunner(batchOptions).Run(output);
+    statistics.seconds += secondsSince(start);
+    statistics.numberOfLogs += _batchLogs.size();
+
+    // The first log whose part of the report differs is described, as the parts after it are shifted
+    std::string report = output.str();
+    if (exitCode != static_cast<int>(ErrorType::Success) || report != expected) {
+        statistics.numberOfMismatches++;
+        isMatching = false;
+
+        size_t position = 0;
+        auto log = _batchLogs.cbegin();
+        for (; log != _batchLogs.cend(); ++log) {
+            size_t partSize = expected.find('\n', position) + 1 - position + log->outcome.output.size();
+            if (report.compare(position, partSize, expected, position, partSize) != 0)
+                break;
+            position += partSize;
+        }
+
+        if (log == _batchLogs.cend()) {
+            Outcome outcome{ exitCode, report };
+            describeMismatch(BATCH, _batchLogs.back().logNumber, readFile(_batchLogs.back().path), outcome,
+                             { static_cast<int>(ErrorType::Success), expected }, stream);
+        } else {
+            Outcome outcome{ exitCode, report.substr(std::min(position, report.size())) };
+            describeMismatch(BATCH, log->logNumber, readFile(log->path), outcome,
+                             { static_cast<int>(ErrorType::Success), expected.substr(position) }, stream);
+        }
+    }
+#endif
+
+    _batchLogs.clear();
+    return isMatching;
+}
+
+void DifferentialHarness::describeMismatch(std::string_view mode, uint64_t logNumber, std::string_view content,
+                                           const Outcome& outcome, const Outcome& expected, std::ostream& stream)
+{
+    if (++_numberOfDescribedMismatches > MAX_DESCRIBED_MISMATCHES)
+        return;
+
+    auto path = fs::path(_options.workDirectory) / ("mismatch-" + std::to_string(logNumber) + ".txt");
+    writeFile(path.string(), content);
+
+    stream << mode << ": log " << logNumber << " of seed " << _options.seed << " differs from the reference, "
+           << "the log is " << path.string() << std::endl;
+    if (outcome.exitCode != expected.exitCode)
+        stream << "  exit code " << outcome.exitCode << ", the reference " << expected.exitCode << std::endl;
+
+    std::istringstream lines(outcome.output), expectedLines(expected.output);
+    std::string line, expectedLine;
+    for (size_t lineNumber = 1; ; lineNumber++) {
+        bool hasLine = static_cast<bool>(std::getline(lines, line));
+        bool hasExpectedLine = static_cast<bool>(std::getline(expectedLines, expectedLine));
+        if (!hasLine && !hasExpectedLine)
+            break;
+
+        if (hasLine != hasExpectedLine || line != expectedLine) {
+            stream << "  line " << lineNumber << ": \"" << (hasLine ? line : "<none>") << "\", the reference \""
+                   << (hasExpectedLine ? expectedLine : "<none>") << '"' << std::endl;
+            break;
+        }
+    }
+}
+
+DifferentialHarness::Outcome DifferentialHarness::runCaught(const std::function<int(std::ostream&)>& run) {
+    std::ostringstream stream;
+    Outcome outcome;
+
+    try {
+        outcome.exitCode = run(stream);
+    } catch (const std::exception& exception) {
+        stream << "Caught an unexpected exception: " << exception.what() << std::endl;
+        outcome.exitCode = static_cast<int>(ErrorType::UnexpectedError);
+    }
+
+    outcome.output = stream.str();
+    return outcome;
+}
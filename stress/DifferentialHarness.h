@@ -0,0 +1,118 @@
+#ifndef COMPUTERCLUB_DIFFERENTIALHARNESS_H
+#define COMPUTERCLUB_DIFFERENTIALHARNESS_H
+
+#include "LogGenerator.h"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct StressOptions {
+    uint64_t seed{1};
+    uint64_t firstLog{};
+    uint64_t numberOfLogs{1000000};
+    // Empty runs every mode of the build
+    std::vector<std::string> modes;
+    // Threads of the parallel mode, workers of the server and of the batch
+    size_t numberOfThreads{4};
+    // Logs per run of the batch mode, which starts binaryPath as its workers
+    size_t batchSize{1000};
+    std::string binaryPath;
+    // The files the modes read, and a copy of every log that differs; all of it is removed before a run
+    std::string workDirectory;
+    // How many logs are done is printed every this many logs; 0 never
+    uint64_t progressInterval{};
+};
+
+// Runs random logs through the frozen reference engine and through every mode of the engine, and checks that
+// each mode prints the same bytes and returns the same exit code, an unexpected exception included. Each mode is
+// timed apart from writing the files it reads, so its throughput is seen next to the reference's.
+class DifferentialHarness {
+public:
+    static constexpr std::string_view REFERENCE = "reference";
+    static constexpr std::string_view BATCH = "batch";
+    // More mismatches are counted but not described
+    static constexpr size_t MAX_DESCRIBED_MISMATCHES = 10;
+
+    struct ModeStatistics {
+        std::string name;
+        uint64_t numberOfLogs{};
+        uint64_t numberOfBytes{};
+        uint64_t numberOfMismatches{};
+        double seconds{};
+    };
+
+    explicit DifferentialHarness(StressOptions options);
+    ~DifferentialHarness();
+
+    DifferentialHarness(const DifferentialHarness&) = delete;
+    DifferentialHarness& operator=(const DifferentialHarness&) = delete;
+
+    // The modes of this build, in the order they are run
+    static std::vector<std::string_view> ModeNames();
+
+    // Describes every mismatch to stream as it is found. Returns false if a mode differs from the reference or
+    // can't be started, or if an unknown mode is asked for.
+    bool Run(std::ostream& stream);
+
+    // Throughput of the reference and of each mode side by side, and how many logs the reference ended with each
+    // exit code
+    void PrintReport(std::ostream& stream) const;
+
+    // The reference first, then the modes in the order they are run
+    const std::vector<ModeStatistics>& statistics() const { return _statistics; }
+    const std::map<int, uint64_t>& referenceExitCodes() const { return _referenceExitCodes; }
+
+private:
+    // What the command line would print and return
+    struct Outcome {
+        int exitCode{};
+        std::string output;
+    };
+
+    struct Mode {
+        std::string_view name;
+        // Writes the files the mode reads, outside of the measured time
+        std::function<void(std::string_view content)> prepare;
+        std::function<int(std::string_view content, std::ostream& stream)> run;
+        // Modes that give some logs another meaning, e.g. reordering, are compared on the other logs only
+        std::function<bool(int referenceExitCode)> isComparable;
+    };
+
+    // A log of the batch being gathered, with what the reference made of it
+    struct BatchLog {
+        uint64_t logNumber{};
+        std::string path;
+        Outcome outcome;
+        size_t revenue{};
+    };
+
+    StressOptions _options;
+    LogGenerator _logGenerator;
+    // Every mode owns what it runs with, e.g. its TaskSolver or the server
+    std::vector<Mode> _modes;
+    bool _isBatchSelected{false};
+    std::vector<BatchLog> _batchLogs;
+
+    std::vector<ModeStatistics> _statistics;
+    std::map<int, uint64_t> _referenceExitCodes;
+    uint64_t _numberOfDescribedMismatches{};
+
+    bool isSelected(std::string_view mode) const;
+    // Returns false if a mode is unknown or can't be started
+    bool addModes(std::ostream& stream);
+    void addBatchLog(uint64_t logNumber, std::string_view content, const Outcome& outcome, size_t revenue);
+    bool runBatch(std::ostream& stream);
+
+    void describeMismatch(std::string_view mode, uint64_t logNumber, std::string_view content,
+                          const Outcome& outcome, const Outcome& expected, std::ostream& stream);
+
+    // Runs like main does: an exception is printed and ends the run with ErrorType::UnexpectedError
+    static Outcome runCaught(const std::function<int(std::ostream&)>& run);
+};
+
+
+#endif //COMPUTERCLUB_DIFFERENTIALHARNESS_H
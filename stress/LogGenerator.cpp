@@ -0,0 +1,218 @@
+#include "LogGenerator.h"
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace {
+
+constexpr uint16_t MINUTES_IN_DAY = 24 * 60;
+constexpr std::string_view NAME_SYMBOLS = "abcdefghijklmnopqrstuvwxyz0123456789_-";
+
+// SplitMix64, so that neighbouring log numbers give unrelated generator states
+uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+std::string formatTime(size_t minutes) {
+    return { static_cast<char>('0' + minutes / 60 / 10), static_cast<char>('0' + minutes / 60 % 10), ':',
+             static_cast<char>('0' + minutes % 60 / 10), static_cast<char>('0' + minutes % 60 % 10) };
+}
+
+size_t parseTime(std::string_view line) {
+    return static_cast<size_t>((line[0] - '0') * 10 + (line[1] - '0')) * 60 + (line[3] - '0') * 10 + (line[4] - '0');
+}
+
+}
+
+void LogGenerator::Generate(uint64_t logNumber, std::string& content) {
+    _random.seed(mix(_seed ^ mix(logNumber)));
+    _lines.clear();
+    generateDay();
+
+    bool isEndingBroken = false;
+    if (chance(BROKEN_LOG_SHARE)) {
+        switch (uniform(0, 3)) {
+            case 0:
+                breakHeader();
+                break;
+            case 1:
+                breakEvent();
+                break;
+            case 2:
+                breakOrder();
+                break;
+            default:
+                isEndingBroken = true;
+                break;
+        }
+    }
+
+    content.clear();
+    for (const auto& line : _lines)
+        content.append(line).push_back('\n');
+
+    if (isEndingBroken)
+        breakEnding(content);
+}
+
+size_t LogGenerator::uniform(size_t min, size_t max) {
+    return std::uniform_int_distribution<size_t>(min, max)(_random);
+}
+
+bool LogGenerator::chance(double probability) {
+    return std::bernoulli_distribution(probability)(_random);
+}
+
+// Few clients per table, so that the tables fill up, the queue overflows and the club is empty now and then
+void LogGenerator::generateDay() {
+    size_t numberOfTables = chance(0.9) ? uniform(1, 8) : uniform(9, 60);
+    size_t opening = uniform(0, MINUTES_IN_DAY - 60);
+    size_t closing = chance(0.15) ? std::min<size_t>(opening + uniform(1, 59), MINUTES_IN_DAY - 1)
+                                  : uniform(opening + 1, MINUTES_IN_DAY - 1);
+
+    _lines.push_back(std::to_string(numberOfTables));
+    _lines.push_back(formatTime(opening) + ' ' + formatTime(closing));
+    _lines.push_back(chance(0.02) ? "2147483647" : std::to_string(uniform(1, 500)));
+
+    auto randomName = [this]() {
+        std::string name(uniform(1, 8), ' ');
+        for (auto& symbol : name)
+            symbol = NAME_SYMBOLS[uniform(0, NAME_SYMBOLS.size() - 1)];
+        return name;
+    };
+
+    _names.resize(uniform(1, 3 * numberOfTables + 3));
+    for (auto& name : _names)
+        name = randomName();
+
+    size_t numberOfEvents = chance(0.02) ? 0 : chance(0.05) ? uniform(200, 2000) : uniform(1, 120);
+    constexpr std::array<size_t, 9> STEPS = { 0, 0, 0, 1, 1, 2, 5, 10, 30 };
+    // Events start up to an hour and a half before the opening, so some of them are in the opening hour but
+    // before the opening minute
+    size_t time = opening - std::min<size_t>(opening, uniform(0, 90));
+
+    for (size_t event = 0; event < numberOfEvents; event++) {
+        time += STEPS[uniform(0, STEPS.size() - 1)];
+        if (time >= closing)
+            break;
+
+        size_t idWeight = uniform(1, 100);
+        char id = idWeight <= 30 ? '1' : idWeight <= 60 ? '2' : idWeight <= 75 ? '3' : '4';
+        std::string line = formatTime(time) + ' ' + id + ' ' +
+                           (chance(0.1) ? randomName() : _names[uniform(0, _names.size() - 1)]);
+        if (id == '2')
+            line.append(" ").append(std::to_string(uniform(1, numberOfTables)));
+
+        _lines.push_back(std::move(line));
+    }
+}
+
+void LogGenerator::breakHeader() {
+    static constexpr std::array<std::string_view, 9> NUMBERS = {
+        "", "0", "-1", "01", "1a", " 3", "3 ", "2147483648", "99999999999999999999"
+    };
+    static constexpr std::array<std::string_view, 12> WORKING_HOURS = {
+        "", "09:00", "09:00-19:00", "9:00 19:00", "24:00 19:00", "09:60 19:00", "09:00 19:0", "09:00 24:00",
+        "19:00 09:00", "09:00 09:00", "09:00 19:00 ", "09:00  19:00"
+    };
+
+    size_t line = uniform(0, 3);
+    if (line == 3) {
+        // The log ends inside the header
+        _lines.resize(uniform(0, 2));
+        return;
+    }
+
+    if (line == 1)
+        _lines[line] = WORKING_HOURS[uniform(0, WORKING_HOURS.size() - 1)];
+    else
+        _lines[line] = NUMBERS[uniform(0, NUMBERS.size() - 1)];
+}
+
+void LogGenerator::breakEvent() {
+    if (_lines.size() == 3) {
+        _lines.emplace_back("09:00");
+        return;
+    }
+
+    auto& line = _lines[uniform(3, _lines.size() - 1)];
+    std::string time = line.substr(0, 5);
+    std::string id = line.substr(6, 1);
+    std::string body = line.substr(8);
+    std::string name = body.substr(0, body.find(' '));
+
+    static constexpr std::array<std::string_view, 7> TIMES = {
+        "9:00", "24:00", "09:60", "0900", "ab:cd", "09:00:00", ""
+    };
+    static constexpr std::array<std::string_view, 6> IDS = { "0", "5", "11", "", "a", "2 " };
+    static constexpr std::array<std::string_view, 7> TABLES = { "0", "01", "2147483648", "-1", "1x", "1 2", "" };
+
+    switch (uniform(0, 8)) {
+        case 0:
+            std::erase(line, ' ');
+            break;
+        case 1:
+            line = time + ' ' + id;
+            break;
+        case 2:
+            line = time + "  " + id + ' ' + body;
+            break;
+        case 3:
+            line = std::string(TIMES[uniform(0, TIMES.size() - 1)]) + ' ' + id + ' ' + body;
+            break;
+        case 4:
+            line = formatTime(uniform(parseTime(_lines[1].substr(6)), MINUTES_IN_DAY - 1)) + ' ' + id + ' ' + body;
+            break;
+        case 5:
+            line = time + ' ' + std::string(IDS[uniform(0, IDS.size() - 1)]) + ' ' + body;
+            break;
+        case 6:
+            name.insert(uniform(0, name.size()), uniform(0, 1) == 0 ? "A" : "!");
+            line = time + ' ' + id + ' ' + name;
+            break;
+        case 7:
+            line = time + " 2 " + name;
+            break;
+        default:
+            line = time + " 2 " + name + ' ' + std::string(TABLES[uniform(0, TABLES.size() - 1)]);
+            break;
+    }
+}
+
+// An event earlier than the one before it
+void LogGenerator::breakOrder() {
+    for (size_t attempt = 0; attempt < 8 && _lines.size() > 4; attempt++) {
+        size_t event = uniform(4, _lines.size() - 1);
+        size_t previousTime = parseTime(_lines[event - 1]);
+        if (previousTime == 0)
+            continue;
+
+        _lines[event].replace(0, 5, formatTime(uniform(0, previousTime - 1)));
+        return;
+    }
+}
+
+void LogGenerator::breakEnding(std::string& content) {
+    switch (uniform(0, 4)) {
+        case 0:
+            for (size_t pos = content.find('\n'); pos != std::string::npos; pos = content.find('\n', pos + 2))
+                content.insert(pos, "\r");
+            break;
+        case 1:
+            if (!content.empty())
+                content.pop_back();
+            break;
+        case 2:
+            content.push_back('\n');
+            break;
+        case 3:
+            content.insert(content.size() - 1, " ");
+            break;
+        default:
+            content.insert(0, "\xEF\xBB\xBF");
+            break;
+    }
+}
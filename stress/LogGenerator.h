@@ -0,0 +1,39 @@
+#ifndef COMPUTERCLUB_LOGGENERATOR_H
+#define COMPUTERCLUB_LOGGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Random logs of one working day. Most are well-formed days with short visits, crowds that fill the tables and
+// the queue, clients nobody knows and events before the opening minute of the opening hour; the rest have one
+// thing broken: a header line, an event line, the order of events, the line endings or the end of the file.
+// Log N of a seed is always the same, so any log can be made again from the seed and its number.
+class LogGenerator {
+public:
+    // How often a log has one thing broken
+    static constexpr double BROKEN_LOG_SHARE = 0.3;
+
+    explicit LogGenerator(uint64_t seed) : _seed(seed) { }
+
+    void Generate(uint64_t logNumber, std::string& content);
+
+private:
+    uint64_t _seed;
+    std::mt19937_64 _random;
+    std::vector<std::string> _names;
+    std::vector<std::string> _lines;
+
+    size_t uniform(size_t min, size_t max);
+    bool chance(double probability);
+
+    void generateDay();
+    void breakHeader();
+    void breakEvent();
+    void breakOrder();
+    void breakEnding(std::string& content);
+};
+
+
+#endif //COMPUTERCLUB_LOGGENERATOR_H
@@ -0,0 +1,183 @@
+#ifndef COMPUTERCLUB_REFERENCEENGINE_H
+#define COMPUTERCLUB_REFERENCEENGINE_H
+
+#include "ErrorTypes.h"
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FileParser, EventHandler and TaskSolver as they were written first, frozen as the definition of what the program
+// prints. Every engine mode is checked against them byte for byte, quirks included: NotOpenYet looks at the hours
+// of the opening time only, and a client who wants to wait while the queue is as long as the number of tables
+// goes away. The engine reads its logs from memory here and writes to a stream, and a number out of the range of
+// int is malformed instead of making std::stoi throw, as the program does now; nothing else may ever change.
+namespace reference {
+
+inline constexpr char WORD_DELIMITER = ' ';
+inline constexpr char TIME_DELIMITER = ':';
+
+inline constexpr std::string_view ERROR1 = "NotOpenYet";
+inline constexpr std::string_view ERROR2 = "YouShallNotPass";
+inline constexpr std::string_view ERROR3 = "ClientUnknown";
+inline constexpr std::string_view ERROR4 = "PlaceIsBusy";
+inline constexpr std::string_view ERROR5 = "ICanWaitNoLonger!";
+inline constexpr std::string_view ERROR6 = "ClientHasAlreadySatDownAtTheTable!";
+inline constexpr std::string_view ERROR7 = "ClientIsAlreadyWaiting!";
+
+inline constexpr uint16_t MINUTES_IN_HOUR = 60;
+
+struct Time {
+    uint16_t hours{};
+    uint16_t minutes{};
+
+    bool operator>= (const Time& time) const {
+        return (hours > time.hours || (hours == time.hours && minutes >= time.minutes));
+    }
+
+    std::string toString() const {
+        std::string result;
+        if (hours < 10) {
+            result.append("0").append(std::to_string(hours));
+            if (minutes < 10)
+                return result.append(":").append("0").append(std::to_string(minutes));
+            else
+                return result.append(":").append(std::to_string(minutes));
+        } else {
+            result.append(std::to_string(hours));
+            if (minutes < 10)
+                return result.append(":").append("0").append(std::to_string(minutes));
+            else
+                return result.append(":").append(std::to_string(minutes));
+        }
+    }
+};
+
+struct ComputerClubFeatures {
+    size_t numberOfTables{};
+    Time closingTime;
+    Time openingTime;
+    size_t costPerHour{};
+};
+
+enum class IncomingEventID {
+    NoEvent = 0,
+    ClientHasCome,
+    ClientHasSatDownAtTheTable,
+    ClientIsWaiting,
+    ClientHasGoneAway,
+};
+
+struct Event {
+    Time eventTime;
+    IncomingEventID eventId;
+    std::string eventBody;
+};
+
+struct Error {
+    ErrorType errorType{ErrorType::Success};
+    std::string errorStr;
+};
+
+struct InputFileData {
+    ComputerClubFeatures computerClubFeatures;
+    std::vector<Event> computerClubEvents;
+    std::vector<std::string> initialEvents;
+};
+
+struct ClientStatus {
+    IncomingEventID eventId{IncomingEventID::NoEvent};
+    size_t numberOfBusyTable{};
+};
+
+struct Table {
+    Time startWorking, entireWorkingTime;
+    size_t income{};
+    bool isBusy{false};
+};
+
+enum class OutgoingEventID {
+    ClientHasGoneAway = 11,
+    ClientHasSatDownAtTheTable,
+    Error,
+};
+
+class FileParser {
+public:
+    static void Parse(std::string_view content, InputFileData& inputFileData, Error& error);
+
+private:
+    static bool isPositiveNumber(const std::string& data);
+
+    static bool isCorrectWorkingHoursFormat(const std::string& data, ErrorType& errorType,
+                                            Time& opening, Time& closing);
+    static bool isCorrectTimeFormat(const std::string& data, Time& time);
+    static bool isCorrectHourFormat(const std::string& data);
+    static bool isCorrectMinuteFormat(const std::string& data);
+
+    static void parseEvents(std::istream& txtFile, InputFileData& inputFileData, Error& error);
+
+    static bool isCorrectEventId(const std::string& data, ErrorType& errorType, IncomingEventID& eventId);
+    static bool isCorrectEventBody(const std::string& data, IncomingEventID eventId,
+                                   size_t numberOfTables, ErrorType& errorType);
+    static bool isCorrectClientName(const std::string& data);
+};
+
+class EventHandler {
+public:
+    explicit EventHandler(InputFileData inputFileData)
+                        : _inputFileData(std::move(inputFileData)) { }
+
+    void HandleEventsOfTheDay(std::vector<std::string>& outputData, Error& error, std::vector<Table>& tables);
+
+private:
+    InputFileData _inputFileData;
+    std::map<std::string, ClientStatus> _clientStatuses;
+    std::list<std::string> _waitingClients;
+
+    bool isCorrectInputFileData(Error& error);
+    bool isCorrectSequenceOfEventTimes(size_t& eventNumber);
+
+    void handleFirstEvent(const Event& event, std::vector<std::string>& outputData);
+    void handleSecondEvent(const Event& event, std::vector<std::string>& outputData, std::vector<Table>& tables);
+    void handleThirdEvent(const Event& event, std::vector<std::string>& outputData, const std::vector<Table>& tables);
+    void handleFourthEvent(const Event& event, std::vector<std::string>& outputData, std::vector<Table>& tables);
+
+    bool isClientKnown(const Time& eventTime, const std::map<std::string, ClientStatus>::iterator& clientNameIterator,
+                       std::vector<std::string>& outputData);
+
+    void freePreviousTable(const Time& eventTime, Table& previousTable);
+
+    void calculateCurrentTableParameters(Table& table, const Time& stopWorking) const;
+
+    static bool isAllTablesBusy(const std::vector<Table>& tables);
+
+    void closeTheClub(std::vector<std::string>& outputFileData, std::vector<Table>& tables);
+};
+
+// One TaskSolver per run, as in the original
+class TaskSolver {
+public:
+    int run(std::string_view content, std::ostream& stream);
+
+    // The income of all the tables, for the revenue of a batch
+    size_t getRevenue() const;
+
+private:
+    InputFileData _inputFileData;
+    Error _error;
+    std::vector<Table> _tables;
+    std::vector<std::string> _outputData;
+    std::string _result;
+
+    void writeResultInfo();
+    void collectResultInfo();
+};
+
+}
+
+
+#endif //COMPUTERCLUB_REFERENCEENGINE_H
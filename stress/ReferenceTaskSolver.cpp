@@ -0,0 +1,131 @@
+#include "ReferenceEngine.h"
+#include <sstream>
+
+namespace reference {
+
+int TaskSolver::run(std::string_view content, std::ostream& stream) {
+    FileParser::Parse(content, _inputFileData, _error);
+
+    if (_error.errorType != ErrorType::Success) {
+        switch (_error.errorType) {
+            case ErrorType::IncorrectNumberOfTables:
+                stream << _error.errorStr << std::endl;
+                stream << "The number of tables is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectNumberOfTables);
+
+            case ErrorType::IncorrectWorkingHoursFormat:
+                stream << _error.errorStr << std::endl;
+                stream << "There is an error in delimiter symbol in working hours format!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectWorkingHoursFormat);
+
+            case ErrorType::IncorrectOpeningTime:
+                stream << _error.errorStr << std::endl;
+                stream << "The opening time format is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectOpeningTime);
+
+            case ErrorType::IncorrectClosingTime:
+                stream << _error.errorStr << std::endl;
+                stream << "The closing time format is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectClosingTime);
+
+            case ErrorType::OpeningTimeIsNotLessThanClosingTime:
+                stream << _error.errorStr << std::endl;
+                stream << "The opening time is not less than the closing time!" << std::endl;
+                return static_cast<int>(ErrorType::OpeningTimeIsNotLessThanClosingTime);
+
+            case ErrorType::IncorrectCostPerHour:
+                stream << _error.errorStr << std::endl;
+                stream << "The cost per hour in computer club is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectCostPerHour);
+
+            case ErrorType::NoDelimiters:
+                stream << _error.errorStr << std::endl;
+                stream << "There is no delimiters in event description!" << std::endl;
+                return static_cast<int>(ErrorType::NoDelimiters);
+
+            case ErrorType::TooLittleDelimiters:
+                stream << _error.errorStr << std::endl;
+                stream << "There is only one delimiter in event description!" << std::endl;
+                return static_cast<int>(ErrorType::TooLittleDelimiters);
+
+            case ErrorType::IncorrectEventTime:
+                stream << _error.errorStr << std::endl;
+                stream << "The event time format is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectEventTime);
+
+            case ErrorType::EventTimeIsNotLessThanClosingTime:
+                stream << _error.errorStr << std::endl;
+                stream << "The event time is not less than closing time!" << std::endl;
+                return static_cast<int>(ErrorType::EventTimeIsNotLessThanClosingTime);
+
+            case ErrorType::IncorrectEventID:
+                stream << _error.errorStr << std::endl;
+                stream << "The event ID format is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectEventID);
+
+            case ErrorType::IncorrectBodyEventWithSecondID:
+                stream << _error.errorStr << std::endl;
+                stream << "There is no delimiter for event body with second ID!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectBodyEventWithSecondID);
+
+            case ErrorType::IncorrectClientName:
+                stream << _error.errorStr << std::endl;
+                stream << "The client name included in event body is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectClientName);
+
+            case ErrorType::IncorrectTableNumber:
+                stream << _error.errorStr << std::endl;
+                stream << "The table number included in event body is incorrect!" << std::endl;
+                return static_cast<int>(ErrorType::IncorrectTableNumber);
+
+            default:
+                stream << _error.errorStr << std::endl;
+                stream << "The table number more than number of tables!" << std::endl;
+                return static_cast<int>(ErrorType::TableNumberMoreThanNumberOfTables);
+        }
+    }
+
+    EventHandler eventHandler(std::move(_inputFileData));
+    eventHandler.HandleEventsOfTheDay(_outputData, _error, _tables);
+
+    if (_error.errorType == ErrorType::IncorrectEventTimeSequence) {
+        stream << _error.errorStr << std::endl;
+        stream << "The time sequence of events is incorrect!" << std::endl;
+        return static_cast<int>(ErrorType::IncorrectEventTimeSequence);
+    }
+
+    writeResultInfo();
+    collectResultInfo();
+
+    stream << _result << std::endl;
+
+    return static_cast<int>(_error.errorType);
+}
+
+size_t TaskSolver::getRevenue() const {
+    size_t revenue = 0;
+    for (const auto& table : _tables)
+        revenue += table.income;
+
+    return revenue;
+}
+
+void TaskSolver::writeResultInfo() {
+    size_t tableNumber = 1;
+    for (const auto& table: _tables) {
+        _outputData.push_back(std::to_string(tableNumber++).append(" ").append(std::to_string(table.income))
+                              .append(" ").append(table.entireWorkingTime.toString()));
+    }
+}
+
+void TaskSolver::collectResultInfo() {
+    std::ostringstream oss;
+
+    for (const auto& outputLine : _outputData) {
+        oss << outputLine << '\n';
+    }
+
+    _result = oss.str();
+}
+
+}
@@ -0,0 +1,85 @@
+#include "DifferentialHarness.h"
+#include "ErrorTypes.h"
+#include <charconv>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+template <typename Number>
+bool parseNumber(std::string_view value, Number& number) {
+    auto [end, errorCode] = std::from_chars(value.data(), value.data() + value.size(), number);
+    return !value.empty() && errorCode == std::errc() && end == value.data() + value.size();
+}
+
+void printUsage() {
+    std::cout << "YadroComputerClubStress [--logs <N>] [--first <N>] [--seed <N>] [--modes <mode>,...] "
+                 "[--threads <N>] [--batch-size <N>] [--work-dir <directory>] [--progress <N>]" << std::endl;
+    std::cout << "Modes:";
+    for (auto mode : DifferentialHarness::ModeNames())
+        std::cout << ' ' << mode;
+    std::cout << std::endl;
+}
+
+}
+
+// Compares every engine mode with the reference on random logs; exits with 1 if any of them differs
+int main(int argc, char** argv) {
+    StressOptions options;
+    options.workDirectory = fs::temp_directory_path().string();
+#ifdef COMPUTERCLUB_BINARY_PATH
+    options.binaryPath = COMPUTERCLUB_BINARY_PATH;
+#endif
+
+    const std::unordered_map<std::string_view, std::function<bool(std::string_view)>> optionParsers = {
+        { "--logs", [&options](std::string_view value) { return parseNumber(value, options.numberOfLogs); }},
+        { "--first", [&options](std::string_view value) { return parseNumber(value, options.firstLog); }},
+        { "--seed", [&options](std::string_view value) { return parseNumber(value, options.seed); }},
+        { "--threads", [&options](std::string_view value) {
+            return parseNumber(value, options.numberOfThreads) && options.numberOfThreads > 0;
+        }},
+        { "--batch-size", [&options](std::string_view value) {
+            return parseNumber(value, options.batchSize) && options.batchSize > 0;
+        }},
+        { "--progress", [&options](std::string_view value) {
+            return parseNumber(value, options.progressInterval);
+        }},
+        { "--work-dir", [&options](std::string_view value) {
+            options.workDirectory = value;
+            return !value.empty();
+        }},
+        { "--modes", [&options](std::string_view value) {
+            options.modes.clear();
+            for (size_t begin = 0; begin <= value.size(); ) {
+                size_t end = std::min(value.find(',', begin), value.size());
+                options.modes.emplace_back(value.substr(begin, end - begin));
+                begin = end + 1;
+            }
+            return true;
+        }},
+    };
+
+    for (int arg = 1; arg < argc; arg += 2) {
+        auto parser = optionParsers.find(argv[arg]);
+        if (parser == optionParsers.end() || arg + 1 == argc || !parser->second(argv[arg + 1])) {
+            printUsage();
+            return static_cast<int>(ErrorType::IncorrectCommandLineOption);
+        }
+    }
+
+    // Files left from another run would be taken for this run's, so the harness works in a directory of its own
+    // inside the work directory and clears only that one
+    options.workDirectory = (fs::path(options.workDirectory) / "YadroComputerClubStress").string();
+    fs::remove_all(options.workDirectory);
+
+    DifferentialHarness differentialHarness(options);
+    bool isMatching = differentialHarness.Run(std::cout);
+    differentialHarness.PrintReport(std::cout);
+
+    return isMatching ? 0 : 1;
+}
@@ -1,8 +1,43 @@
 #include "FileParser.h"
 #include "TaskSolver.h"
+#include "LineReader.h"
+#include "DecompressingBlockReader.h"
+#include "ClubScheduler.h"
+#include "EventHandler.h"
+#include "ReorderBuffer.h"
+#include "TextFormat.h"
+#include "RecordFormat.h"
+#include "ResultCache.h"
+#include "PhaseProfile.h"
+#include "LiveSnapshot.h"
+#include "LedgerSinks.h"
+#include "TimeIndex.h"
+#include "ReferenceEngine.h"
+#include "DifferentialHarness.h"
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+#include "ClubServer.h"
+#include "ClubClient.h"
+#include "SocketIO.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+#include "BatchRunner.h"
+#endif
+#ifdef COMPUTERCLUB_HAS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+#include <zstd.h>
+#endif
 #include <catch2/catch_all.hpp>
 #include <source_location>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -14,6 +49,7 @@ constexpr const char* TEST_PARSE_FILE_FOLDER = "test_parse_file";
 constexpr const char* TEST_SEMANTIC_ERRORS_FOLDER = "test_semantic_errors_in_input_file_data";
 constexpr const char* TEST_SUCCESS_OUTPUT_RESULT_FOLDER = "test_success_output_result";
 constexpr const char* TEST_PRINT_OUTPUT_RESULT_FOLDER = "test_print_output_result";
+constexpr const char* TEST_COMPRESSED_INPUT_FOLDER = "test_compressed_input";
 
 void CheckFileParsing(fs::path& testFolderPath, const std::string& filePath, ErrorType errorType) {
     InputFileData inputFileData;
@@ -94,6 +130,18 @@ TEST_CASE("ParsingTxtFile", "[YadroComputerClubTest]") {
         CheckFileParsing(testParseFileResourcePath, "IncorrectTableNumber.txt", ErrorType::IncorrectTableNumber);
     }
 
+    SECTION("TooLargeNumberOfTables") {
+        CheckFileParsing(testParseFileResourcePath, "TooLargeNumberOfTables.txt", ErrorType::IncorrectNumberOfTables);
+    }
+
+    SECTION("TooLargeCostPerHour") {
+        CheckFileParsing(testParseFileResourcePath, "TooLargeCostPerHour.txt", ErrorType::IncorrectCostPerHour);
+    }
+
+    SECTION("TooLargeTableNumber") {
+        CheckFileParsing(testParseFileResourcePath, "TooLargeTableNumber.txt", ErrorType::IncorrectTableNumber);
+    }
+
     // Example from the test task definition
     SECTION("CorrectParsingFile") {
         CheckFileParsing(testParseFileResourcePath, "CorrectParsingFile.txt", ErrorType::Success);
@@ -241,3 +289,1516 @@ TEST_CASE("PrintOutputResult", "[YadroComputerClubTest]") {
                                             "2 30 02:18\n"
                                             "3 90 08:01\n");
 }
+
+
+TEST_CASE("ReadingTxtFileInBlocks", "[YadroComputerClubTest]") {
+    // Long enough to split lines across several blocks, with no line break at the very end
+    auto filePath = fs::temp_directory_path().append("ReadingTxtFileInBlocks.txt");
+    std::vector<std::string> expectedLines;
+    {
+        std::ofstream file(filePath);
+        for (size_t i = 0; i < 100000; i++) {
+            expectedLines.push_back(std::string(i % 7, 'x').append(std::to_string(i)));
+            file << expectedLines.back() << (i + 1 < 100000 ? "\n" : "");
+        }
+    }
+
+    auto readLines = [&filePath](BlockReader::Backend backend, std::vector<std::string>& lines) {
+        auto blockReader = BlockReader::Open(filePath.string(), backend);
+        if (!blockReader)
+            return false;
+
+        LineReader lineReader(std::move(blockReader));
+        std::string line;
+        while (lineReader.GetLine(line))
+            lines.push_back(line);
+
+        return true;
+    };
+
+    SECTION("Thread") {
+        std::vector<std::string> lines;
+        REQUIRE(readLines(BlockReader::Backend::Thread, lines));
+        REQUIRE(lines == expectedLines);
+    }
+
+    // io_uring may be forbidden in containers, in which case there is nothing to compare
+    SECTION("IoUring") {
+        std::vector<std::string> lines;
+        if (readLines(BlockReader::Backend::IoUring, lines))
+            REQUIRE(lines == expectedLines);
+    }
+
+    SECTION("NonExistentFile") {
+        REQUIRE(BlockReader::Open(filePath.string() + ".missing") == nullptr);
+    }
+
+    SECTION("Directory") {
+        auto directoryPath = fs::temp_directory_path().append("ReadingTxtFileInBlocksDirectory.txt");
+        fs::create_directories(directoryPath);
+        REQUIRE(BlockReader::Open(directoryPath.string(), BlockReader::Backend::Thread) == nullptr);
+        REQUIRE(BlockReader::Open(directoryPath.string(), BlockReader::Backend::IoUring) == nullptr);
+        fs::remove(directoryPath);
+    }
+
+    fs::remove(filePath);
+}
+
+TEST_CASE("SchedulingSeveralClubs", "[YadroComputerClubTest]") {
+    auto resourcePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER);
+    const std::vector<fs::path> filePaths = {
+        fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt"),
+        fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("PerfectWorkingDay.txt"),
+        fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("FromTestTask.txt"),
+        fs::path(resourcePath).append(TEST_SEMANTIC_ERRORS_FOLDER).append("IncorrectEventTimeSequence.txt"),
+    };
+
+    auto schedule = [&filePaths](size_t numberOfThreads) {
+        ClubScheduler clubScheduler(numberOfThreads);
+
+        // Every day is added several times, so that the clubs of one thread share the timeline
+        for (size_t copy = 0; copy < 3; copy++) {
+            for (const auto& filePath : filePaths) {
+                InputFileData inputFileData;
+                Error error;
+                FileParser::Parse(filePath.string(), inputFileData, error);
+                REQUIRE(error.errorType == ErrorType::Success);
+
+                clubScheduler.AddClub(std::move(inputFileData));
+            }
+        }
+
+        clubScheduler.Run();
+
+        for (size_t club = 0; club < clubScheduler.numberOfClubs(); club++) {
+            const auto& result = clubScheduler.result(club);
+            const auto& filePath = filePaths[club % filePaths.size()];
+
+            TaskSolver taskSolver;
+            const auto taskSolverResult = taskSolver.run(filePath.string());
+
+            REQUIRE(static_cast<int>(result.error.errorType) == taskSolverResult);
+            if (result.error.errorType == ErrorType::Success)
+                REQUIRE(result.output == taskSolver.getOutputResult());
+        }
+    };
+
+    SECTION("OneThread") {
+        schedule(1);
+    }
+
+    SECTION("SeveralThreads") {
+        schedule(3);
+    }
+}
+
+TEST_CASE("HandlingSegmentsInParallel", "[YadroComputerClubTest]") {
+    // Visits of a few regulars with all kinds of mistakes; the club empties out every few events
+    auto filePath = fs::temp_directory_path().append("HandlingSegmentsInParallel.txt");
+    {
+        std::ofstream file(filePath);
+        file << "2\n09:00 23:00\n10\n";
+
+        for (uint16_t hours = 8; hours < 23; hours++) {
+            for (uint16_t minutes = 0; minutes < 60; minutes += 10) {
+                std::string time = Time{ hours, minutes }.toString();
+                file << time << " 1 alice\n" << time << " 1 bob\n" << time << " 2 alice 1\n"
+                     << time << " 3 bob\n" << time << " 1 carol\n" << time << " 2 carol 2\n"
+                     << time << " 3 bob\n" << time << " 4 alice\n" << time << " 4 dave\n";
+                if (minutes != 50)
+                    file << time << " 4 bob\n" << time << " 4 carol\n";
+            }
+        }
+    }
+
+    TaskSolver serialTaskSolver;
+    REQUIRE(serialTaskSolver.run(filePath.string()) == static_cast<int>(ErrorType::Success));
+
+    // More threads than there are empty moments in the day, and more than are ever started
+    for (size_t numberOfThreads : { size_t{2}, size_t{3}, size_t{8}, RunOptions::MAX_NUMBER_OF_THREADS + 1 }) {
+        TaskSolver parallelTaskSolver(nullptr, { .numberOfThreads = numberOfThreads });
+        REQUIRE(parallelTaskSolver.run(filePath.string()) == static_cast<int>(ErrorType::Success));
+        REQUIRE(parallelTaskSolver.getOutputResult() == serialTaskSolver.getOutputResult());
+
+        for (size_t table = 1; table <= 2; table++) {
+            REQUIRE(parallelTaskSolver.getTableIncome(table) == serialTaskSolver.getTableIncome(table));
+            REQUIRE(parallelTaskSolver.getEntireWorkingTimeOfTable(table).hours ==
+                    serialTaskSolver.getEntireWorkingTimeOfTable(table).hours);
+            REQUIRE(parallelTaskSolver.getEntireWorkingTimeOfTable(table).minutes ==
+                    serialTaskSolver.getEntireWorkingTimeOfTable(table).minutes);
+        }
+    }
+
+    fs::remove(filePath);
+}
+
+TEST_CASE("StoringTablesSparsely", "[YadroComputerClubTest]") {
+    // Only the pages of the two seated tables are allocated out of a hundred million declared ones
+    InputFileData inputFileData;
+    Error error;
+    FileParser::ParseContent("100000000\n09:00 19:00\n10\n"
+                             "09:10 1 alice\n09:20 2 alice 99999999\n10:00 1 bob\n10:05 2 bob 1025\n"
+                             "10:30 3 carol\n11:00 4 alice\n", inputFileData, error);
+    REQUIRE(error.errorType == ErrorType::Success);
+
+    std::string output;
+    Tables tables;
+    EventHandler eventHandler(std::move(inputFileData));
+    eventHandler.HandleEventsOfTheDay(output, error, tables);
+
+    REQUIRE(tables.size() == 100000000);
+    REQUIRE(tables.usedPages().size() == 2);
+    REQUIRE(tables.income(99999998) == 20);
+    REQUIRE(tables.entireWorkingTime(99999998) == 100);
+    REQUIRE(tables.income(1024) == 90);
+    REQUIRE(tables.entireWorkingTime(1024) == 535);
+    REQUIRE(tables.income(0) == 0);
+    REQUIRE_FALSE(tables.isBusy(1024));
+
+    std::string report;
+    appendTablesReport(report, tables, 1022, 1026);
+    REQUIRE(report == "1023 0 00:00\n"
+                      "1024 0 00:00\n"
+                      "1025 90 08:55\n"
+                      "1026 0 00:00\n");
+
+    report.clear();
+    appendTablesReport(report, tables, 99999997, 100000000);
+    REQUIRE(report == "99999998 0 00:00\n"
+                      "99999999 20 01:40\n"
+                      "100000000 0 00:00\n");
+}
+
+TEST_CASE("CachingResults", "[YadroComputerClubTest]") {
+    auto filePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                    .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt").string();
+    auto cachePath = fs::temp_directory_path().append("CachingResults");
+    fs::remove_all(cachePath);
+
+    SECTION("SameReportFromCache") {
+        std::ostringstream expected;
+        TaskSolver taskSolver;
+        int exitCode = taskSolver.run(filePath, expected);
+
+        ResultCache resultCache(cachePath, 1 << 20);
+        TaskSolver cachedTaskSolver(nullptr, {}, &resultCache);
+
+        for (size_t run = 0; run < 2; run++) {
+            std::ostringstream report;
+            REQUIRE(cachedTaskSolver.run(filePath, report) == exitCode);
+            REQUIRE(report.str() == expected.str());
+        }
+
+        std::ostringstream report;
+        REQUIRE(cachedTaskSolver.runContent("1\n09:00 19:00\n10\n08:00 1 alice\n", report) ==
+                static_cast<int>(ErrorType::Success));
+
+        auto stats = resultCache.stats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 2);
+        REQUIRE(stats.stores == 2);
+        REQUIRE(resultCache.statsLine() == "Result cache: 1 hits, 2 misses, hit rate 33.3%, 2 stored, 0 evicted");
+    }
+
+    SECTION("LeastRecentlyUsedEviction") {
+        ResultCache resultCache(cachePath, 3000);
+        std::string report(900, 'x');
+        auto first = ResultCache::MakeKey("first"), second = ResultCache::MakeKey("second"),
+             third = ResultCache::MakeKey("third"), fourth = ResultCache::MakeKey("fourth");
+
+        int exitCode;
+        std::string cachedReport;
+        for (const auto& key : { first, second, third }) {
+            resultCache.Store(key, 0, report);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        // The first entry becomes the most recently used one, so the second is evicted instead
+        REQUIRE(resultCache.Find(first, exitCode, cachedReport));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        resultCache.Store(fourth, 0, report);
+
+        REQUIRE(resultCache.stats().evictions == 2);
+        REQUIRE(resultCache.Find(first, exitCode, cachedReport));
+        REQUIRE(cachedReport == report);
+        REQUIRE_FALSE(resultCache.Find(second, exitCode, cachedReport));
+        REQUIRE_FALSE(resultCache.Find(third, exitCode, cachedReport));
+        REQUIRE(resultCache.Find(fourth, exitCode, cachedReport));
+    }
+
+    SECTION("DamagedEntries") {
+        ResultCache resultCache(cachePath, 1 << 20);
+        auto key = ResultCache::MakeKey("damaged");
+        int exitCode;
+        std::string cachedReport;
+
+        // A damaged entry is a miss and is removed, so that it isn't read again
+        for (const char* entry : { "YCCRESULT", "YCCRESULTX 1 7 0 3\nabc", "YCCRESULT 1 7 0 99999999999\nabc" }) {
+            resultCache.Store(key, 0, "report");
+            auto entryPath = fs::directory_iterator(cachePath)->path();
+            std::ofstream(entryPath, std::ios::binary | std::ios::trunc) << entry;
+
+            REQUIRE_FALSE(resultCache.Find(key, exitCode, cachedReport));
+            REQUIRE_FALSE(fs::exists(entryPath));
+        }
+
+        resultCache.Store(key, 0, "report");
+        REQUIRE(resultCache.Find(key, exitCode, cachedReport));
+        REQUIRE(cachedReport == "report");
+    }
+
+    fs::remove_all(cachePath);
+}
+
+TEST_CASE("ProfilingPhases", "[YadroComputerClubTest]") {
+    auto filePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                    .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("FromTestTask.txt").string();
+
+    std::ostringstream expected;
+    TaskSolver taskSolver;
+    taskSolver.run(filePath, expected);
+
+    // Counting changes nothing in the report, whether the counters are available or not
+    PhaseProfile phaseProfile;
+    TaskSolver profiledTaskSolver(nullptr, {}, nullptr, &phaseProfile);
+
+    for (size_t run = 0; run < 2; run++) {
+        std::ostringstream report;
+        REQUIRE(profiledTaskSolver.run(filePath, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(report.str() == expected.str());
+    }
+
+    std::string json = phaseProfile.ToJson();
+    REQUIRE(json.starts_with("{\"countersAvailable\": "));
+    REQUIRE(json.find("\"events\": 28,") != std::string::npos);
+
+    for (auto phase : PhaseProfile::PHASE_NAMES)
+        REQUIRE(json.find("{\"name\": \"" + std::string(phase) + "\", \"wallNs\": ") != std::string::npos);
+    for (auto counter : PerfCounters::COUNTER_NAMES)
+        REQUIRE(json.find("\"" + std::string(counter) + "\": ") != std::string::npos);
+}
+
+TEST_CASE("QueryingStateAsOfTime", "[YadroComputerClubTest]") {
+    auto sourcePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                      .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt");
+    auto indexPath = fs::temp_directory_path().append("QueryingStateAsOfTime");
+    fs::remove_all(indexPath);
+    fs::create_directories(indexPath);
+
+    auto filePath = fs::path(indexPath).append("AllMistakesAndEventIDs.txt").string();
+    fs::copy_file(sourcePath, filePath);
+    TaskSolver taskSolver;
+
+    SECTION("StateInTheMiddleOfTheDay") {
+        std::ostringstream report;
+        REQUIRE(taskSolver.buildTimeIndex(filePath, 4, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(taskSolver.runAsOf(filePath, { 12, 0 }, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(report.str() == "As of 12:00\n"
+                                "Seated 4\n-client1- 4\n-elena5- 3\n_serg23_ 1\nclient2 2\n"
+                                "Waiting 4\n_kent13\nclient3\n-client4-\n_den09\n"
+                                "Inside 1\n_john1234\n"
+                                "Revenue 100\n"
+                                "1 30 02:14\n2 20 01:35\n3 30 02:01\n4 20 01:59\n");
+    }
+
+    SECTION("SameStateWithAnyCheckpointInterval") {
+        // One checkpoint at the opening means replaying the whole day up to the requested time
+        std::vector<std::string> expected;
+        REQUIRE(taskSolver.buildTimeIndex(filePath, 1000) == static_cast<int>(ErrorType::Success));
+        for (uint16_t minutes = 0; minutes < 24 * 60; minutes += 7) {
+            std::ostringstream report;
+            REQUIRE(taskSolver.runAsOf(filePath, Time::fromMinutes(minutes), report) ==
+                    static_cast<int>(ErrorType::Success));
+            expected.push_back(report.str());
+        }
+
+        for (size_t checkpointInterval : { 1, 2, 3, 16 }) {
+            REQUIRE(taskSolver.buildTimeIndex(filePath, checkpointInterval) == static_cast<int>(ErrorType::Success));
+            for (uint16_t minutes = 0; minutes < 24 * 60; minutes += 7) {
+                std::ostringstream report;
+                REQUIRE(taskSolver.runAsOf(filePath, Time::fromMinutes(minutes), report) ==
+                        static_cast<int>(ErrorType::Success));
+                REQUIRE(report.str() == expected[minutes / 7]);
+            }
+        }
+    }
+
+    SECTION("EndOfTheDay") {
+        std::ostringstream fullReport;
+        REQUIRE(taskSolver.run(filePath, fullReport) == static_cast<int>(ErrorType::Success));
+        // The tables of the full report, without the empty line that ends it
+        std::string tablesReport = fullReport.str().substr(fullReport.str().find("\n1 "));
+        tablesReport.pop_back();
+
+        std::ostringstream report;
+        REQUIRE(taskSolver.buildTimeIndex(filePath, 5) == static_cast<int>(ErrorType::Success));
+        REQUIRE(taskSolver.runAsOf(filePath, { 23, 59 }, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(report.str() == "As of 21:00\nSeated 0\nWaiting 0\nInside 0\nRevenue 440" + tablesReport);
+    }
+
+    SECTION("OutOfDateIndex") {
+        std::ostringstream report;
+        REQUIRE(taskSolver.runAsOf(filePath, { 12, 0 }, report) == static_cast<int>(ErrorType::IncorrectTimeIndex));
+
+        REQUIRE(taskSolver.buildTimeIndex(filePath, 4) == static_cast<int>(ErrorType::Success));
+        std::ofstream(filePath, std::ios::app) << "\n19:30 4 client5";
+
+        report.str({});
+        REQUIRE(taskSolver.runAsOf(filePath, { 12, 0 }, report) == static_cast<int>(ErrorType::IncorrectTimeIndex));
+        REQUIRE(report.str() == filePath + "\nThe time index is missing, damaged or out of date!\n");
+    }
+
+    SECTION("DamagedIndex") {
+        REQUIRE(taskSolver.buildTimeIndex(filePath, 4) == static_cast<int>(ErrorType::Success));
+        auto indexFileName = TimeIndex::IndexFileName(filePath);
+        std::ifstream indexFile(indexFileName, std::ios::binary);
+        const std::string index((std::istreambuf_iterator<char>(indexFile)), std::istreambuf_iterator<char>());
+        indexFile.close();
+
+        // Offsets in the layout of TimeIndex.cpp: the header, the checkpoints, then the state of each checkpoint
+        constexpr size_t NUMBER_OF_TABLES = 40, NUMBER_OF_CHECKPOINTS = 64, HEADER_SIZE = 72;
+        constexpr size_t CHECKPOINT_SIZE = 40, STATE_OFFSET = 16, STATE_SIZE = 24;
+        constexpr uint64_t HUGE_VALUE = uint64_t{1} << 60;
+
+        auto readAt = [&index](size_t offset) {
+            uint64_t value;
+            std::memcpy(&value, index.data() + offset, sizeof(value));
+            return value;
+        };
+        auto writeAt = [](std::string& data, size_t offset, uint64_t value) {
+            std::memcpy(data.data() + offset, &value, sizeof(value));
+        };
+        auto queryDamaged = [&](const std::function<void(std::string&, size_t stateOffset)>& damage) {
+            std::string damaged = index;
+            for (size_t checkpoint = 0; checkpoint < readAt(NUMBER_OF_CHECKPOINTS); checkpoint++)
+                damage(damaged, HEADER_SIZE + checkpoint * CHECKPOINT_SIZE);
+            std::ofstream(indexFileName, std::ios::binary | std::ios::trunc) << damaged;
+
+            std::ostringstream report;
+            return taskSolver.runAsOf(filePath, { 12, 0 }, report);
+        };
+
+        constexpr int INCORRECT_TIME_INDEX = static_cast<int>(ErrorType::IncorrectTimeIndex);
+        REQUIRE(queryDamaged([](std::string&, size_t) { }) == static_cast<int>(ErrorType::Success));
+        REQUIRE(queryDamaged([&](std::string& data, size_t) {
+            writeAt(data, NUMBER_OF_CHECKPOINTS, HUGE_VALUE);
+        }) == INCORRECT_TIME_INDEX);
+        REQUIRE(queryDamaged([&](std::string& data, size_t checkpoint) {
+            writeAt(data, checkpoint + STATE_SIZE, HUGE_VALUE);
+        }) == INCORRECT_TIME_INDEX);
+        REQUIRE(queryDamaged([&](std::string& data, size_t checkpoint) {
+            writeAt(data, readAt(checkpoint + STATE_OFFSET), HUGE_VALUE);
+        }) == INCORRECT_TIME_INDEX);
+
+        // The table of the first client of every checkpoint is past the last table
+        REQUIRE(queryDamaged([&](std::string& data, size_t checkpoint) {
+            size_t state = readAt(checkpoint + STATE_OFFSET);
+            if (readAt(state) == 0)
+                return;
+
+            uint32_t nameSize;
+            std::memcpy(&nameSize, data.data() + state + sizeof(uint64_t), sizeof(nameSize));
+            writeAt(data, state + sizeof(uint64_t) + sizeof(nameSize) + nameSize + sizeof(uint8_t),
+                    readAt(NUMBER_OF_TABLES) + 1);
+        }) == INCORRECT_TIME_INDEX);
+    }
+
+    fs::remove_all(indexPath);
+}
+
+TEST_CASE("PublishingLiveSnapshots", "[YadroComputerClubTest]") {
+    auto filePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                    .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt").string();
+    InputFileData inputFileData;
+    Error error;
+    FileParser::Parse(filePath, inputFileData, error);
+    REQUIRE(error.errorType == ErrorType::Success);
+
+    LiveSnapshot liveSnapshot(inputFileData.computerClubFeatures.numberOfTables);
+    LiveSnapshot::Snapshot snapshot;
+    std::string output;
+    Tables tables;
+
+    SECTION("SnapshotAfterEveryEvent") {
+        EventHandler eventHandler(inputFileData);
+        eventHandler.PublishTo(&liveSnapshot);
+        REQUIRE(eventHandler.Start(output, error, tables));
+
+        for (size_t eventNumber = 0; eventNumber < eventHandler.numberOfEvents(); eventNumber++) {
+            eventHandler.HandleEvent(eventNumber, output, tables);
+            REQUIRE(liveSnapshot.Read(snapshot) == 0);
+
+            auto state = eventHandler.SaveState();
+            REQUIRE(snapshot.numberOfEvents == eventNumber + 1);
+            REQUIRE(snapshot.time.toMinutes() == eventHandler.eventTime(eventNumber).toMinutes());
+            REQUIRE(snapshot.numberOfClients == state.clientStatuses.size());
+            REQUIRE(snapshot.numberOfWaitingClients == state.waitingClients.size());
+
+            size_t numberOfBusyTables = 0, revenue = 0;
+            for (size_t table = 0; table < tables.size(); table++) {
+                REQUIRE(snapshot.tables[table].isBusy == tables.isBusy(table));
+                REQUIRE(snapshot.tables[table].entireWorkingTime == tables.entireWorkingTime(table));
+                REQUIRE(snapshot.tables[table].income == tables.income(table));
+                numberOfBusyTables += tables.isBusy(table);
+                revenue += tables.income(table);
+            }
+            REQUIRE(snapshot.numberOfBusyTables == numberOfBusyTables);
+            REQUIRE(snapshot.revenue == revenue);
+        }
+
+        eventHandler.Finish(output, tables);
+        liveSnapshot.Read(snapshot);
+        REQUIRE(snapshot.time.toString() == "21:00");
+        REQUIRE(snapshot.numberOfClients == 0);
+        REQUIRE(snapshot.numberOfBusyTables == 0);
+        REQUIRE(snapshot.revenue == 440);
+        REQUIRE(snapshot.runningIncome(0) == 120);
+    }
+
+    SECTION("ConsistentCopiesWhileHandling") {
+        // Torn copies would break the totals the writer keeps alongside the tables
+        std::atomic<bool> isDone = false;
+        std::atomic<size_t> numberOfReads = 0;
+        size_t numberOfInconsistentReads = 0;
+
+        std::thread reader([&]() {
+            LiveSnapshot::Snapshot readerSnapshot;
+            while (!isDone.load()) {
+                liveSnapshot.Read(readerSnapshot);
+                numberOfReads++;
+
+                size_t numberOfBusyTables = 0, revenue = 0;
+                for (const auto& tableState : readerSnapshot.tables) {
+                    numberOfBusyTables += tableState.isBusy;
+                    revenue += tableState.income;
+                }
+                numberOfInconsistentReads += numberOfBusyTables != readerSnapshot.numberOfBusyTables ||
+                                             revenue != readerSnapshot.revenue;
+            }
+        });
+
+        // Until the reader has had its share of the time, however the threads are scheduled
+        for (size_t day = 0; day < 2000 || numberOfReads < 1000; day++) {
+            EventHandler eventHandler(inputFileData);
+            eventHandler.PublishTo(&liveSnapshot);
+            output.clear();
+            eventHandler.HandleEventsOfTheDay(output, error, tables);
+        }
+
+        isDone = true;
+        reader.join();
+        REQUIRE(numberOfReads >= 1000);
+        REQUIRE(numberOfInconsistentReads == 0);
+    }
+
+    SECTION("AnotherNumberOfTables") {
+        EventHandler eventHandler(inputFileData);
+        LiveSnapshot otherLiveSnapshot(inputFileData.computerClubFeatures.numberOfTables + 1);
+        REQUIRE_THROWS_AS(eventHandler.PublishTo(&otherLiveSnapshot), std::invalid_argument);
+    }
+
+    SECTION("TooManyTables") {
+        REQUIRE_NOTHROW(LiveSnapshot(LiveSnapshot::MAX_NUMBER_OF_TABLES));
+        REQUIRE_THROWS_AS(LiveSnapshot(LiveSnapshot::MAX_NUMBER_OF_TABLES + 1), std::invalid_argument);
+        REQUIRE_THROWS_AS(LiveSnapshot(size_t{1} << 32), std::invalid_argument);
+    }
+}
+
+TEST_CASE("MergingTerminalLogs", "[YadroComputerClubTest]") {
+    // The events of a day dealt out to three terminals in turn
+    auto filePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                    .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt").string();
+    std::ifstream file(filePath);
+    std::string header, line;
+    for (size_t lineNumber = 0; lineNumber < 3 && std::getline(file, line); lineNumber++)
+        header += line + "\n";
+
+    std::vector<std::string> terminalLogs(3, header);
+    std::vector<std::tuple<std::string, size_t, std::string>> events;
+    for (size_t eventNumber = 0; std::getline(file, line); eventNumber++) {
+        terminalLogs[eventNumber % 3] += line + "\n";
+        events.emplace_back(line.substr(0, 5), eventNumber % 3, line);
+    }
+
+    std::vector<std::string> fileNames;
+    for (size_t terminal = 0; terminal < terminalLogs.size(); terminal++) {
+        fileNames.push_back(fs::temp_directory_path().append("MergingTerminalLogs" + std::to_string(terminal) + ".txt")
+                            .string());
+        std::ofstream(fileNames.back()) << terminalLogs[terminal];
+    }
+
+    TaskSolver taskSolver;
+
+    SECTION("SameReportAsOneLogInMergeOrder") {
+        // Events at the same time are taken from the terminals in the order the logs are given
+        std::ranges::stable_sort(events, [](const auto& first, const auto& second) {
+            return std::tie(std::get<0>(first), std::get<1>(first)) < std::tie(std::get<0>(second), std::get<1>(second));
+        });
+
+        std::string mergedLog = header;
+        for (const auto& event : events)
+            mergedLog += std::get<2>(event) + "\n";
+
+        std::ostringstream expected, report;
+        REQUIRE(taskSolver.runContent(mergedLog, expected) == static_cast<int>(ErrorType::Success));
+        REQUIRE(taskSolver.runMerged(fileNames, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(report.str() == expected.str());
+    }
+
+    SECTION("DifferentHeaders") {
+        std::ofstream(fileNames[1]) << "4\n08:00 21:00\n20\n";
+
+        std::ostringstream report;
+        REQUIRE(taskSolver.runMerged(fileNames, report) == static_cast<int>(ErrorType::DifferentLogHeaders));
+        REQUIRE(report.str() == fileNames[1] + "\nThe number of tables, working hours or cost per hour differ from "
+                                               "the first log!\n");
+    }
+
+    SECTION("LogOutOfOrder") {
+        std::ofstream(fileNames[2], std::ios::app) << "09:00 1 client9\n";
+
+        std::ostringstream report;
+        REQUIRE(taskSolver.runMerged(fileNames, report) == static_cast<int>(ErrorType::IncorrectEventTimeSequence));
+        REQUIRE(report.str() == "09:00 1 client9\nThe time sequence of events is incorrect!\n");
+    }
+
+    for (const auto& fileName : fileNames)
+        fs::remove(fileName);
+}
+
+TEST_CASE("ReorderingEventsInWindow", "[YadroComputerClubTest]") {
+    // Two terminals whose clocks are a few minutes apart
+    const std::string header = "3\n09:00 19:00\n10\n";
+    const std::string skewedLog = header + "09:10 1 alice\n09:20 2 alice 1\n09:18 1 bob\n09:19 2 bob 2\n"
+                                           "09:30 4 alice\n09:26 1 carol\n09:27 3 carol\n";
+    const std::string sortedLog = header + "09:10 1 alice\n09:18 1 bob\n09:19 2 bob 2\n09:20 2 alice 1\n"
+                                           "09:26 1 carol\n09:27 3 carol\n09:30 4 alice\n";
+
+    std::ostringstream expected;
+    TaskSolver strictTaskSolver;
+    REQUIRE(strictTaskSolver.runContent(sortedLog, expected) == static_cast<int>(ErrorType::Success));
+
+    SECTION("StrictByDefault") {
+        std::ostringstream report;
+        REQUIRE(strictTaskSolver.runContent(skewedLog, report) ==
+                static_cast<int>(ErrorType::IncorrectEventTimeSequence));
+        REQUIRE(report.str() == "09:18 1 bob\nThe time sequence of events is incorrect!\n");
+    }
+
+    SECTION("SameReportAsSortedLog") {
+        for (uint16_t windowMinutes : { 4, 10, 60 }) {
+            RunOptions runOptions;
+            runOptions.reorderWindowMinutes = windowMinutes;
+            TaskSolver taskSolver(nullptr, runOptions);
+
+            std::ostringstream report;
+            REQUIRE(taskSolver.runContent(skewedLog, report) == static_cast<int>(ErrorType::Success));
+            REQUIRE(report.str() == expected.str());
+        }
+    }
+
+    SECTION("EventLaterThanWindow") {
+        RunOptions runOptions;
+        runOptions.reorderWindowMinutes = 3;
+        TaskSolver taskSolver(nullptr, runOptions);
+
+        std::ostringstream report;
+        REQUIRE(taskSolver.runContent(skewedLog, report) == static_cast<int>(ErrorType::IncorrectEventTimeSequence));
+        REQUIRE(report.str() == "09:26 1 carol\nThe time sequence of events is incorrect!\n");
+    }
+
+    SECTION("MergedTerminalLogs") {
+        std::vector<std::string> fileNames;
+        for (const auto& terminalLog : { header + "09:10 1 alice\n09:20 2 alice 1\n09:30 4 alice\n",
+                                         header + "09:18 1 bob\n09:19 2 bob 2\n09:27 3 carol\n09:26 1 carol\n" })
+        {
+            fileNames.push_back(fs::temp_directory_path().append("ReorderingEventsInWindow" +
+                                                                 std::to_string(fileNames.size()) + ".txt").string());
+            std::ofstream(fileNames.back()) << terminalLog;
+        }
+
+        RunOptions runOptions;
+        runOptions.reorderWindowMinutes = 2;
+        TaskSolver taskSolver(nullptr, runOptions);
+
+        std::ostringstream report;
+        REQUIRE(taskSolver.runMerged(fileNames, report) == static_cast<int>(ErrorType::Success));
+        REQUIRE(report.str() == expected.str());
+
+        // Without the window the second log is out of order
+        std::ostringstream strictReport;
+        REQUIRE(strictTaskSolver.runMerged(fileNames, strictReport) ==
+                static_cast<int>(ErrorType::IncorrectEventTimeSequence));
+
+        for (const auto& fileName : fileNames)
+            fs::remove(fileName);
+    }
+
+    SECTION("SameTimeInOrderOfArrival") {
+        ReorderBuffer reorderBuffer(5);
+        for (Time eventTime : { Time{ 10, 3 }, Time{ 10, 0 }, Time{ 10, 3 }, Time{ 9, 59 }, Time{ 10, 8 } })
+            REQUIRE(reorderBuffer.Push(eventTime));
+        REQUIRE_FALSE(reorderBuffer.Push({ 10, 2 }));
+
+        // Only the events more than 5 minutes older than 10:08 can't be overtaken any more
+        std::vector<uint64_t> order;
+        uint64_t eventNumber;
+        while (reorderBuffer.Pop(eventNumber))
+            order.push_back(eventNumber);
+        REQUIRE(order == std::vector<uint64_t>{ 3, 1 });
+
+        while (reorderBuffer.Pop(eventNumber, true))
+            order.push_back(eventNumber);
+        REQUIRE(order == std::vector<uint64_t>{ 3, 1, 0, 2, 4 });
+    }
+}
+
+std::vector<std::string> SplitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    for (std::string line; std::getline(stream, line); )
+        lines.push_back(line);
+
+    return lines;
+}
+
+TEST_CASE("WritingStructuredRecords", "[YadroComputerClubTest]") {
+    auto filePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                    .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt").string();
+
+    TaskSolver textTaskSolver;
+    std::ostringstream text;
+    REQUIRE(textTaskSolver.run(filePath, text) == static_cast<int>(ErrorType::Success));
+    auto textLines = SplitLines(text.str());
+    textLines.pop_back();
+
+    SECTION("TextUnchanged") {
+        TaskSolver taskSolver(nullptr, { .outputFormat = OutputFormat::Text });
+        std::ostringstream report;
+        taskSolver.run(filePath, report);
+        REQUIRE(report.str() == text.str());
+    }
+
+    SECTION("JsonLines") {
+        TaskSolver taskSolver(nullptr, { .outputFormat = OutputFormat::JsonLines });
+        std::ostringstream report;
+        REQUIRE(taskSolver.run(filePath, report) == static_cast<int>(ErrorType::Success));
+
+        // One record per line of the text report
+        auto lines = SplitLines(report.str());
+        REQUIRE(lines.size() == textLines.size());
+        REQUIRE(lines.front() == R"({"type":"opening","time":"08:00"})");
+        REQUIRE(lines[1] == R"({"type":"event","time":"07:45","id":1,"client":"_serg23_"})");
+        REQUIRE(lines[2] == R"({"type":"generated","time":"07:45","id":13,"error":"NotOpenYet"})");
+        REQUIRE(std::ranges::count(lines, R"({"type":"generated","time":"12:47","id":12,"client":"_kent13","table":4})")
+                == 1);
+        REQUIRE(std::ranges::count(lines, R"({"type":"generated","time":"21:00","id":11,"client":"client5"})") == 1);
+        REQUIRE(lines[lines.size() - 5] == R"({"type":"closing","time":"21:00"})");
+        REQUIRE(lines[lines.size() - 4] == R"({"type":"table","table":1,"income":120,"minutes":651})");
+        REQUIRE(lines.back() == R"({"type":"table","table":4,"income":120,"minutes":659})");
+    }
+
+    SECTION("Csv") {
+        TaskSolver taskSolver(nullptr, { .outputFormat = OutputFormat::Csv });
+        std::ostringstream report;
+        REQUIRE(taskSolver.run(filePath, report) == static_cast<int>(ErrorType::Success));
+
+        auto lines = SplitLines(report.str());
+        REQUIRE(lines.size() == textLines.size() + 1);
+        REQUIRE(lines.front() + '\n' == RecordFormat::CSV_HEADER);
+        for (const auto& line : lines)
+            REQUIRE(std::ranges::count(line, ',') == 7);
+
+        REQUIRE(lines[2] == "event,07:45,1,_serg23_,,,,");
+        REQUIRE(lines[3] == "generated,07:45,13,,,NotOpenYet,,");
+        REQUIRE(std::ranges::count(lines, "generated,12:47,12,_kent13,4,,,") == 1);
+        REQUIRE(lines.back() == "table,,,,4,,120,659");
+    }
+
+    SECTION("SameRecordsFromCache") {
+        auto cachePath = fs::temp_directory_path().append("WritingStructuredRecords");
+        fs::remove_all(cachePath);
+        ResultCache resultCache(cachePath, 1 << 20);
+
+        std::ostringstream expected;
+        TaskSolver taskSolver(nullptr, { .outputFormat = OutputFormat::JsonLines });
+        taskSolver.run(filePath, expected);
+
+        TaskSolver cachedTaskSolver(nullptr, { .outputFormat = OutputFormat::JsonLines }, &resultCache);
+        for (size_t run = 0; run < 2; run++) {
+            std::ostringstream report;
+            cachedTaskSolver.run(filePath, report);
+            REQUIRE(report.str() == expected.str());
+        }
+
+        // The text report is what is cached
+        std::ostringstream report;
+        TaskSolver cachedTextTaskSolver(nullptr, {}, &resultCache);
+        cachedTextTaskSolver.run(filePath, report);
+        REQUIRE(report.str() == text.str());
+        REQUIRE(resultCache.stats().hits == 2);
+
+        fs::remove_all(cachePath);
+    }
+
+    SECTION("ErrorsStayText") {
+        TaskSolver taskSolver(nullptr, { .outputFormat = OutputFormat::Csv });
+        std::ostringstream report;
+        REQUIRE(taskSolver.runContent("1\n09:00 19:00\n10\n08:00 1 Alice\n", report) ==
+                static_cast<int>(ErrorType::IncorrectClientName));
+        REQUIRE(report.str() == "08:00 1 Alice\nThe client name included in event body is incorrect!\n");
+    }
+
+    SECTION("NoAllocationsOnceReserved") {
+        std::string output;
+        output.reserve(1 << 16);
+        const char* buffer = output.data();
+
+        for (size_t pass = 0; pass < 2; pass++) {
+            output.clear();
+            bool isOpened = false;
+            RecordFormat::appendReportRecords(output, OutputFormat::JsonLines, text.str(), 0, output.capacity(),
+                                              isOpened);
+            REQUIRE(output.data() == buffer);
+        }
+    }
+}
+
+TEST_CASE("ReadingCompressedLogs", "[YadroComputerClubTest]") {
+    using Compression = DecompressingBlockReader::Compression;
+
+    auto folderPath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER);
+    auto plainPath = fs::path(folderPath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER)
+                     .append("AllMistakesAndEventIDs.txt").string();
+    auto compressedPath = [&folderPath](const std::string& fileName) {
+        return fs::path(folderPath).append(TEST_COMPRESSED_INPUT_FOLDER).append(fileName).string();
+    };
+
+    TaskSolver taskSolver;
+    auto runToString = [&taskSolver](const std::string& filePath, int& exitCode) {
+        std::ostringstream report;
+        exitCode = taskSolver.run(filePath, report);
+        return report.str();
+    };
+
+    int expectedExitCode, exitCode;
+    std::string expected = runToString(plainPath, expectedExitCode);
+
+    SECTION("SameReportAsPlainLog") {
+        for (auto [fileName, compression] : { std::pair{ "AllMistakesAndEventIDs.txt.gz", Compression::Gzip },
+                                              { "AllMistakesAndEventIDs.txt.zst", Compression::Zstd } })
+        {
+            if (!DecompressingBlockReader::IsSupported(compression))
+                continue;
+
+            REQUIRE(runToString(compressedPath(fileName), exitCode) == expected);
+            REQUIRE(exitCode == expectedExitCode);
+        }
+    }
+
+    SECTION("ManyBlocks") {
+        // Far more than two blocks of events, so that decompression has to wait for the parser and the other way round
+        std::string log = "2\n09:00 23:00\n10\n";
+        for (uint16_t minutes = 9 * MINUTES_IN_HOUR; minutes < 23 * MINUTES_IN_HOUR; minutes++) {
+            std::string time = Time::fromMinutes(minutes).toString();
+            for (size_t client = 0; client < 50; client++) {
+                std::string clientName = "client" + std::to_string(client);
+                log.append(time).append(" 1 ").append(clientName).append("\n");
+                if (client < 2)
+                    log.append(time).append(" 2 ").append(clientName).append(client == 0 ? " 1\n" : " 2\n");
+                log.append(time).append(" 4 ").append(clientName).append("\n");
+            }
+        }
+        REQUIRE(log.size() > 4 * BlockReader::BLOCK_SIZE);
+
+        auto filePath = fs::temp_directory_path().append("ReadingCompressedLogs.txt").string();
+        std::ofstream(filePath, std::ios::binary) << log;
+        std::string expectedLarge = runToString(filePath, expectedExitCode);
+        REQUIRE(expectedExitCode == static_cast<int>(ErrorType::Success));
+
+#ifdef COMPUTERCLUB_HAS_ZLIB
+        {
+            gzFile file = gzopen((filePath + ".gz").c_str(), "wb");
+            gzwrite(file, log.data(), static_cast<unsigned>(log.size()));
+            gzclose(file);
+        }
+        REQUIRE(runToString(filePath + ".gz", exitCode) == expectedLarge);
+        fs::remove(filePath + ".gz");
+#endif
+#ifdef COMPUTERCLUB_HAS_ZSTD
+        {
+            std::string compressed(ZSTD_compressBound(log.size()), '\0');
+            compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), log.data(), log.size(), 3));
+            std::ofstream(filePath + ".zst", std::ios::binary) << compressed;
+        }
+        REQUIRE(runToString(filePath + ".zst", exitCode) == expectedLarge);
+        fs::remove(filePath + ".zst");
+#endif
+        fs::remove(filePath);
+    }
+
+    SECTION("CorruptData") {
+        if (DecompressingBlockReader::IsSupported(Compression::Gzip))
+            REQUIRE_THROWS_AS(runToString(compressedPath("Truncated.txt.gz"), exitCode), std::runtime_error);
+    }
+
+    SECTION("NoTxtBeforeCompression") {
+        REQUIRE(runToString(compressedPath("AllMistakesAndEventIDs.gz"), exitCode) ==
+                compressedPath("AllMistakesAndEventIDs.gz") + "\nThe input file has an incorrect extension!\n");
+        REQUIRE(exitCode == static_cast<int>(ErrorType::IncorrectFileExtension));
+    }
+
+    SECTION("NoTimeIndex") {
+        std::ostringstream report;
+        REQUIRE(taskSolver.buildTimeIndex(compressedPath("AllMistakesAndEventIDs.txt.gz"), 4, report) ==
+                static_cast<int>(ErrorType::IncorrectFileExtension));
+    }
+}
+
+#ifdef COMPUTERCLUB_HAS_BATCH_RUNNER
+TEST_CASE("RunningShardedBatch", "[YadroComputerClubTest]") {
+    auto folderPath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER);
+    auto batchPath = fs::temp_directory_path().append("RunningShardedBatch");
+    fs::remove_all(batchPath);
+    fs::create_directories(batchPath);
+
+    auto logPath = [&folderPath](const char* folder, const char* fileName) {
+        return fs::path(folderPath).append(folder).append(fileName).string();
+    };
+
+    // Reports, an error and an exception, of three clubs
+    std::vector<std::pair<std::string, std::string>> logs = {
+        { "north", logPath(TEST_SUCCESS_OUTPUT_RESULT_FOLDER, "AllMistakesAndEventIDs.txt") },
+        { "south", logPath(TEST_SUCCESS_OUTPUT_RESULT_FOLDER, "FromTestTask.txt") },
+        { "north", logPath(TEST_SUCCESS_OUTPUT_RESULT_FOLDER, "PerfectWorkingDay.txt") },
+        { "south", logPath(TEST_PARSE_FILE_FOLDER, "IncorrectEventID.txt") },
+        { "west", logPath(TEST_COMPRESSED_INPUT_FOLDER, "Truncated.txt.gz") },
+    };
+
+    auto manifestPath = fs::path(batchPath).append("logs.manifest").string();
+    {
+        std::ofstream manifest(manifestPath);
+        manifest << "# club log\n\n";
+        for (const auto& [club, path] : logs)
+            manifest << club << ' ' << path << '\n';
+    }
+
+    // The report a single run gives for every log, and the revenue of each club
+    std::string expected;
+    std::map<std::string, size_t> expectedRevenue;
+    for (const auto& [club, path] : logs) {
+        TaskSolver taskSolver;
+        std::ostringstream report;
+        int exitCode;
+        try {
+            exitCode = taskSolver.run(path, report);
+        } catch (const std::exception& exception) {
+            report << "Caught an unexpected exception: " << exception.what() << std::endl;
+            exitCode = static_cast<int>(ErrorType::UnexpectedError);
+        }
+
+        expected.append(club).append(" ").append(path).append("\n").append(report.str());
+        expectedRevenue[club] += exitCode == static_cast<int>(ErrorType::Success) ? taskSolver.getRevenue() : 0;
+    }
+
+    size_t totalRevenue = 0;
+    expected.append("Revenue by club:\n");
+    for (const auto& [club, revenue] : expectedRevenue) {
+        expected.append(club).append(" ").append(std::to_string(revenue)).append("\n");
+        totalRevenue += revenue;
+    }
+    expected.append("Total ").append(std::to_string(totalRevenue)).append("\n");
+    REQUIRE(totalRevenue > 0);
+
+    BatchOptions batchOptions;
+    batchOptions.manifestPath = manifestPath;
+    batchOptions.workDirectory = fs::path(batchPath).append("work").string();
+    batchOptions.numberOfShards = 3;
+    batchOptions.numberOfWorkers = 2;
+    batchOptions.binaryPath = COMPUTERCLUB_BINARY_PATH;
+
+    auto runBatch = [&batchOptions](int& exitCode) {
+        std::ostringstream report;
+        exitCode = BatchRunner(batchOptions).Run(report);
+        return report.str();
+    };
+
+    int exitCode;
+
+    SECTION("ShardsOfAboutTheSameSize") {
+        std::vector<BatchRunner::Log> sizedLogs;
+        for (size_t size : { 10, 50, 20, 40, 30, 60 })
+            sizedLogs.push_back({ sizedLogs.size(), "club", "log" + std::to_string(sizedLogs.size()), size });
+
+        auto shards = BatchRunner::SplitIntoShards(sizedLogs, 3);
+        REQUIRE(shards.size() == 3);
+        for (const auto& shard : shards) {
+            uintmax_t shardSize = 0;
+            for (const auto& log : shard)
+                shardSize += log.size;
+            REQUIRE(shardSize == 70);
+            REQUIRE(std::ranges::is_sorted(shard, {}, &BatchRunner::Log::number));
+        }
+
+        REQUIRE(BatchRunner::SplitIntoShards(sizedLogs, 10).size() == sizedLogs.size());
+        REQUIRE(BatchRunner::SplitIntoShards({}, 3).size() == 1);
+    }
+
+    SECTION("MergedReport") {
+        REQUIRE(runBatch(exitCode) == expected);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+
+        for (size_t shard = 0; shard < 3; shard++)
+            REQUIRE(fs::exists(BatchRunner::ShardResultPath(batchOptions.workDirectory, shard)));
+    }
+
+    SECTION("RetryingFailedShards") {
+        // Every first attempt of a shard fails
+        batchOptions.workerCommand = "test {attempt} -ge 1 && "
+                                     "{binary} --batch-shard {manifest} --shard-result {result}";
+        REQUIRE(runBatch(exitCode) == expected);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+
+        batchOptions.workerCommand = "false";
+        batchOptions.numberOfRetries = 1;
+        fs::remove_all(batchOptions.workDirectory);
+
+        std::string report = runBatch(exitCode);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::FailedShard));
+        REQUIRE(report.find(BatchRunner::ShardResultPath(batchOptions.workDirectory, 0) +
+                            "\nThe shard has failed 2 times!\n") == 0);
+    }
+
+    SECTION("CompletedShardsAreNotRunAgain") {
+        REQUIRE(runBatch(exitCode) == expected);
+        fs::remove(BatchRunner::ShardResultPath(batchOptions.workDirectory, 1));
+
+        // The worker notes its shard before running it
+        auto launchedPath = fs::path(batchPath).append("launched").string();
+        batchOptions.workerCommand = "echo {shard} >> " + launchedPath +
+                                     " && {binary} --batch-shard {manifest} --shard-result {result}";
+        REQUIRE(runBatch(exitCode) == expected);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+
+        std::ifstream launched(launchedPath);
+        REQUIRE(std::string(std::istreambuf_iterator<char>(launched), {}) == "1\n");
+    }
+
+    SECTION("ChangedLogsAreRunAgain") {
+        // A log of its own whose cost per hour doubles between the runs, at the same size
+        auto changedPath = fs::path(batchPath).append("changed.txt").string();
+        std::string content;
+        {
+            std::ifstream original(logPath(TEST_SUCCESS_OUTPUT_RESULT_FOLDER, "FromTestTask.txt"));
+            content.assign(std::istreambuf_iterator<char>(original), {});
+        }
+        std::ofstream(changedPath, std::ios::binary) << content;
+        std::ofstream(manifestPath, std::ios::trunc) << "club1 " << changedPath << '\n';
+
+        auto expectedFor = [&changedPath](const char* revenue) {
+            TaskSolver taskSolver;
+            std::ostringstream report;
+            taskSolver.run(changedPath, report);
+            return "club1 " + changedPath + "\n" + report.str() + "Revenue by club:\nclub1 " + revenue +
+                   "\nTotal " + revenue + "\n";
+        };
+
+        REQUIRE(runBatch(exitCode) == expectedFor("190"));
+
+        content.replace(content.find("\n10\n"), 4, "\n20\n");
+        auto modificationTime = fs::last_write_time(changedPath);
+        std::ofstream(changedPath, std::ios::binary | std::ios::trunc) << content;
+        fs::last_write_time(changedPath, modificationTime + std::chrono::seconds(1));
+
+        REQUIRE(runBatch(exitCode) == expectedFor("380"));
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+    }
+
+    SECTION("DamagedResultsAreRunAgain") {
+        REQUIRE(runBatch(exitCode) == expected);
+
+        // The length of the first report is far more than the whole file
+        auto resultPath = BatchRunner::ShardResultPath(batchOptions.workDirectory, 0);
+        std::string result;
+        {
+            std::ifstream file(resultPath, std::ios::binary);
+            result.assign(std::istreambuf_iterator<char>(file), {});
+        }
+        size_t lengthPos = result.rfind(' ', result.find('\n')) + 1;
+        result.replace(lengthPos, result.find('\n') - lengthPos, "1000000000000000000");
+        fs::remove(resultPath);
+        std::ofstream(resultPath, std::ios::binary) << result;
+
+        REQUIRE(runBatch(exitCode) == expected);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+    }
+
+    SECTION("ReportOptionsReachTheWorkers") {
+        REQUIRE(runBatch(exitCode) == expected);
+
+        // Only the revenue of every log; the shards done for the full reports are run again
+        RunOptions runOptions{ .reportSections = { false, false, false, true } };
+        batchOptions.runOptions = runOptions;
+
+        std::string totalsOnly;
+        for (const auto& [club, path] : logs) {
+            TaskSolver taskSolver(nullptr, runOptions);
+            std::ostringstream report;
+            try {
+                taskSolver.run(path, report);
+            } catch (const std::exception& exception) {
+                report << "Caught an unexpected exception: " << exception.what() << std::endl;
+            }
+
+            totalsOnly.append(club).append(" ").append(path).append("\n").append(report.str());
+        }
+        totalsOnly.append(expected.substr(expected.find("Revenue by club:\n")));
+
+        REQUIRE(runBatch(exitCode) == totalsOnly);
+        REQUIRE(exitCode == static_cast<int>(ErrorType::Success));
+
+        batchOptions.workerCommand = "{binary} --batch-shard {manifest} --shard-result {result} {options}";
+        fs::remove_all(batchOptions.workDirectory);
+        REQUIRE(runBatch(exitCode) == totalsOnly);
+    }
+
+    SECTION("IncorrectManifest") {
+        std::ofstream(manifestPath, std::ios::app) << "north\n";
+        REQUIRE(runBatch(exitCode) == manifestPath + "\nThe manifest can't be read or has an incorrect line!\n");
+        REQUIRE(exitCode == static_cast<int>(ErrorType::IncorrectManifest));
+    }
+
+    fs::remove_all(batchPath);
+}
+#endif
+
+TEST_CASE("ProjectingReportSections", "[YadroComputerClubTest]") {
+    auto folderPath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                      .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER);
+    auto cachePath = fs::temp_directory_path().append("ProjectingReportSections");
+    fs::remove_all(cachePath);
+
+    // The lines of the report of the task by section; generated events have IDs of two digits
+    struct Lines {
+        std::string opening, closing;
+        std::vector<std::pair<bool, std::string>> eventLog;
+        std::string tables;
+        std::string revenue;
+    };
+
+    auto splitReport = [](const std::string& report, size_t revenue) {
+        Lines lines;
+        std::istringstream stream(report);
+        std::getline(stream, lines.opening);
+
+        for (std::string line; std::getline(stream, line) && !line.empty(); ) {
+            if (line.size() == 5)
+                lines.closing = line;
+            else if (line[2] != TIME_DELIMITER)
+                lines.tables.append(line).push_back('\n');
+            else
+                lines.eventLog.emplace_back(line[7] != WORD_DELIMITER, line);
+        }
+
+        lines.revenue = "Revenue " + std::to_string(revenue) + "\n";
+        return lines;
+    };
+
+    auto projectReport = [](const Lines& lines, const ReportSections& sections) {
+        std::string report;
+        if (sections.hasEventLog()) {
+            report.append(lines.opening).push_back('\n');
+            for (const auto& [isGenerated, line] : lines.eventLog) {
+                if (isGenerated ? sections.events : sections.echo)
+                    report.append(line).push_back('\n');
+            }
+            report.append(lines.closing).push_back('\n');
+        }
+
+        if (sections.tables)
+            report.append(lines.tables);
+        if (sections.totals)
+            report.append(lines.revenue);
+
+        return report.append("\n");
+    };
+
+    // The club empties out every few events there, so that the day is handled in segments on several threads
+    auto segmentedPath = fs::temp_directory_path().append("ProjectingReportSections.txt").string();
+    {
+        std::ofstream file(segmentedPath);
+        file << "2\n09:00 23:00\n10\n";
+        for (uint16_t minutes = 9 * MINUTES_IN_HOUR; minutes < 23 * MINUTES_IN_HOUR; minutes += 10) {
+            std::string time = Time::fromMinutes(minutes).toString();
+            file << time << " 1 alice\n" << time << " 2 alice 1\n" << time << " 1 bob\n" << time << " 3 bob\n"
+                 << time << " 4 alice\n" << time << " 4 bob\n";
+        }
+    }
+
+    std::vector<std::string> filePaths = { segmentedPath };
+    for (const char* fileName : { "AllMistakesAndEventIDs.txt", "FromTestTask.txt", "PerfectWorkingDay.txt" })
+        filePaths.push_back(fs::path(folderPath).append(fileName).string());
+
+    for (const auto& filePath : filePaths) {
+        TaskSolver taskSolver;
+        std::ostringstream fullReport;
+        REQUIRE(taskSolver.run(filePath, fullReport) == static_cast<int>(ErrorType::Success));
+        Lines lines = splitReport(fullReport.str(), taskSolver.getRevenue());
+        REQUIRE(projectReport(lines, {}) == fullReport.str());
+
+        ResultCache resultCache(cachePath, 1 << 20);
+
+        for (uint8_t bits = 0; bits < 16; bits++) {
+            ReportSections sections{ (bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0, (bits & 8) != 0 };
+            std::string expected = projectReport(lines, sections);
+
+            for (size_t numberOfThreads : { 1, 4 }) {
+                RunOptions runOptions{ .numberOfThreads = numberOfThreads };
+                runOptions.reportSections = sections;
+
+                TaskSolver projectedTaskSolver(nullptr, runOptions);
+                std::ostringstream report;
+                REQUIRE(projectedTaskSolver.run(filePath, report) == static_cast<int>(ErrorType::Success));
+                REQUIRE(report.str() == expected);
+                REQUIRE(projectedTaskSolver.getRevenue() == taskSolver.getRevenue());
+
+                // Without the event log nothing is kept of the events; the tables are there either way
+                if (!sections.hasEventLog())
+                    REQUIRE(projectedTaskSolver.getOutputResult() == lines.tables);
+            }
+
+            RunOptions runOptions;
+            runOptions.reportSections = sections;
+            TaskSolver cachedTaskSolver(nullptr, runOptions, &resultCache);
+            for (size_t run = 0; run < 2; run++) {
+                std::ostringstream report;
+                REQUIRE(cachedTaskSolver.run(filePath, report) == static_cast<int>(ErrorType::Success));
+                REQUIRE(report.str() == expected);
+            }
+
+            // Records come out the same whether the tables and the totals are read from the cached report or not
+            runOptions.outputFormat = OutputFormat::JsonLines;
+            std::ostringstream records, cachedRecords;
+            TaskSolver(nullptr, runOptions).run(filePath, records);
+            TaskSolver(nullptr, runOptions, &resultCache).run(filePath, cachedRecords);
+            REQUIRE(cachedRecords.str() == records.str());
+
+            std::string totalRecord = "{\"type\":\"total\",\"income\":" + std::to_string(taskSolver.getRevenue()) +
+                                      "}\n";
+            REQUIRE(records.str().ends_with(totalRecord) == sections.totals);
+        }
+
+        // An entry per set of sections
+        REQUIRE(resultCache.stats().stores == 16);
+        fs::remove_all(cachePath);
+    }
+
+    fs::remove(segmentedPath);
+}
+
+TEST_CASE("RecordingClientSessions", "[YadroComputerClubTest]") {
+    // Every way of leaving, a move to another table, the queue and clients who have no visit
+    const std::string log = "2\n09:00 19:00\n10\n"
+                            "08:48 1 early\n09:00 1 alice\n09:05 2 alice 1\n09:08 2 alice 2\n09:10 1 bob\n"
+                            "09:15 2 bob 1\n09:20 1 carol\n09:25 3 carol\n09:30 1 dave\n09:35 3 dave\n"
+                            "09:40 1 erin\n09:45 3 erin\n11:08 4 alice\n12:00 4 dave\n13:00 4 frank\n";
+
+    // Keeps the visits in memory, with the size of every batch
+    struct CollectingLedgerSink : LedgerSink {
+        std::vector<std::pair<std::string, SessionLedger::Visit>> visits;
+        std::vector<size_t> batchSizes;
+
+        void Write(const SessionLedger::Batch& batch) override {
+            for (const auto& visit : batch.visits)
+                visits.emplace_back(batch.name(visit), visit);
+            batchSizes.push_back(batch.visits.size());
+        }
+    };
+
+    SECTION("VisitsOfTheDay") {
+        std::ostringstream csv;
+        CsvLedgerSink ledgerSink(csv);
+        SessionLedger sessionLedger(ledgerSink);
+
+        std::ostringstream expected, report;
+        TaskSolver().runContent(log, expected);
+        TaskSolver taskSolver(nullptr, {}, nullptr, nullptr, &sessionLedger);
+        REQUIRE(taskSolver.runContent(log, report) == static_cast<int>(ErrorType::Success));
+
+        REQUIRE(report.str() == expected.str());
+        REQUIRE(csv.str() == std::string(CsvLedgerSink::CSV_HEADER) +
+                             "erin,09:40,,,09:45,queue_overflow,0,,0,0\n"
+                             "alice,09:00,,,11:08,voluntary,2,1@09:05-09:08 2@09:08-11:08,3,30\n"
+                             "dave,09:30,09:35,12:00,12:00,voluntary,0,,0,0\n"
+                             "bob,09:10,,,19:00,closing,1,1@09:15-19:00,10,100\n"
+                             "carol,09:20,09:25,11:08,19:00,closing,1,2@11:08-19:00,8,80\n");
+        REQUIRE(sessionLedger.numberOfVisits() == 5);
+        REQUIRE(sessionLedger.numberOfOpenVisits() == 0);
+    }
+
+    SECTION("BilledAsTheTables") {
+        CollectingLedgerSink ledgerSink;
+        SessionLedger sessionLedger(ledgerSink, 2);
+
+        // A client who moves more often than the seats a visit stores
+        std::string movingLog = "3\n09:00 19:00\n7\n09:00 1 zed\n";
+        for (size_t move = 0; move < 6; move++)
+            movingLog.append("1" + std::to_string(move) + ":30 2 zed " + std::to_string(move % 3 + 1) + "\n");
+
+        std::vector<std::string> logs = { log };
+        auto folderPath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER)
+                          .append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER);
+        for (const char* fileName : { "AllMistakesAndEventIDs.txt", "FromTestTask.txt", "PerfectWorkingDay.txt" }) {
+            std::ifstream file(fs::path(folderPath).append(fileName));
+            logs.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        logs.push_back(movingLog);
+
+        // The ledger takes the day on one thread and past the cache, so every visit is there anyway
+        auto cachePath = fs::temp_directory_path().append("RecordingClientSessions");
+        fs::remove_all(cachePath);
+        ResultCache resultCache(cachePath, 1 << 20);
+        TaskSolver taskSolver(nullptr, { .numberOfThreads = 4 }, &resultCache, nullptr, &sessionLedger);
+
+        for (const auto& content : logs) {
+            ledgerSink.visits.clear();
+            std::ostringstream report;
+            REQUIRE(taskSolver.runContent(content, report) == static_cast<int>(ErrorType::Success));
+
+            size_t billed = 0;
+            for (const auto& [name, visit] : ledgerSink.visits)
+                billed += visit.billed;
+            REQUIRE(billed == taskSolver.getRevenue());
+        }
+
+        REQUIRE(std::ranges::all_of(ledgerSink.batchSizes, [](size_t size) { return size >= 1 && size <= 2; }));
+
+        // The moving client is still seated at closing
+        const auto& [name, visit] = ledgerSink.visits.front();
+        REQUIRE(ledgerSink.visits.size() == 1);
+        REQUIRE(name == "zed");
+        REQUIRE(visit.numberOfSeats == 6);
+        REQUIRE(visit.seats[3].table == 1);
+        REQUIRE(visit.seats[3].start == 13 * MINUTES_IN_HOUR + 30);
+        REQUIRE(visit.billedHours == 5 + 4);
+        REQUIRE(visit.reason == SessionLedger::DepartureReason::Closing);
+
+        fs::remove_all(cachePath);
+    }
+
+    SECTION("ColumnarRoundTrip") {
+        std::stringstream columnar;
+        std::ostringstream csv;
+        ColumnarLedgerSink columnarSink(columnar);
+        CsvLedgerSink csvSink(csv);
+        SessionLedger columnarLedger(columnarSink, 2), csvLedger(csvSink, 3);
+
+        std::ostream nullStream(nullptr);
+        TaskSolver(nullptr, {}, nullptr, nullptr, &columnarLedger).runContent(log, nullStream);
+        TaskSolver(nullptr, {}, nullptr, nullptr, &csvLedger).runContent(log, nullStream);
+
+        // The batches read back make the same CSV as the visits themselves
+        std::ostringstream readCsv;
+        CsvLedgerSink readCsvSink(readCsv);
+        ColumnarLedgerReader reader(columnar);
+        SessionLedger::Batch batch;
+        size_t numberOfBatches = 0;
+
+        while (reader.Next(batch)) {
+            readCsvSink.Write(batch);
+            numberOfBatches++;
+        }
+        REQUIRE(numberOfBatches == 3);
+        REQUIRE(readCsv.str() == csv.str());
+
+        std::string cutOff = columnar.str();
+        cutOff.pop_back();
+        std::istringstream cutOffStream(cutOff);
+        ColumnarLedgerReader cutOffReader(cutOffStream);
+        REQUIRE(cutOffReader.Next(batch));
+        REQUIRE(cutOffReader.Next(batch));
+        REQUIRE_FALSE(cutOffReader.Next(batch));
+
+        // A damaged number of visits of the first batch claims far more than the stream holds
+        std::string damaged = columnar.str();
+        uint32_t numberOfVisits = 0xFFFFFFFF;
+        std::memcpy(damaged.data() + ColumnarLedgerSink::MAGIC.size(), &numberOfVisits, sizeof(numberOfVisits));
+        std::istringstream damagedStream(damaged);
+        REQUIRE_FALSE(ColumnarLedgerReader(damagedStream).Next(batch));
+
+        std::istringstream textStream(log);
+        REQUIRE_FALSE(ColumnarLedgerReader(textStream).Next(batch));
+    }
+}
+
+TEST_CASE("MatchingTheReference", "[YadroComputerClubTest]") {
+    SECTION("QuirksOfTheReference") {
+        // Served in the opening hour before the opening minute, and sent away by a queue as long as the tables
+        const std::string log = "1\n09:30 19:00\n10\n08:59 1 early\n09:10 1 alice\n09:12 2 alice 1\n"
+                                "09:20 1 bob\n09:21 3 bob\n09:22 1 carol\n09:23 3 carol\n10:00 4 alice\n";
+
+        std::ostringstream expected, report;
+        reference::TaskSolver referenceSolver;
+        REQUIRE(referenceSolver.run(log, expected) == static_cast<int>(ErrorType::Success));
+        REQUIRE(TaskSolver().runContent(log, report) == static_cast<int>(ErrorType::Success));
+
+        REQUIRE(report.str() == expected.str());
+        REQUIRE(expected.str().find("08:59 13 NotOpenYet\n09:10 1 alice\n09:12 2 alice 1\n") != std::string::npos);
+        REQUIRE(expected.str().find("09:23 11 carol\n") != std::string::npos);
+        REQUIRE(referenceSolver.getRevenue() == 100);
+    }
+
+    SECTION("EveryModeOnRandomLogs") {
+        StressOptions options;
+        options.seed = 45;
+        options.numberOfLogs = 2000;
+        options.batchSize = 700;
+        options.workDirectory = fs::temp_directory_path().append("MatchingTheReference").string();
+#ifdef COMPUTERCLUB_BINARY_PATH
+        options.binaryPath = COMPUTERCLUB_BINARY_PATH;
+#endif
+        fs::remove_all(options.workDirectory);
+
+        DifferentialHarness differentialHarness(options);
+        REQUIRE(differentialHarness.Run(std::cout));
+
+        const auto& statistics = differentialHarness.statistics();
+        REQUIRE(statistics.size() == DifferentialHarness::ModeNames().size() + 1);
+        for (const auto& mode : statistics) {
+            INFO(mode.name);
+            REQUIRE(mode.numberOfMismatches == 0);
+            REQUIRE(mode.numberOfLogs > 0);
+        }
+        REQUIRE(statistics.front().numberOfLogs == options.numberOfLogs);
+
+        // Well-formed days, the crash on a day without events and errors of both the header and the events
+        const auto& exitCodes = differentialHarness.referenceExitCodes();
+        for (auto errorType : { ErrorType::Success, ErrorType::UnexpectedError, ErrorType::IncorrectEventTimeSequence })
+            REQUIRE(exitCodes.contains(static_cast<int>(errorType)));
+        REQUIRE(exitCodes.size() >= 10);
+
+        options.modes = { "no-such-mode" };
+        REQUIRE_FALSE(DifferentialHarness(options).Run(std::cout));
+
+        fs::remove_all(options.workDirectory);
+    }
+}
+
+#ifdef COMPUTERCLUB_HAS_CLUB_SERVER
+TEST_CASE("ServingRequestsOverSocket", "[YadroComputerClubTest]") {
+    auto resourcePath = fs::path(CURRENT_SOURCE_FILE_PATH).parent_path().append(RESOURCE_FOLDER);
+    auto socketPath = fs::temp_directory_path().append("ServingRequestsOverSocket.sock").string();
+
+    ClubServer clubServer(socketPath, 2, {});
+    REQUIRE(clubServer.Start());
+
+    // The server answers with exactly what the command line run prints
+    auto check = [&socketPath](const fs::path& filePath) {
+        std::ostringstream expected;
+        TaskSolver taskSolver;
+        int exitCode = taskSolver.run(filePath.string(), expected);
+
+        std::string report;
+        REQUIRE(ClubClient::RunFile(socketPath, filePath.string(), report) == exitCode);
+        REQUIRE(report == expected.str());
+
+        std::ifstream file(filePath);
+        std::stringstream content;
+        content << file.rdbuf();
+        REQUIRE(ClubClient::RunContent(socketPath, content.str(), report) == exitCode);
+        REQUIRE(report == expected.str());
+    };
+
+    SECTION("SuccessOutputResult") {
+        check(fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("FromTestTask.txt"));
+        check(fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("AllMistakesAndEventIDs.txt"));
+    }
+
+    SECTION("ErrorInInputFile") {
+        check(fs::path(resourcePath).append(TEST_SEMANTIC_ERRORS_FOLDER).append("IncorrectEventTimeSequence.txt"));
+    }
+
+    SECTION("IncorrectRequest") {
+        std::string report;
+        REQUIRE(ClubClient::RunFile(socketPath, "", report) == static_cast<int>(ErrorType::IncorrectRequest));
+
+        // Too long content is refused before a byte of it is sent
+        sockaddr_un address{};
+        REQUIRE(makeSocketAddress(socketPath, address));
+        int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+
+        std::string buffer, responseLine;
+        REQUIRE(sendAll(connection, std::string(ClubServer::CONTENT_REQUEST).append(" ")
+                                    .append(std::to_string(ClubServer::MAX_CONTENT_LENGTH + 1)).append("\n")));
+        REQUIRE(receiveLine(connection, buffer, responseLine, ClubServer::MAX_REQUEST_LINE_LENGTH));
+        REQUIRE(responseLine.starts_with(std::to_string(static_cast<int>(ErrorType::IncorrectRequest)) + " "));
+        close(connection);
+    }
+
+    SECTION("PathRoot") {
+        auto rootedSocketPath = fs::temp_directory_path().append("ServingRequestsOverSocketRooted.sock").string();
+        auto rootPath = fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER);
+        ClubServer rootedServer(rootedSocketPath, 1, {}, nullptr, rootPath.string());
+        REQUIRE(rootedServer.Start());
+
+        std::string report;
+        REQUIRE(ClubClient::RunFile(rootedSocketPath, fs::path(rootPath).append("FromTestTask.txt").string(),
+                                    report) == static_cast<int>(ErrorType::Success));
+
+        auto outsidePath = fs::path(rootPath).append("..").append(TEST_SEMANTIC_ERRORS_FOLDER)
+                           .append("IncorrectEventTimeSequence.txt");
+        REQUIRE(ClubClient::RunFile(rootedSocketPath, outsidePath.string(), report) ==
+                static_cast<int>(ErrorType::IncorrectRequest));
+        REQUIRE(report.ends_with("The file is outside of the served directory!\n"));
+
+        rootedServer.Stop();
+    }
+
+    SECTION("IdleClient") {
+        auto idleSocketPath = fs::temp_directory_path().append("ServingRequestsOverSocketIdle.sock").string();
+        ClubServer idleServer(idleSocketPath, 1, {}, nullptr, {}, std::chrono::milliseconds(200));
+        REQUIRE(idleServer.Start());
+
+        // The only worker takes the connection that never sends anything, and the next client is still served
+        sockaddr_un address{};
+        REQUIRE(makeSocketAddress(idleSocketPath, address));
+        int idleConnection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(connect(idleConnection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::string report;
+        auto filePath = fs::path(resourcePath).append(TEST_SUCCESS_OUTPUT_RESULT_FOLDER).append("FromTestTask.txt");
+        REQUIRE(ClubClient::RunFile(idleSocketPath, filePath.string(), report) ==
+                static_cast<int>(ErrorType::Success));
+
+        // The idle connection has been closed unanswered
+        char symbol;
+        REQUIRE(recv(idleConnection, &symbol, 1, 0) == 0);
+        close(idleConnection);
+
+        idleServer.Stop();
+    }
+
+    SECTION("ExistingFile") {
+        // Only a socket left at the path is replaced
+        auto filePath = fs::temp_directory_path().append("ServingRequestsOverSocketFile.txt");
+        std::ofstream(filePath) << "keep";
+
+        ClubServer fileServer(filePath.string(), 1, {});
+        REQUIRE_FALSE(fileServer.Start());
+        REQUIRE(fs::is_regular_file(filePath));
+        fs::remove(filePath);
+
+        // A server that has lost its path to another one leaves the new socket alone
+        ClubServer replacedServer(socketPath, 1, {});
+        REQUIRE(replacedServer.Start());
+        clubServer.Stop();
+        REQUIRE(fs::is_socket(socketPath));
+        replacedServer.Stop();
+    }
+
+    clubServer.Stop();
+    REQUIRE_FALSE(fs::exists(socketPath));
+}
+#endif